@@ -24,7 +24,7 @@ ZCPYMQT_Params mqtParams = {SAMPLE_POOL_ID};
 SMAPOOL_Params SamplePoolParams =
 {
     0, /* Pool ID */
-    TRUE
+    FALSE   /* Small jobs use the buffer classes sized for the largest ones */
 };
 #endif /* if defined MSGQ_ZCPY_LINK */
 
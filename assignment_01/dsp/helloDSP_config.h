@@ -22,6 +22,9 @@
 extern "C" {
 #endif /* defined (__cplusplus) */
 
+/*  ----------------------------------- Standard Headers            */
+#include <stddef.h>
+
 /*  ----------------------------------- DSP/BIOS Headers            */
 #include "helloDSPcfg.h"
 #include <msgq.h>
@@ -42,47 +45,332 @@ extern "C" {
 /* ID of the POOL used by helloDSP. */
 #define SAMPLE_POOL_ID      0
 
+/* IPS and event number used to tell the GPP that the DSP message queue is
+ * open. Must match the definitions in the GPP helloDSP.c. */
+#define READY_IPS_ID        0
+#define READY_EVENT_NO      5
+
+/* Number of attempts for the ready notification, one clock tick apart. */
+#define READY_NOTIFY_RETRIES 100
+
+/* IPS and event number of the link benchmark: every such event the DSP
+ * receives is notified back with the same payload. Must match the
+ * definitions in the GPP helloDSP.c. */
+#define ECHO_IPS_ID         0
+#define ECHO_EVENT_NO       6
+
 /* Argument size passed to the control message queue */
 #define ARG1_SIZE 			256
 #define ARG2_SIZE			128
 
+/* Commands carried in the command field of a control message.
+ * Jobs are driven by the GPP; the DSP replies to the source queue of each
+ * message, so any GPP process that located DSPMSGQ can submit jobs.
+ * Operands travel as one or more row blocks and the product comes back
+ * the same way, so several jobs can be in flight at once.
+ * Must match the definitions in the GPP helloDSP.c. */
+#define CMD_MATRIX_A        0x01    /* GPP->DSP: row block of first operand  */
+#define CMD_MATRIX_B        0x02    /* GPP->DSP: row block of second operand */
+#define CMD_LOAD_A          0x03    /* GPP->DSP: row block of resident A     */
+#define CMD_SHUTDOWN        0x04    /* GPP->DSP: leave the service loop      */
+#define CMD_VECTORS         0x05    /* GPP->DSP: vectors to multiply by A    */
+#define CMD_TUNE            0x06    /* GPP->DSP: kernel tuning table         */
+#define CMD_STATS           0x07    /* GPP->DSP: report the DSP statistics   */
+#define CMD_BENCH           0x08    /* GPP->DSP: run the kernel benchmarks   */
+#define CMD_ECHO            0x09    /* GPP->DSP: send the message back       */
+#define CMD_POOL            0x0A    /* GPP->DSP: describe the message pool   */
+#define CMD_RESULT          0x11    /* DSP->GPP: row block of the product    */
+#define CMD_LOADED          0x12    /* DSP->GPP: resident A stored           */
+#define CMD_TUNED           0x13    /* DSP->GPP: tuning table stored         */
+#define CMD_STATS_REPORT    0x14    /* DSP->GPP: DSP statistics, see DspStats */
+#define CMD_BENCH_REPORT    0x15    /* DSP->GPP: BENCH_ENTRIES BenchEntry    */
+#define CMD_ECHOED          0x16    /* DSP->GPP: the CMD_ECHO message back   */
+#define CMD_ERROR           0x1F    /* DSP->GPP: request rejected            */
+
+/* Matrix-vector products. A dimM x dimK matrix A is loaded once with
+ * CMD_LOAD_A row blocks, 16-bit and dense, and stays on the DSP for the
+ * process that loaded it until it loads another. The DSP acknowledges the
+ * last block with CMD_LOADED. Each CMD_VECTORS message then holds numRows
+ * vectors of dimK elements, the first being vector rowStart of the
+ * stream, and is answered by a CMD_RESULT message holding the numRows
+ * products A * x of dimM 32-bit elements each, modulo 2^32. */
+#define GEMV_MAX_VECTORS    64
+
+/* Kernels computing a job, given with kernelParam in the first operand
+ * block of the job. Must match the definitions in the GPP helloDSP.c. */
+#define KERNEL_BASE         0       /* Tiled triple loop                     */
+#define KERNEL_STRASSEN     1       /* Strassen-Winograd, kernelParam=cutoff */
+#define KERNEL_GEMM         2       /* alpha * op(A) * op(B), see below      */
+
+/* kernelParam of a KERNEL_BASE job is the variant of the kernel, see
+ * MATMULT_VARIANT_* in matMult.h, or 0 for the variant of the tuning
+ * table for the size class of the job. A CMD_TUNE message carries the
+ * table as numRows = TUNE_CLASSES 16-bit variants, 0 for the default
+ * kernel, and is acknowledged with CMD_TUNED. Class c holds the sizes
+ * above 2^(c+1) up to 2^(c+2). */
+#define TUNE_CLASSES        6
+#define TUNE_CLASS(n)                                                         \
+    (((n) <= 4) ? 0 : ((n) <= 8) ? 1 : ((n) <= 16) ? 2                        \
+     : ((n) <= 32) ? 3 : ((n) <= 64) ? 4 : 5)
+
+/* GEMM jobs compute the dimM x dimN product alpha * op(A) * op(B) with an
+ * inner dimension of dimK, where op() transposes the operands flagged in
+ * trans. Operands are sent as stored, op(A) transposed or not, so their
+ * rows are dimK or dimM elements long and so on. They take 16-bit dense
+ * operands and ACCUM_WRAP. Other jobs have dimM = dimN = dimK = matrixSize
+ * and no transpose. */
+#define TRANS_A             0x1
+#define TRANS_B             0x2
+
+/* Accumulation of a job, given in the first operand block of the job.
+ * Checked jobs whose product may not fit in 32 bits are computed with the
+ * base kernel and a wide accumulator, and their result blocks carry 64-bit
+ * elements. Must match the definitions in the GPP helloDSP.c. */
+#define ACCUM_WRAP          0       /* 32-bit product, modulo 2^32           */
+#define ACCUM_CHECKED       1       /* 64-bit product when it may overflow   */
+
+/* Layout of an operand row block, given in its format field. A CSR block
+ * holds numRows + 1 row offsets into the block and nnz column indices, all
+ * 16-bit, followed by the nnz values of elemSize bytes each. A delta block
+ * holds the first element of each row, 16-bit, padded to an even count,
+ * followed by 32-bit words packing the other elements as their difference
+ * to the previous one, modulo 2^16 and zigzag-coded, in nnz bits each from
+ * the least significant bit up. A generated block holds a GenSpec the DSP
+ * computes the rows of the block from. Must match the definitions in the
+ * GPP helloDSP.c. */
+#define FORMAT_DENSE        0
+#define FORMAT_CSR          1
+#define FORMAT_DELTA        2
+#define FORMAT_GENERATED    3
+
+/* Largest width of a delta */
+#define DELTA_MAX_BITS      16
+
+/* Generators of a FORMAT_GENERATED block. Element (j, k) of the operand,
+ * as stored, is modulo 2^16 and then reduced to elemSize bytes:
+ *   GEN_AFFINE     base + rowStep * j + colStep * k
+ *   GEN_CONSTANT   base
+ *   GEN_IDENTITY   base on the diagonal, 0 elsewhere
+ *   GEN_BANDED     the affine value within band of the diagonal, 0 elsewhere
+ *   GEN_RANDOM     the upper 16 bits of the state of the C library LCG,
+ *                  starting from seed and stepped once per element, row-major
+ *                  from the first row of the block
+ * Must match the definitions in the GPP helloDSP.c. */
+#define GEN_AFFINE          0
+#define GEN_CONSTANT        1
+#define GEN_IDENTITY        2
+#define GEN_BANDED          3
+#define GEN_RANDOM          4
+
+typedef struct GenSpec
+{
+    Uint16  kind;                           // Generator, see GEN_*
+    Uint16  band;                           // Half-width of a banded operand
+    Uint16  base;                           // Constant term or diagonal
+    Uint16  rowStep;                        // Increment per row
+    Uint16  colStep;                        // Increment per column
+    Uint16  reserved;
+    Uint32  seed;                           // First state of a random operand
+} GenSpec;
+
+/* The LCG of GEN_RANDOM */
+#define GEN_LCG_NEXT(state) ((state) * 1103515245 + 12345)
+
+/* Statistics of the DSP, the payload of a CMD_STATS_REPORT message. Cycle
+ * counts are 64-bit, low word first, and run from the start of the DSP, so
+ * that any number of processes can each take the difference of two reports
+ * of their own. The message task only gives the processor up while blocked
+ * in MSGQ_get (), so waitCycles of elapsedCycles is its idle time. Storing
+ * operands and resident matrices counts as copying; computing and sending
+ * products as computing. The heap is the DSPLink segment as reported by
+ * MEM_stat (), heapPeak the most used at any report, and the stack that of
+ * the message task as reported by TSK_stat (). poolSize and poolDepth are
+ * the largest job size and the number of such jobs the message pool was
+ * sized for, as given by the process that opened it in the matrixSize and
+ * kernelParam of a CMD_POOL message, 0 until then. CMD_POOL is answered
+ * like CMD_STATS. Must match the definition in the GPP helloDSP.c. */
+typedef struct DspStats
+{
+    Uint32  elapsedCycles[2];               // Since the DSP started
+    Uint32  waitCycles[2];                  // Blocked in MSGQ_get ()
+    Uint32  copyCycles[2];                  // Storing operand blocks
+    Uint32  computeCycles[2];               // Computing and sending products
+    Uint32  messages;                       // Requests handled
+    Uint32  heapSize;                       // Bytes of the heap
+    Uint32  heapUsed;                       // Bytes in use
+    Uint32  heapPeak;                       // Most bytes in use at a report
+    Uint32  heapLargestFree;                // Largest free block
+    Uint32  stackSize;                      // Bytes of the task stack
+    Uint32  stackUsed;                      // Most stack bytes ever used
+    Uint16  poolSize;                       // Largest job size of the pool
+    Uint16  poolDepth;                      // Jobs of poolSize it holds
+} DspStats;
+
+/* Kernel microbenchmarks. A CMD_BENCH message has the DSP time the whole
+ * product of each kernel of MATMULT_bench () for BENCH_SIZES sizes, from
+ * 16 to MAXSIZE, once cold, with the caches written back and invalidated
+ * so that the operands come from DDR2, and once warm, right after. The
+ * kernels address the operands where the memory profile placed them, so
+ * warm runs show them as cached in L1D and L2. The DSP serves no job
+ * meanwhile. The table comes back in a single CMD_BENCH_REPORT message of
+ * numRows = BENCH_ENTRIES entries, sizes outermost, then kernels, cold run
+ * first. Must match the definitions in the GPP helloDSP.c. */
+#define BENCH_SIZES         7
+#define BENCH_SIZE(i)       ((((i) & 1) ? 24 : 16) << ((i) >> 1))
+#define BENCH_KERNELS       5
+#define BENCH_ENTRIES       (BENCH_SIZES * BENCH_KERNELS * 2)
+
+typedef struct BenchEntry
+{
+    Uint16  kernel;                         // See MATMULT_BENCH_*
+    Uint16  matrixSize;                     // Size of the operands
+    Uint16  warm;                           // 0 for the cold run
+    Uint16  reserved;
+    Uint32  cycles[2];                      // Of the whole product, low word first
+} BenchEntry;
+
+/* Link benchmark. A CMD_ECHO message goes back to its sender as
+ * CMD_ECHOED, in the same buffer, as soon as it is received. Its payload
+ * is all of the message after the header. With ECHO_TOUCH in kernelParam,
+ * the DSP complements each 32-bit word of the payload and writes the
+ * message back from its cache. It returns the cycles of each step in arg1
+ * and cacheCycles, and the bytes written back in cacheBytes. Without it,
+ * the payload is left alone, so only the transport handles the buffer.
+ * Must match the definitions in the GPP helloDSP.c. */
+#define ECHO_TOUCH          0x1
+
 /* Control message data structure. */
 /* Must contain a reserved space for the header */
+/* arg2 holds numRows rows of matrixSize elements of elemSize bytes each,
+ * row-major. Operands have 8- or 16-bit elements, the same for all blocks
+ * of a job. 64-bit elements are two words, low word first. Messages
+ * are allocated with the size actually needed, see CTRLMSG_SIZE: the
+ * zero-copy transport writes back and invalidates the allocated size of a
+ * message, so that is all the cache maintenance a message costs. */
 typedef struct ControlMsgS
 {
     MSGQ_MsgHeader header;
     Uint16  command;
-    int     arg1;                           // Cycles timer from DSP
-    Uint16  arg2[ARG2_SIZE][ARG2_SIZE];     // 128x128, 16-bit-element matrix
+    Uint16  matrixSize;                     // Size of the operands
+    Uint16  jobId;                          // Job the message belongs to
+    Uint16  rowStart;                       // First matrix row in arg2
+    Uint16  numRows;                        // Number of matrix rows in arg2
+    Uint16  dspConfig;                      // DSP build, see DSPCONFIG
+    Uint16  kernel;                         // Kernel computing the job
+    Uint16  kernelParam;                    // Parameter of the kernel
+    Uint16  accum;                          // Accumulation, see ACCUM_*
+    Uint16  elemSize;                       // Bytes per element of arg2
+    Uint16  format;                         // Layout of arg2, see FORMAT_*
+    Uint16  nnz;                            // Non-zeros in a CSR block, bits per delta
+    Uint16  dimM;                           // Rows of the product
+    Uint16  dimN;                           // Columns of the product
+    Uint16  dimK;                           // Inner dimension
+    Uint16  trans;                          // Transposed operands, see TRANS_*
+    Uint32  alpha;                          // Scale of the product
+    Uint32  arg1;                           // Cycles timer from DSP
+    Uint32  cacheCycles;                    // DSP cycles in cache maintenance
+    Uint32  cacheBytes;                     // Bytes of shared buffers maintained
+    Uint16  arg2[1];                        // 8- or 16-bit-element row block
 } ControlMsgS;
 
 typedef struct ControlMsgL
 {
     MSGQ_MsgHeader header;
     Uint16  command;
-    int     arg1;                           // Cycles timer from DSP
-    Uint32  arg2[ARG2_SIZE/2][ARG2_SIZE];   // 64x128, 32-bit-element matrix
+    Uint16  matrixSize;                     // Size of the operands
+    Uint16  jobId;                          // Job the message belongs to
+    Uint16  rowStart;                       // First matrix row in arg2
+    Uint16  numRows;                        // Number of matrix rows in arg2
+    Uint16  dspConfig;                      // DSP build, see DSPCONFIG
+    Uint16  kernel;                         // Kernel computing the job
+    Uint16  kernelParam;                    // Parameter of the kernel
+    Uint16  accum;                          // Accumulation, see ACCUM_*
+    Uint16  elemSize;                       // Bytes per element of arg2
+    Uint16  format;                         // Layout of arg2, see FORMAT_*
+    Uint16  nnz;                            // Non-zeros in a CSR block, bits per delta
+    Uint16  dimM;                           // Rows of the product
+    Uint16  dimN;                           // Columns of the product
+    Uint16  dimK;                           // Inner dimension
+    Uint16  trans;                          // Transposed operands, see TRANS_*
+    Uint32  alpha;                          // Scale of the product
+    Uint32  arg1;                           // Cycles timer from DSP
+    Uint32  cacheCycles;                    // DSP cycles in cache maintenance
+    Uint32  cacheBytes;                     // Bytes of shared buffers maintained
+    Uint32  arg2[1];                        // 32- or 64-bit-element row block
 } ControlMsgL;
 
-/* Messaging buffer used by the application.
- * Note: This buffer must be aligned according to the alignment expected
+/* Bytes in front of the payload. Same for both message views. */
+#define CTRLMSG_HDR_SIZE    offsetof(ControlMsgS, arg2)
+
+/* Largest aligned message size that fits the 16-bit size of MSGQ_alloc. */
+#define CTRLMSG_MAX_SIZE    0xFF80
+
+/* Smallest application message. Keeps application messages out of the
+ * buffer classes the transport uses for its own control messages. */
+#define CTRLMSG_MIN_SIZE    (2 * DSPLINK_BUF_ALIGN)
+
+/* Size of a message carrying the given number of payload bytes.
+ * Note: Messages must be aligned according to the alignment expected
  * by the device/platform. */
-#define APP_BUFFER_SIZE DSPLINK_ALIGN (sizeof (ControlMsgS), DSPLINK_BUF_ALIGN)
+#define CTRLMSG_SIZE(bytes)                                                   \
+    ((DSPLINK_ALIGN(CTRLMSG_HDR_SIZE + (bytes), DSPLINK_BUF_ALIGN) < CTRLMSG_MIN_SIZE) \
+        ? CTRLMSG_MIN_SIZE                                                    \
+        : DSPLINK_ALIGN(CTRLMSG_HDR_SIZE + (bytes), DSPLINK_BUF_ALIGN))
+
+/* Number of row blocks needed for a matrix of the given number of rows of
+ * width elements of the given size, and rows per block when the rows are
+ * split evenly. CTRLMSG_BLOCKS and CTRLMSG_BLOCK_ROWS are the same for a
+ * square matrix of size n. */
+#define CTRLMSG_ROW_CAPACITY(width, elemSize)                                 \
+    ((CTRLMSG_MAX_SIZE - CTRLMSG_HDR_SIZE) / ((width) * (elemSize)))
+#define CTRLMSG_ROW_BLOCKS(rows, width, elemSize)                             \
+    (((rows) + CTRLMSG_ROW_CAPACITY(width, elemSize) - 1)                     \
+        / CTRLMSG_ROW_CAPACITY(width, elemSize))
+#define CTRLMSG_ROW_BLOCK_ROWS(rows, width, elemSize)                         \
+    (((rows) + CTRLMSG_ROW_BLOCKS(rows, width, elemSize) - 1)                 \
+        / CTRLMSG_ROW_BLOCKS(rows, width, elemSize))
+#define CTRLMSG_BLOCKS(n, elemSize)         CTRLMSG_ROW_BLOCKS(n, n, elemSize)
+#define CTRLMSG_BLOCK_ROWS(n, elemSize)     CTRLMSG_ROW_BLOCK_ROWS(n, n, elemSize)
+
+/* Payload bytes of a CSR block. */
+#define CTRLMSG_CSR_BYTES(rows, nnz, elemSize)                                \
+    (((rows) + 1 + (nnz)) * sizeof(Uint16) + (nnz) * (elemSize))
+
+/* 16-bit slots taken by the row heads of a delta block, and its payload
+ * bytes. */
+#define CTRLMSG_DELTA_HEADS(rows)           (((rows) + 1) & ~1)
+#define CTRLMSG_DELTA_BYTES(rows, width, bits)                                \
+    (CTRLMSG_DELTA_HEADS(rows) * sizeof(Uint16)                               \
+     + (((rows) * ((width) - 1) * (bits) + 31) / 32) * sizeof(Uint32))
+
+/* Memory profiles of the DSP image, selected with MEMPROFILE in the DSP
+ * makefile, and their encoding together with the L2 cache size (L2CACHE)
+ * in the dspConfig field of result messages. */
+#define MEMPROFILE_DDR      0       /* Everything in DDR2                    */
+#define MEMPROFILE_SRAM     1       /* Kernel in IRAM, stack/tile in L1DSRAM */
+
+#if !defined (MEMPROFILE)
+#define MEMPROFILE          MEMPROFILE_DDR
+#endif
+#if !defined (L2CACHE_KB)
+#define L2CACHE_KB          32
+#endif
+
+#define DSPCONFIG(profile, l2CacheKb)   (((profile) << 8) | ((l2CacheKb) & 0xFF))
+#define DSPCONFIG_PROFILE(config)       ((config) >> 8)
+#define DSPCONFIG_L2CACHE(config)       ((config) & 0xFF)
 
 /* Number of pools configured in the system. */
 #define NUM_POOLS          1
 
-/* Number of local message queues */
-#define NUM_MSG_QUEUES     1
-
-/* Number of BUF pools in the entire memory pool */
-#define NUM_MSG_POOLS      4
+/* Number of local message queues: the DSP queue and the one holding the
+ * requests deferred while a job is in progress. */
+#define NUM_MSG_QUEUES     2
 
-/* Number of messages in each BUF pool. */
-#define NUM_MSG_IN_POOL0   1
-#define NUM_MSG_IN_POOL1   2
-#define NUM_MSG_IN_POOL2   2
-#define NUM_MSG_IN_POOL3   4
+/* The buffer classes and counts of the pool are chosen by the GPP in
+ * helloDSP_Create () from the matrix size, pipeline depth and batch size.
+ * The DSP allocates result messages with CTRLMSG_SIZE and gets the
+ * smallest buffer that fits. */
 
 
 #if defined (__cplusplus)
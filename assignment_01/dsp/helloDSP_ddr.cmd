@@ -0,0 +1,20 @@
+/** ============================================================================
+ *  @file   helloDSP_ddr.cmd
+ *
+ *  @path   
+ *
+ *  @desc   Linker command file for the ddr memory profile of the helloDSP
+ *          example: the matrix multiplication kernel and its data stay in
+ *          DDR2 with the rest of the image.
+ *
+ *  @ver    1.10
+ *  ============================================================================
+ */
+
+SECTIONS {
+    .text:matMult       > DDR2
+    .far:matMultData    > DDR2
+    .far:matMultArena   > DDR2
+    .far:matMultTile    > DDR2
+    .far:matMultResident > DDR2
+}
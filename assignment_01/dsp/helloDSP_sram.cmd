@@ -0,0 +1,25 @@
+/** ============================================================================
+ *  @file   helloDSP_sram.cmd
+ *
+ *  @path   
+ *
+ *  @desc   Linker command file for the sram memory profile of the helloDSP
+ *          example: the matrix multiplication kernel runs from IRAM and
+ *          stages its tile in L1DSRAM, next to the task stacks (see
+ *          helloDSP.tcf). The operands and the Strassen-Winograd arena
+ *          stay in DDR2, behind the L2 cache, as they do not fit in IRAM
+ *          with the kernel. The resident matrix of the matrix-vector
+ *          product goes to IRAM when it fits next to the kernel, which
+ *          depends on L2CACHE, and to DDR2 otherwise.
+ *
+ *  @ver    1.10
+ *  ============================================================================
+ */
+
+SECTIONS {
+    .text:matMult       > IRAM
+    .far:matMultData    > DDR2
+    .far:matMultArena   > DDR2
+    .far:matMultTile    > L1DSRAM
+    .far:matMultResident > IRAM | DDR2
+}
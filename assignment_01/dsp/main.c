@@ -10,6 +10,7 @@
 #include <failure.h>
 
 /*  ----------------------------------- Sample Headers              */
+#include <helloDSP_config.h>
 #include <tskMessage.h>
 
 /*  ----------------------------------- BSL Headers                 */
@@ -22,9 +23,6 @@ extern "C" {
 /* FILEID is used by SET_FAILURE_REASON macro. */
 #define FILEID  FID_APP_C
 
-/* Matrix size. */
-Uint16 matrixSize;
-
 /** ----------------------------------------------------------------------------
  *  @func   tskMessage
  *
@@ -32,15 +30,6 @@ Uint16 matrixSize;
  */
 static Int tskMessage();
 
-/** ============================================================================
- *  @func   atoi
- *
- *  @desc   Converts character string to integer value.
- *
- *  ============================================================================
- */
-extern int atoi(const char* str);
-
 /** ============================================================================
  *  @func   main
  *
@@ -55,8 +44,8 @@ Void main(Int argc, Char* argv [])
     TSK_Handle tskMessageTask;
 
 #if !defined (DSP_BOOTMODE_NOBOOT)
-    /* Get the matrix size */
-    matrixSize = atoi(argv [0]);
+    /* The matrix size is carried by each job message, so no arguments are
+     * expected from the GPP. */
     /* Initialize DSP/BIOS LINK. */
     DSPLINK_init();
 #endif
@@ -0,0 +1,1174 @@
+/** ============================================================================
+ *  @file   matMult.c
+ *
+ *  @path   
+ *
+ *  @desc   Matrix multiplication kernel of the helloDSP sample.
+ *
+ *          The kernel and its data live in sections of their own, so the
+ *          memory profile chosen in the makefile can place them without
+ *          touching the rest of the image:
+ *              .text:matMult        kernel code
+ *              .far:matMultData     operands, 16-bit, packed 8-bit and sparse
+ *              .far:matMultTile     staged columns of the second operand, row
+ *                                   sums of the first
+ *              .far:matMultArena    Strassen-Winograd operands and temporaries
+ *              .far:matMultResident matrix multiplied by vectors
+ *
+ *  @ver    1.10
+ *  ============================================================================
+ */
+
+
+/*  ----------------------------------- DSP/BIOS Headers            */
+#include <std.h>
+
+/*  ----------------------------------- Sample Headers              */
+#include <matMult.h>
+
+/*  ----------------------------------- Timer Headers               */
+#include "c6x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Matrices to store results from GPP */
+#pragma DATA_SECTION(mat1, ".far:matMultData")
+#pragma DATA_SECTION(mat2, ".far:matMultData")
+Uint16 mat1[MAXSIZE][MAXSIZE];
+Uint16 mat2[MAXSIZE][MAXSIZE];
+
+#pragma DATA_SECTION(mat1Packed, ".far:matMultData")
+#pragma DATA_SECTION(mat2Packed, ".far:matMultData")
+#pragma DATA_ALIGN(mat1Packed, 8)
+Uint8 mat1Packed[MAXSIZE][MAXSIZE];
+Uint8 mat2Packed[MAXSIZE][MAXSIZE];
+
+#pragma DATA_SECTION(matSparseRowPtr, ".far:matMultData")
+#pragma DATA_SECTION(matSparseCol, ".far:matMultData")
+#pragma DATA_SECTION(matSparseVal, ".far:matMultData")
+Uint16 matSparseRowPtr[MAXSIZE + 1];
+Uint16 matSparseCol[MAXSIZE * MAXSIZE];
+Uint16 matSparseVal[MAXSIZE * MAXSIZE];
+
+/* Matrix kept across requests and multiplied by streams of vectors */
+#pragma DATA_SECTION(matResident, ".far:matMultResident")
+#pragma DATA_ALIGN(matResident, 8)
+Uint16 matResident[MAXSIZE][MAXSIZE];
+
+/* Columns of mat2 being multiplied, transposed so that the inner product
+ * walks both operands contiguously. MATMULT_multiplyPacked stages its
+ * 8-bit columns in the same buffer, MATMULT_gemv its vectors and the
+ * leaves of MATMULT_winograd half as many 32-bit columns. */
+#pragma DATA_SECTION(matMultTile, ".far:matMultTile")
+#pragma DATA_ALIGN(matMultTile, 8)
+static Uint16 matMultTile[MATMULT_TILE_COLS][MAXSIZE];
+
+/* Sums of the rows of mat1, bounding the product with the largest element
+ * of mat2. Set by MATMULT_checkRange (). */
+#pragma DATA_SECTION(matMultRowSum, ".far:matMultTile")
+static Uint32 matMultRowSum[MAXSIZE];
+
+/* Preallocated scratch space of the Strassen-Winograd multiply, carved
+ * once per job instead of allocated per level. */
+#pragma DATA_SECTION(matMultArena, ".far:matMultArena")
+#pragma DATA_ALIGN(matMultArena, 8)
+static Uint32 matMultArena[MATMULT_ARENA_WORDS];
+
+/* Four-way 8-bit dot product of two words of packed bytes, and the aligned
+ * word load feeding it. Both are single instructions on the C64x+; the
+ * portable versions compute the same sums. */
+#if defined (_TMS320C6400) || defined (_TMS320C6400_PLUS)
+#define MATMULT_LOAD4(ptr)      _amem4_const(ptr)
+#define MATMULT_DOTPU4(a, b)    _dotpu4((a), (b))
+#else
+#define MATMULT_LOAD4(ptr)                                                    \
+    ((Uint32) (ptr)[0] | ((Uint32) (ptr)[1] << 8)                             \
+     | ((Uint32) (ptr)[2] << 16) | ((Uint32) (ptr)[3] << 24))
+#define MATMULT_DOTPU4(a, b)                                                  \
+    (((a) & 0xFF) * ((b) & 0xFF) + (((a) >> 8) & 0xFF) * (((b) >> 8) & 0xFF)  \
+     + (((a) >> 16) & 0xFF) * (((b) >> 16) & 0xFF) + ((a) >> 24) * ((b) >> 24))
+#endif
+
+/* Product of the job in progress in the arena, and its row stride. */
+static Uint32* matMultProduct;
+static Uint16  matMultProductDim;
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   MATMULT_winograd
+ *
+ *  @desc   C = A * B for m x m matrices with the given row strides.
+ *  ----------------------------------------------------------------------------
+ */
+static Void MATMULT_winograd(Uint32* C, Uint16 ldc, const Uint32* A, Uint16 lda,
+                             const Uint32* B, Uint16 ldb, Uint16 m,
+                             Uint16 cutoff, Uint32* scratch);
+
+/** ----------------------------------------------------------------------------
+ *  @func   MATMULT_add
+ *
+ *  @desc   D = P + Q for m x m matrices with the given row strides.
+ *  ----------------------------------------------------------------------------
+ */
+static Void MATMULT_add(Uint32* D, Uint16 ldd, const Uint32* P, Uint16 ldp,
+                        const Uint32* Q, Uint16 ldq, Uint16 m);
+
+/** ----------------------------------------------------------------------------
+ *  @func   MATMULT_sub
+ *
+ *  @desc   D = P - Q for m x m matrices with the given row strides.
+ *  ----------------------------------------------------------------------------
+ */
+static Void MATMULT_sub(Uint32* D, Uint16 ldd, const Uint32* P, Uint16 ldp,
+                        const Uint32* Q, Uint16 ldq, Uint16 m);
+
+
+/* Pragma with macro-expanded arguments, for the kernels generated below. */
+#define MATMULT_PRAGMA(x)       _Pragma(#x)
+
+/* Columns per tile of a kernel specialised for size n. */
+#define MATMULT_FIXED_TILE(n)   ((n) < MATMULT_TILE_COLS ? (n) : MATMULT_TILE_COLS)
+
+/* MATMULT_multiply for size n known at compile time, n a multiple of 4.
+ * Every trip count is a constant, so the inner product is software
+ * pipelined with no prologue for a remainder, and each load of a row
+ * element of mat1 feeds four columns of the tile. */
+#define MATMULT_FIXED(n)                                                      \
+MATMULT_PRAGMA(CODE_SECTION(MATMULT_multiply##n, ".text:matMult"))            \
+static Uint32 MATMULT_multiply##n(Uint32* result, Uint16 rowStart,            \
+                                  Uint16 rowEnd)                              \
+{                                                                             \
+    const Uint16* row;                                                        \
+    Uint32* out;                                                              \
+    Uint32 start, stop;                                                       \
+    Uint32 a, sum0, sum1, sum2, sum3;                                         \
+    Uint16 j, k, l;                                                           \
+    Uint16 tileStart;                                                         \
+                                                                              \
+    start = TSCL;                                                             \
+    for (tileStart = 0; tileStart < (n); tileStart += MATMULT_FIXED_TILE(n))  \
+    {                                                                         \
+        /* Stage the tile */                                                  \
+        for (l = 0; l < (n); l++)                                             \
+        {                                                                     \
+            MATMULT_PRAGMA(MUST_ITERATE(MATMULT_FIXED_TILE(n),                \
+                                        MATMULT_FIXED_TILE(n), 4))            \
+            for (k = 0; k < MATMULT_FIXED_TILE(n); k++)                       \
+                matMultTile[k][l] = mat2[l][tileStart + k];                   \
+        }                                                                     \
+                                                                              \
+        for (j = rowStart; j < rowEnd; j++)                                   \
+        {                                                                     \
+            row = mat1[j];                                                    \
+            out = &result[(j - rowStart) * (n) + tileStart];                  \
+            for (k = 0; k < MATMULT_FIXED_TILE(n); k += 4)                    \
+            {                                                                 \
+                sum0 = 0;                                                     \
+                sum1 = 0;                                                     \
+                sum2 = 0;                                                     \
+                sum3 = 0;                                                     \
+                MATMULT_PRAGMA(MUST_ITERATE(n, n, 4))                         \
+                for (l = 0; l < (n); l++)                                     \
+                {                                                             \
+                    a = row[l];                                               \
+                    sum0 += a * matMultTile[k][l];                            \
+                    sum1 += a * matMultTile[k + 1][l];                        \
+                    sum2 += a * matMultTile[k + 2][l];                        \
+                    sum3 += a * matMultTile[k + 3][l];                        \
+                }                                                             \
+                out[k] = sum0;                                                \
+                out[k + 1] = sum1;                                            \
+                out[k + 2] = sum2;                                            \
+                out[k + 3] = sum3;                                            \
+            }                                                                 \
+        }                                                                     \
+    }                                                                         \
+    stop = TSCL;                                                              \
+                                                                              \
+    return stop - start;                                                      \
+}
+
+MATMULT_FIXED(4)
+MATMULT_FIXED(8)
+MATMULT_FIXED(16)
+MATMULT_FIXED(32)
+MATMULT_FIXED(64)
+MATMULT_FIXED(128)
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiply
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2, a tile of
+ *          MATMULT_TILE_COLS columns at a time. Sizes with a kernel
+ *          generated by MATMULT_FIXED go to that kernel.
+ *
+ *  @modif  None.
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_multiply, ".text:matMult")
+Uint32 MATMULT_multiply(Uint32* result, Uint16 matrixSize,
+                        Uint16 rowStart, Uint16 rowEnd)
+{
+    Uint32 start, stop;
+    Uint32 sum;
+    Uint16 j, k, l;
+    Uint16 tileStart, tileCols;
+
+    switch (matrixSize)
+    {
+        case 4:
+            return MATMULT_multiply4(result, rowStart, rowEnd);
+
+        case 8:
+            return MATMULT_multiply8(result, rowStart, rowEnd);
+
+        case 16:
+            return MATMULT_multiply16(result, rowStart, rowEnd);
+
+        case 32:
+            return MATMULT_multiply32(result, rowStart, rowEnd);
+
+        case 64:
+            return MATMULT_multiply64(result, rowStart, rowEnd);
+
+        case 128:
+            return MATMULT_multiply128(result, rowStart, rowEnd);
+
+        default:
+            break;
+    }
+
+    start = TSCL;
+    for (tileStart = 0; tileStart < matrixSize; tileStart += MATMULT_TILE_COLS)
+    {
+        tileCols = (matrixSize - tileStart < MATMULT_TILE_COLS)
+                   ? (matrixSize - tileStart) : MATMULT_TILE_COLS;
+
+        /* Stage the tile */
+        for (l = 0; l < matrixSize; l++)
+            for (k = 0; k < tileCols; k++)
+                matMultTile[k][l] = mat2[l][tileStart + k];
+
+        for (j = rowStart; j < rowEnd; j++)
+            for (k = 0; k < tileCols; k++)
+            {
+                sum = 0;
+                #pragma MUST_ITERATE(1, MAXSIZE)
+                for(l = 0; l < matrixSize; l++)
+                    sum += ((Uint32)mat1[j][l]) * ((Uint32)matMultTile[k][l]);
+                result[(j - rowStart) * matrixSize + tileStart + k] = sum;
+            }
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyVariant
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 with the base
+ *          kernel shaped by variant. Columns of the tile are either dot
+ *          products with the rows of mat1, one or four at a time, or
+ *          accumulated all at once from the rows of the tile. The tile is
+ *          staged in matMultTile or read in place from mat2.
+ *
+ *  @modif  None.
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_multiplyVariant, ".text:matMult")
+Uint32 MATMULT_multiplyVariant(Uint32* result, Uint16 matrixSize,
+                               Uint16 rowStart, Uint16 rowEnd, Uint16 variant)
+{
+    const Uint16* row;
+    const Uint16* base;
+    const Uint16* col0;
+    const Uint16* col1;
+    const Uint16* col2;
+    const Uint16* col3;
+    Uint32* out;
+    Uint32 start, stop;
+    Uint32 a, sum0, sum1, sum2, sum3;
+    Uint32 acc[MATMULT_TILE_COLS];
+    Bool staged = (variant & MATMULT_VARIANT_DIRECT) == 0;
+    Uint16 tile = variant & MATMULT_VARIANT_TILE;
+    Uint16 colStep, elemStep;
+    Uint16 j, k, l;
+    Uint16 tileStart, tileCols;
+
+    if ((variant == 0) || (variant & MATMULT_VARIANT_FIXED))
+        return MATMULT_multiply(result, matrixSize, rowStart, rowEnd);
+
+    start = TSCL;
+    for (tileStart = 0; tileStart < matrixSize; tileStart += tile)
+    {
+        tileCols = (matrixSize - tileStart < tile) ? (matrixSize - tileStart) : tile;
+
+        if (variant & MATMULT_VARIANT_AXPY)
+        {
+            /* Stage the tile row-major, tileCols elements per row */
+            if (staged)
+                for (l = 0; l < matrixSize; l++)
+                    for (k = 0; k < tileCols; k++)
+                        matMultTile[0][l * tileCols + k] = mat2[l][tileStart + k];
+
+            for (j = rowStart; j < rowEnd; j++)
+            {
+                for (k = 0; k < tileCols; k++)
+                    acc[k] = 0;
+                for (l = 0; l < matrixSize; l++)
+                {
+                    a = mat1[j][l];
+                    base = staged ? &matMultTile[0][l * tileCols] : &mat2[l][tileStart];
+                    #pragma MUST_ITERATE(1, MATMULT_TILE_COLS)
+                    for (k = 0; k < tileCols; k++)
+                        acc[k] += a * base[k];
+                }
+                out = &result[(j - rowStart) * matrixSize + tileStart];
+                for (k = 0; k < tileCols; k++)
+                    out[k] = acc[k];
+            }
+        }
+        else
+        {
+            /* Column k of the tile starts at base + k * colStep, and its
+             * elements are elemStep apart. */
+            if (staged)
+            {
+                for (l = 0; l < matrixSize; l++)
+                    for (k = 0; k < tileCols; k++)
+                        matMultTile[k][l] = mat2[l][tileStart + k];
+                base = &matMultTile[0][0];
+                colStep = MAXSIZE;
+                elemStep = 1;
+            }
+            else
+            {
+                base = &mat2[0][tileStart];
+                colStep = 1;
+                elemStep = MAXSIZE;
+            }
+
+            for (j = rowStart; j < rowEnd; j++)
+            {
+                row = mat1[j];
+                out = &result[(j - rowStart) * matrixSize + tileStart];
+                k = 0;
+                if (variant & MATMULT_VARIANT_UNROLL4)
+                {
+                    for ( ; k + 4 <= tileCols; k += 4)
+                    {
+                        col0 = base + k * colStep;
+                        col1 = col0 + colStep;
+                        col2 = col1 + colStep;
+                        col3 = col2 + colStep;
+                        sum0 = 0;
+                        sum1 = 0;
+                        sum2 = 0;
+                        sum3 = 0;
+                        #pragma MUST_ITERATE(1, MAXSIZE)
+                        for (l = 0; l < matrixSize; l++)
+                        {
+                            a = row[l];
+                            sum0 += a * col0[l * elemStep];
+                            sum1 += a * col1[l * elemStep];
+                            sum2 += a * col2[l * elemStep];
+                            sum3 += a * col3[l * elemStep];
+                        }
+                        out[k] = sum0;
+                        out[k + 1] = sum1;
+                        out[k + 2] = sum2;
+                        out[k + 3] = sum3;
+                    }
+                }
+                for ( ; k < tileCols; k++)
+                {
+                    col0 = base + k * colStep;
+                    sum0 = 0;
+                    #pragma MUST_ITERATE(1, MAXSIZE)
+                    for (l = 0; l < matrixSize; l++)
+                        sum0 += ((Uint32) row[l]) * col0[l * elemStep];
+                    out[k] = sum0;
+                }
+            }
+        }
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyNaive
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 one element at
+ *          a time, striding down the columns of mat2.
+ *
+ *  @modif  None.
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_multiplyNaive, ".text:matMult")
+Uint32 MATMULT_multiplyNaive(Uint32* result, Uint16 matrixSize,
+                             Uint16 rowStart, Uint16 rowEnd)
+{
+    Uint32 start, stop;
+    Uint32 sum;
+    Uint16 j, k, l;
+
+    start = TSCL;
+    for (j = rowStart; j < rowEnd; j++)
+        for (k = 0; k < matrixSize; k++)
+        {
+            sum = 0;
+            for (l = 0; l < matrixSize; l++)
+                sum += ((Uint32)mat1[j][l]) * ((Uint32)mat2[l][k]);
+            result[(j - rowStart) * matrixSize + k] = sum;
+        }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyPacked
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1Packed * mat2Packed, a
+ *          tile of MATMULT_TILE_COLS columns at a time like
+ *          MATMULT_multiply, but with a word of four 8-bit elements per
+ *          step of the inner product. Rows of the first operand are
+ *          zero-padded to a whole number of words, so whatever follows a
+ *          staged column does not contribute.
+ *
+ *  @modif  mat1Packed
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_multiplyPacked, ".text:matMult")
+Uint32 MATMULT_multiplyPacked(Uint32* result, Uint16 matrixSize,
+                              Uint16 rowStart, Uint16 rowEnd)
+{
+    Uint8 (*tile)[MAXSIZE] = (Uint8 (*)[MAXSIZE]) matMultTile;
+    Uint16 words = (matrixSize + 3) / 4;
+    Uint32 start, stop;
+    Uint32 sum;
+    const Uint8* row;
+    const Uint8* col;
+    Uint16 j, k, l;
+    Uint16 tileStart, tileCols;
+
+    start = TSCL;
+    for (j = rowStart; j < rowEnd; j++)
+        for (l = matrixSize; l < 4 * words; l++)
+            mat1Packed[j][l] = 0;
+
+    for (tileStart = 0; tileStart < matrixSize; tileStart += MATMULT_TILE_COLS)
+    {
+        tileCols = (matrixSize - tileStart < MATMULT_TILE_COLS)
+                   ? (matrixSize - tileStart) : MATMULT_TILE_COLS;
+
+        /* Stage the tile */
+        for (l = 0; l < matrixSize; l++)
+            for (k = 0; k < tileCols; k++)
+                tile[k][l] = mat2Packed[l][tileStart + k];
+
+        for (j = rowStart; j < rowEnd; j++)
+            for (k = 0; k < tileCols; k++)
+            {
+                row = mat1Packed[j];
+                col = tile[k];
+                sum = 0;
+                #pragma MUST_ITERATE(1, MAXSIZE / 4)
+                for (l = 0; l < words; l++)
+                    sum += MATMULT_DOTPU4(MATMULT_LOAD4(&row[4 * l]), MATMULT_LOAD4(&col[4 * l]));
+                result[(j - rowStart) * matrixSize + tileStart + k] = sum;
+            }
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplySparse
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of the sparse first operand
+ *          times mat2. Each non-zero of a row adds a scaled row of mat2 to
+ *          the row of the product, so both operands and the product are
+ *          walked contiguously and zeros cost nothing.
+ *
+ *  @modif  None.
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_multiplySparse, ".text:matMult")
+Uint32 MATMULT_multiplySparse(Uint32* result, Uint16 matrixSize,
+                              Uint16 rowStart, Uint16 rowEnd)
+{
+    Uint32 start, stop;
+    Uint32 value;
+    Uint32* out;
+    const Uint16* row;
+    Uint16 j, k, p;
+
+    start = TSCL;
+    for (j = rowStart; j < rowEnd; j++)
+    {
+        out = result + (j - rowStart) * matrixSize;
+        for (k = 0; k < matrixSize; k++)
+            out[k] = 0;
+
+        for (p = matSparseRowPtr[j]; p < matSparseRowPtr[j + 1]; p++)
+        {
+            value = matSparseVal[p];
+            row = mat2[matSparseCol[p]];
+            #pragma MUST_ITERATE(1, MAXSIZE)
+            for (k = 0; k < matrixSize; k++)
+                out[k] += value * row[k];
+        }
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_expandSparse
+ *
+ *  @desc   Stores the sparse first operand densely in mat1.
+ *
+ *  @modif  mat1
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_expandSparse, ".text:matMult")
+Uint32 MATMULT_expandSparse(Uint16 matrixSize)
+{
+    Uint32 start, stop;
+    Uint16 j, k, p;
+
+    start = TSCL;
+    for (j = 0; j < matrixSize; j++)
+    {
+        for (k = 0; k < matrixSize; k++)
+            mat1[j][k] = 0;
+        for (p = matSparseRowPtr[j]; p < matSparseRowPtr[j + 1]; p++)
+            mat1[j][matSparseCol[p]] = matSparseVal[p];
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_checkRangeSparse
+ *
+ *  @desc   MATMULT_checkRange with the row sums taken over the non-zeros
+ *          of the sparse first operand.
+ *
+ *  @modif  matMultRowSum
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_checkRangeSparse, ".text:matMult")
+Uint32 MATMULT_checkRangeSparse(Uint16 matrixSize, Bool* narrow)
+{
+    Uint32 start, stop;
+    Uint32 sum, maxSum;
+    Uint16 maxElem;
+    Uint16 j, k, p;
+
+    start = TSCL;
+    maxSum = 0;
+    maxElem = 0;
+    for (j = 0; j < matrixSize; j++)
+    {
+        sum = 0;
+        for (p = matSparseRowPtr[j]; p < matSparseRowPtr[j + 1]; p++)
+            sum += matSparseVal[p];
+        matMultRowSum[j] = sum;
+        if (sum > maxSum)
+            maxSum = sum;
+
+        for (k = 0; k < matrixSize; k++)
+            if (mat2[j][k] > maxElem)
+                maxElem = mat2[j][k];
+    }
+    *narrow = (maxElem == 0) || (maxSum <= 0xFFFFFFFFu / maxElem);
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_checkRange
+ *
+ *  @desc   Bounds every element of mat1 * mat2 by the sum of its row of mat1
+ *          times the largest element of mat2. The check costs two passes
+ *          over the operands, against matrixSize for the product.
+ *
+ *  @modif  matMultRowSum
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_checkRange, ".text:matMult")
+Uint32 MATMULT_checkRange(Uint16 matrixSize, Bool* narrow)
+{
+    Uint32 start, stop;
+    Uint32 sum, maxSum;
+    Uint16 maxElem;
+    Uint16 j, k;
+
+    start = TSCL;
+    maxSum = 0;
+    maxElem = 0;
+    for (j = 0; j < matrixSize; j++)
+    {
+        sum = 0;
+        for (k = 0; k < matrixSize; k++)
+        {
+            sum += mat1[j][k];
+            if (mat2[j][k] > maxElem)
+                maxElem = mat2[j][k];
+        }
+        matMultRowSum[j] = sum;
+        if (sum > maxSum)
+            maxSum = sum;
+    }
+    *narrow = (maxElem == 0) || (maxSum <= 0xFFFFFFFFu / maxElem);
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyWide
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 with 64-bit
+ *          elements, a tile of MATMULT_TILE_COLS columns at a time. The
+ *          largest element of the tile is found while staging it; a row of
+ *          the tile whose sum times that element fits in 32 bits runs the
+ *          32-bit inner loop of MATMULT_multiply, the others the wide one.
+ *
+ *  @modif  None.
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_multiplyWide, ".text:matMult")
+Uint32 MATMULT_multiplyWide(Uint32* result, Uint16 matrixSize,
+                            Uint16 rowStart, Uint16 rowEnd)
+{
+    Uint32 start, stop;
+    Uint32 sum;
+    Uint32 limit;
+    MATMULT_Accum wide;
+    Uint32* out;
+    Uint16 j, k, l;
+    Uint16 tileStart, tileCols;
+    Uint16 tileMax;
+
+    start = TSCL;
+    for (tileStart = 0; tileStart < matrixSize; tileStart += MATMULT_TILE_COLS)
+    {
+        tileCols = (matrixSize - tileStart < MATMULT_TILE_COLS)
+                   ? (matrixSize - tileStart) : MATMULT_TILE_COLS;
+
+        /* Stage the tile and find its largest element */
+        tileMax = 0;
+        for (l = 0; l < matrixSize; l++)
+            for (k = 0; k < tileCols; k++)
+            {
+                matMultTile[k][l] = mat2[l][tileStart + k];
+                if (matMultTile[k][l] > tileMax)
+                    tileMax = matMultTile[k][l];
+            }
+        limit = (tileMax == 0) ? 0xFFFFFFFFu : (0xFFFFFFFFu / tileMax);
+
+        for (j = rowStart; j < rowEnd; j++)
+        {
+            out = result + 2 * ((j - rowStart) * matrixSize + tileStart);
+            if (matMultRowSum[j] <= limit)
+            {
+                for (k = 0; k < tileCols; k++)
+                {
+                    sum = 0;
+                    #pragma MUST_ITERATE(1, MAXSIZE)
+                    for (l = 0; l < matrixSize; l++)
+                        sum += ((Uint32)mat1[j][l]) * ((Uint32)matMultTile[k][l]);
+                    out[2 * k] = sum;
+                    out[2 * k + 1] = 0;
+                }
+            }
+            else
+            {
+                for (k = 0; k < tileCols; k++)
+                {
+                    wide = 0;
+                    for (l = 0; l < matrixSize; l++)
+                        wide += ((Uint32)mat1[j][l]) * ((Uint32)matMultTile[k][l]);
+                    out[2 * k] = (Uint32) wide;
+                    out[2 * k + 1] = (Uint32) (wide >> 32);
+                }
+            }
+        }
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_gemm
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of alpha * op(mat1) * op(mat2)
+ *          with the loop order that suits each combination of transposes:
+ *              A * B       columns of mat2 staged a tile at a time, as in
+ *                          MATMULT_multiply
+ *              A * B^T     rows of mat1 times rows of mat2, nothing staged
+ *              A^T * B     rows of mat2 scaled by a column of mat1 and
+ *                          added up into the result row
+ *              A^T * B^T   a column of mat1 staged, then times rows of mat2
+ *          alpha is applied once per element of the product, or folded into
+ *          the scale factors for A^T * B.
+ *
+ *  @modif  None.
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_gemm, ".text:matMult")
+Uint32 MATMULT_gemm(Uint32* result, Uint16 n, Uint16 k, Bool transA, Bool transB,
+                    Uint32 alpha, Uint16 rowStart, Uint16 rowEnd)
+{
+    Uint16* col = matMultTile[0];
+    Uint32 start, stop;
+    Uint32 sum;
+    Uint32 scale;
+    Uint32* out;
+    Uint16 i, j, l;
+    Uint16 tileStart, tileCols;
+
+    start = TSCL;
+    if (!transA && !transB)
+    {
+        for (tileStart = 0; tileStart < n; tileStart += MATMULT_TILE_COLS)
+        {
+            tileCols = (n - tileStart < MATMULT_TILE_COLS)
+                       ? (n - tileStart) : MATMULT_TILE_COLS;
+
+            /* Stage the tile */
+            for (l = 0; l < k; l++)
+                for (j = 0; j < tileCols; j++)
+                    matMultTile[j][l] = mat2[l][tileStart + j];
+
+            for (i = rowStart; i < rowEnd; i++)
+                for (j = 0; j < tileCols; j++)
+                {
+                    sum = 0;
+                    #pragma MUST_ITERATE(1, MAXSIZE)
+                    for (l = 0; l < k; l++)
+                        sum += ((Uint32)mat1[i][l]) * ((Uint32)matMultTile[j][l]);
+                    result[(i - rowStart) * n + tileStart + j] = alpha * sum;
+                }
+        }
+    }
+    else if (!transA)
+    {
+        for (i = rowStart; i < rowEnd; i++)
+            for (j = 0; j < n; j++)
+            {
+                sum = 0;
+                #pragma MUST_ITERATE(1, MAXSIZE)
+                for (l = 0; l < k; l++)
+                    sum += ((Uint32)mat1[i][l]) * ((Uint32)mat2[j][l]);
+                result[(i - rowStart) * n + j] = alpha * sum;
+            }
+    }
+    else if (!transB)
+    {
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            out = result + (i - rowStart) * n;
+            for (j = 0; j < n; j++)
+                out[j] = 0;
+            for (l = 0; l < k; l++)
+            {
+                scale = alpha * mat1[l][i];
+                if (scale == 0)
+                    continue;
+                #pragma MUST_ITERATE(1, MAXSIZE)
+                for (j = 0; j < n; j++)
+                    out[j] += scale * ((Uint32)mat2[l][j]);
+            }
+        }
+    }
+    else
+    {
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            /* Stage the column */
+            for (l = 0; l < k; l++)
+                col[l] = mat1[l][i];
+
+            for (j = 0; j < n; j++)
+            {
+                sum = 0;
+                #pragma MUST_ITERATE(1, MAXSIZE)
+                for (l = 0; l < k; l++)
+                    sum += ((Uint32)col[l]) * ((Uint32)mat2[j][l]);
+                result[(i - rowStart) * n + j] = alpha * sum;
+            }
+        }
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_gemv
+ *
+ *  @desc   Multiplies matResident by the vectors MATMULT_TILE_COLS at a
+ *          time. The vectors of a tile are staged, then each row of the
+ *          matrix is read once for the whole tile and multiplied by four
+ *          vectors per pass, so the matrix is streamed once per tile
+ *          rather than once per vector.
+ *
+ *  @modif  None.
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_gemv, ".text:matMult")
+Uint32 MATMULT_gemv(Uint32* result, Uint16 m, Uint16 k, const Uint16* x,
+                    Uint16 numVectors)
+{
+    Uint32 start, stop;
+    Uint32 sum0, sum1, sum2, sum3;
+    Uint32 a;
+    const Uint16* row;
+    Uint16 i, l, v;
+    Uint16 tileStart, tileCols;
+
+    start = TSCL;
+    for (tileStart = 0; tileStart < numVectors; tileStart += MATMULT_TILE_COLS)
+    {
+        tileCols = (numVectors - tileStart < MATMULT_TILE_COLS)
+                   ? (numVectors - tileStart) : MATMULT_TILE_COLS;
+
+        /* Stage the vectors */
+        for (v = 0; v < tileCols; v++)
+            for (l = 0; l < k; l++)
+                matMultTile[v][l] = x[(tileStart + v) * k + l];
+
+        for (i = 0; i < m; i++)
+        {
+            row = matResident[i];
+            for (v = 0; v + 4 <= tileCols; v += 4)
+            {
+                sum0 = 0;
+                sum1 = 0;
+                sum2 = 0;
+                sum3 = 0;
+                #pragma MUST_ITERATE(1, MAXSIZE)
+                for (l = 0; l < k; l++)
+                {
+                    a = row[l];
+                    sum0 += a * ((Uint32)matMultTile[v][l]);
+                    sum1 += a * ((Uint32)matMultTile[v + 1][l]);
+                    sum2 += a * ((Uint32)matMultTile[v + 2][l]);
+                    sum3 += a * ((Uint32)matMultTile[v + 3][l]);
+                }
+                result[(tileStart + v) * m + i] = sum0;
+                result[(tileStart + v + 1) * m + i] = sum1;
+                result[(tileStart + v + 2) * m + i] = sum2;
+                result[(tileStart + v + 3) * m + i] = sum3;
+            }
+            for (; v < tileCols; v++)
+            {
+                sum0 = 0;
+                #pragma MUST_ITERATE(1, MAXSIZE)
+                for (l = 0; l < k; l++)
+                    sum0 += ((Uint32)row[l]) * ((Uint32)matMultTile[v][l]);
+                result[(tileStart + v) * m + i] = sum0;
+            }
+        }
+    }
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_benchOperands
+ *
+ *  @desc   Fills the operands of MATMULT_bench with values spread over
+ *          16 bits, their low bytes for the 8-bit kernel.
+ *
+ *  @modif  mat1, mat2, mat1Packed, mat2Packed
+ *  ============================================================================
+ */
+Void MATMULT_benchOperands(Uint16 matrixSize)
+{
+    Uint16 j, k;
+
+    for (j = 0; j < matrixSize; j++)
+        for (k = 0; k < matrixSize; k++)
+        {
+            mat1[j][k] = (Uint16) (j * 251 + k * 31 + 1);
+            mat2[j][k] = (Uint16) (j * 17 + k * 241 + 3);
+            mat1Packed[j][k] = (Uint8) mat1[j][k];
+            mat2Packed[j][k] = (Uint8) mat2[j][k];
+        }
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_bench
+ *
+ *  @desc   Computes the whole product with one of the MATMULT_BENCH_*
+ *          kernels into matMultArena.
+ *
+ *  @modif  matMultArena
+ *  ============================================================================
+ */
+Void MATMULT_bench(Uint16 kernel, Uint16 matrixSize)
+{
+    switch (kernel)
+    {
+        case MATMULT_BENCH_NAIVE:
+            MATMULT_multiplyNaive(matMultArena, matrixSize, 0, matrixSize);
+            break;
+
+        case MATMULT_BENCH_TRANSPOSED:
+            MATMULT_multiplyVariant(matMultArena, matrixSize, 0, matrixSize, MATMULT_TILE_COLS);
+            break;
+
+        case MATMULT_BENCH_TILED:
+            MATMULT_multiplyVariant(matMultArena, matrixSize, 0, matrixSize,
+                                    MATMULT_TILE_COLS | MATMULT_VARIANT_UNROLL4);
+            break;
+
+        case MATMULT_BENCH_SIMD:
+            MATMULT_multiplyPacked(matMultArena, matrixSize, 0, matrixSize);
+            break;
+
+        default:
+            MATMULT_multiply(matMultArena, matrixSize, 0, matrixSize);
+            break;
+    }
+}
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyStrassen
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 with the
+ *          Strassen-Winograd algorithm.
+ *
+ *          The operands are zero-padded to m = b * 2^k, with k the number of
+ *          halvings that bring the size to the cutoff and b the resulting
+ *          base size, so that every level splits evenly with less than 2^k
+ *          rows of padding. Differences of operands wrap around modulo
+ *          2^32 like the products, which keeps the result exact.
+ *
+ *  @modif  matMultArena, matMultProduct, matMultProductDim
+ *  ============================================================================
+ */
+#pragma CODE_SECTION(MATMULT_multiplyStrassen, ".text:matMult")
+Uint32 MATMULT_multiplyStrassen(Uint32* result, Uint16 matrixSize,
+                                Uint16 rowStart, Uint16 rowEnd, Uint16 cutoff)
+{
+    Uint32 start, stop;
+    Uint32* A;
+    Uint32* B;
+    Uint16 m, levels;
+    Uint16 j, k;
+
+    start = TSCL;
+    if (rowStart == 0)
+    {
+        /* Padded size */
+        m = matrixSize;
+        for (levels = 0; m > cutoff; levels++)
+            m = (m + 1) / 2;
+        m <<= levels;
+
+        /* Carve the arena: product, operands, then the temporaries */
+        matMultProduct = matMultArena;
+        matMultProductDim = m;
+        A = matMultProduct + m * m;
+        B = A + m * m;
+
+        for (j = 0; j < m; j++)
+            for (k = 0; k < m; k++)
+            {
+                A[j * m + k] = ((j < matrixSize) && (k < matrixSize)) ? mat1[j][k] : 0;
+                B[j * m + k] = ((j < matrixSize) && (k < matrixSize)) ? mat2[j][k] : 0;
+            }
+
+        MATMULT_winograd(matMultProduct, m, A, m, B, m, m, cutoff, B + m * m);
+    }
+
+    /* Copy the rows out */
+    for (j = rowStart; j < rowEnd; j++)
+        for (k = 0; k < matrixSize; k++)
+            result[(j - rowStart) * matrixSize + k] = matMultProduct[j * matMultProductDim + k];
+    stop = TSCL;
+
+    return stop - start;
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   MATMULT_winograd
+ *
+ *  @desc   C = A * B for m x m matrices, recursing while m is above the
+ *          cutoff. Follows the schedule of Boyer, Dumas, Pernet and Zhou,
+ *          which needs two quadrant temporaries X and Y per level and uses
+ *          the quadrants of C for the products:
+ *
+ *              S3 = A11 - A21 -> X     T3 = B22 - B12 -> Y    P7 = S3 T3  -> C21
+ *              S1 = A21 + A22 -> X     T1 = B12 - B11 -> Y    P5 = S1 T1  -> C22
+ *              S2 = S1 - A11  -> X     T2 = B22 - T1  -> Y    P6 = S2 T2  -> C12
+ *              S4 = A12 - S2  -> X     P3 = S4 B22    -> C11  P1 = A11 B11 -> X
+ *              C12 = P1 + P6           C21 = C12 + P7         C12 = C12 + P5
+ *              C22 = C21 + P5          C12 = C12 + P3         T4 = T2 - B21 -> Y
+ *              P4 = A22 T4    -> C11   C21 = C21 - P4
+ *              P2 = A12 B21   -> C11   C11 = P1 + P2
+ *
+ *          At or below the cutoff the product is computed like
+ *          MATMULT_multiply, on 32-bit elements and so with half as many
+ *          columns staged per tile.
+ *
+ *  @modif  C, scratch
+ *  ----------------------------------------------------------------------------
+ */
+#pragma CODE_SECTION(MATMULT_winograd, ".text:matMult")
+static Void MATMULT_winograd(Uint32* C, Uint16 ldc, const Uint32* A, Uint16 lda,
+                             const Uint32* B, Uint16 ldb, Uint16 m,
+                             Uint16 cutoff, Uint32* scratch)
+{
+    Uint32 (*tile)[MAXSIZE] = (Uint32 (*)[MAXSIZE]) matMultTile;
+    Uint16 h = m / 2;
+    Uint32 sum;
+    Uint16 j, k, l;
+    Uint16 tileStart, tileCols;
+    const Uint32 *A11, *A12, *A21, *A22, *B11, *B12, *B21, *B22;
+    Uint32 *C11, *C12, *C21, *C22, *X, *Y, *next;
+
+    /* Base kernel */
+    if (m <= cutoff)
+    {
+        for (tileStart = 0; tileStart < m; tileStart += MATMULT_TILE_COLS / 2)
+        {
+            tileCols = (m - tileStart < MATMULT_TILE_COLS / 2)
+                       ? (m - tileStart) : MATMULT_TILE_COLS / 2;
+
+            /* Stage the tile */
+            for (l = 0; l < m; l++)
+                for (k = 0; k < tileCols; k++)
+                    tile[k][l] = B[l * ldb + tileStart + k];
+
+            for (j = 0; j < m; j++)
+                for (k = 0; k < tileCols; k++)
+                {
+                    sum = 0;
+                    #pragma MUST_ITERATE(1, MAXSIZE)
+                    for (l = 0; l < m; l++)
+                        sum += A[j * lda + l] * tile[k][l];
+                    C[j * ldc + tileStart + k] = sum;
+                }
+        }
+        return;
+    }
+
+    A11 = A;            A12 = A + h;
+    A21 = A + h * lda;  A22 = A21 + h;
+    B11 = B;            B12 = B + h;
+    B21 = B + h * ldb;  B22 = B21 + h;
+    C11 = C;            C12 = C + h;
+    C21 = C + h * ldc;  C22 = C21 + h;
+    X = scratch;
+    Y = X + h * h;
+    next = Y + h * h;
+
+    MATMULT_sub(X, h, A11, lda, A21, lda, h);
+    MATMULT_sub(Y, h, B22, ldb, B12, ldb, h);
+    MATMULT_winograd(C21, ldc, X, h, Y, h, h, cutoff, next);
+
+    MATMULT_add(X, h, A21, lda, A22, lda, h);
+    MATMULT_sub(Y, h, B12, ldb, B11, ldb, h);
+    MATMULT_winograd(C22, ldc, X, h, Y, h, h, cutoff, next);
+
+    MATMULT_sub(X, h, X, h, A11, lda, h);
+    MATMULT_sub(Y, h, B22, ldb, Y, h, h);
+    MATMULT_winograd(C12, ldc, X, h, Y, h, h, cutoff, next);
+
+    MATMULT_sub(X, h, A12, lda, X, h, h);
+    MATMULT_winograd(C11, ldc, X, h, B22, ldb, h, cutoff, next);
+
+    MATMULT_winograd(X, h, A11, lda, B11, ldb, h, cutoff, next);
+
+    MATMULT_add(C12, ldc, X, h, C12, ldc, h);
+    MATMULT_add(C21, ldc, C12, ldc, C21, ldc, h);
+    MATMULT_add(C12, ldc, C12, ldc, C22, ldc, h);
+    MATMULT_add(C22, ldc, C21, ldc, C22, ldc, h);
+    MATMULT_add(C12, ldc, C12, ldc, C11, ldc, h);
+
+    MATMULT_sub(Y, h, Y, h, B21, ldb, h);
+    MATMULT_winograd(C11, ldc, A22, lda, Y, h, h, cutoff, next);
+    MATMULT_sub(C21, ldc, C21, ldc, C11, ldc, h);
+
+    MATMULT_winograd(C11, ldc, A12, lda, B21, ldb, h, cutoff, next);
+    MATMULT_add(C11, ldc, X, h, C11, ldc, h);
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   MATMULT_add
+ *
+ *  @desc   D = P + Q. D may be P or Q.
+ *
+ *  @modif  D
+ *  ----------------------------------------------------------------------------
+ */
+#pragma CODE_SECTION(MATMULT_add, ".text:matMult")
+static Void MATMULT_add(Uint32* D, Uint16 ldd, const Uint32* P, Uint16 ldp,
+                        const Uint32* Q, Uint16 ldq, Uint16 m)
+{
+    Uint16 j, k;
+
+    for (j = 0; j < m; j++)
+        for (k = 0; k < m; k++)
+            D[j * ldd + k] = P[j * ldp + k] + Q[j * ldq + k];
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   MATMULT_sub
+ *
+ *  @desc   D = P - Q. D may be P or Q.
+ *
+ *  @modif  D
+ *  ----------------------------------------------------------------------------
+ */
+#pragma CODE_SECTION(MATMULT_sub, ".text:matMult")
+static Void MATMULT_sub(Uint32* D, Uint16 ldd, const Uint32* P, Uint16 ldp,
+                        const Uint32* Q, Uint16 ldq, Uint16 m)
+{
+    Uint16 j, k;
+
+    for (j = 0; j < m; j++)
+        for (k = 0; k < m; k++)
+            D[j * ldd + k] = P[j * ldp + k] - Q[j * ldq + k];
+}
+
+
+#if defined (__cplusplus)
+}
+#endif /* defined (__cplusplus) */
@@ -0,0 +1,515 @@
+/** ============================================================================
+ *  @file   matMult.h
+ *
+ *  @path   
+ *
+ *  @desc   Matrix multiplication kernel of the helloDSP sample. The operands
+ *          are stored by the message task and the product is computed row
+ *          range by row range into the result messages.
+ *
+ *  @ver    1.10
+ *  ============================================================================
+ */
+
+
+#ifndef MATMULT_
+#define MATMULT_
+
+
+/*  ----------------------------------- DSP/BIOS Headers            */
+#include <std.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Largest matrix size handled by the kernel */
+#define MAXSIZE             128
+
+/* Columns of the second operand staged at a time by the kernel. */
+#define MATMULT_TILE_COLS   16
+
+/* Variant of the base kernel for MATMULT_multiplyVariant: columns of the
+ * tile in the low byte, 4, 8 or 16, and the options below. UNROLL4 computes
+ * four dot products per pass over a row of mat1; AXPY instead accumulates
+ * a whole row of the product tile per element of mat1, and takes no
+ * UNROLL4. DIRECT reads the tile in place from mat2 instead of staging it.
+ * FIXED alone, or 0, selects MATMULT_multiply. */
+#define MATMULT_VARIANT_TILE    0x00FF
+#define MATMULT_VARIANT_UNROLL4 0x0100
+#define MATMULT_VARIANT_AXPY    0x0200
+#define MATMULT_VARIANT_DIRECT  0x0400
+#define MATMULT_VARIANT_FIXED   0x0800
+
+#define MATMULT_VARIANT_VALID(v)                                              \
+    (((v) == 0) || ((v) == MATMULT_VARIANT_FIXED)                             \
+     || ((((v) & ~(MATMULT_VARIANT_TILE | MATMULT_VARIANT_UNROLL4             \
+                   | MATMULT_VARIANT_AXPY | MATMULT_VARIANT_DIRECT)) == 0)    \
+         && ((((v) & MATMULT_VARIANT_TILE) == 4) || (((v) & MATMULT_VARIANT_TILE) == 8) \
+             || (((v) & MATMULT_VARIANT_TILE) == 16))                         \
+         && (((v) & (MATMULT_VARIANT_AXPY | MATMULT_VARIANT_UNROLL4))         \
+             != (MATMULT_VARIANT_AXPY | MATMULT_VARIANT_UNROLL4))))
+
+/* Kernels timed by MATMULT_bench: the plain triple loop, the staged tile
+ * of transposed columns with one dot product at a time, the same with four
+ * (register tiling), four 8-bit products per instruction, and
+ * MATMULT_multiply, specialised for powers of two from 4 to 128. */
+#define MATMULT_BENCH_NAIVE         0
+#define MATMULT_BENCH_TRANSPOSED    1
+#define MATMULT_BENCH_TILED         2
+#define MATMULT_BENCH_SIMD          3
+#define MATMULT_BENCH_FIXED         4
+#define MATMULT_BENCH_KERNELS       5
+
+/* Smallest cutoff of the Strassen-Winograd recursion. Sets the padding,
+ * hence the arena size below. */
+#define MATMULT_MIN_CUTOFF  16
+
+/* The Strassen-Winograd operands are padded to a size below
+ * MATMULT_ARENA_DIM. The arena holds both padded operands, the product and
+ * two quadrant temporaries per level of recursion (under 2/3 of a matrix
+ * in total), all as 32-bit words. */
+#define MATMULT_ARENA_DIM   (MAXSIZE + MAXSIZE / MATMULT_MIN_CUTOFF)
+#define MATMULT_ARENA_WORDS ((11 * MATMULT_ARENA_DIM * MATMULT_ARENA_DIM + 2) / 3)
+
+/* First operand of the job in progress in compressed sparse row form, for
+ * MATMULT_multiplySparse: the non-zeros of row j are at
+ * [matSparseRowPtr[j], matSparseRowPtr[j + 1]) in the column and value
+ * arrays. */
+extern Uint16 matSparseRowPtr[MAXSIZE + 1];
+extern Uint16 matSparseCol[MAXSIZE * MAXSIZE];
+extern Uint16 matSparseVal[MAXSIZE * MAXSIZE];
+
+/* Accumulator of the wide kernel, which holds any inner product of MAXSIZE
+ * products of 16-bit terms (under 2^39). With the COFF ABI of the C64x+,
+ * long is 40 bits and added natively. */
+#if defined (_TMS320C6X) && !defined (__TI_EABI__)
+typedef unsigned long       MATMULT_Accum;
+#else
+typedef unsigned long long  MATMULT_Accum;
+#endif
+
+/* Resident matrix of MATMULT_gemv, row-major */
+extern Uint16 matResident[MAXSIZE][MAXSIZE];
+
+/* Operands of the job in progress, row-major */
+extern Uint16 mat1[MAXSIZE][MAXSIZE];
+extern Uint16 mat2[MAXSIZE][MAXSIZE];
+
+/* 8-bit operands of the job in progress for MATMULT_multiplyPacked,
+ * row-major. */
+extern Uint8 mat1Packed[MAXSIZE][MAXSIZE];
+extern Uint8 mat2Packed[MAXSIZE][MAXSIZE];
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiply
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2. Sizes 4, 8,
+ *          16, 32, 64 and 128 run a kernel specialised for that size with
+ *          constant trip counts, any other size the generic kernel.
+ *
+ *  @arg    result
+ *              Row block receiving the product, with a row stride of
+ *              matrixSize.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The operands are stored in mat1 and mat2.
+ *
+ *  @leave  None
+ *
+ *  @see    None
+ *  ============================================================================
+ */
+Uint32 MATMULT_multiply(Uint32* result, Uint16 matrixSize,
+                        Uint16 rowStart, Uint16 rowEnd);
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyVariant
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 with the given
+ *          variant of the base kernel, for the autotuner to choose from.
+ *          The product is exactly that of MATMULT_multiply.
+ *
+ *  @arg    result
+ *              Row block receiving the product, with a row stride of
+ *              matrixSize.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *  @arg    variant
+ *              Variant of the kernel, see MATMULT_VARIANT_*. Must satisfy
+ *              MATMULT_VARIANT_VALID.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The operands are stored in mat1 and mat2.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiply
+ *  ============================================================================
+ */
+Uint32 MATMULT_multiplyVariant(Uint32* result, Uint16 matrixSize,
+                               Uint16 rowStart, Uint16 rowEnd, Uint16 variant);
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyNaive
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 with the plain
+ *          triple loop, walking the columns of mat2 in place. The baseline
+ *          of MATMULT_bench.
+ *
+ *  @arg    result
+ *              Row block receiving the product, with a row stride of
+ *              matrixSize.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The operands are stored in mat1 and mat2.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiply
+ *  ============================================================================
+ */
+Uint32 MATMULT_multiplyNaive(Uint32* result, Uint16 matrixSize,
+                             Uint16 rowStart, Uint16 rowEnd);
+
+
+/** ============================================================================
+ *  @func   MATMULT_benchOperands
+ *
+ *  @desc   Fills mat1 and mat2, and mat1Packed and mat2Packed with their
+ *          low bytes, with operands of the given size for MATMULT_bench.
+ *          Any job in progress is lost.
+ *
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *
+ *  @ret    None
+ *
+ *  @enter  None
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_bench
+ *  ============================================================================
+ */
+Void MATMULT_benchOperands(Uint16 matrixSize);
+
+
+/** ============================================================================
+ *  @func   MATMULT_bench
+ *
+ *  @desc   Computes the whole product of the benchmark operands with the
+ *          given kernel into the Strassen-Winograd arena, which holds any
+ *          product. The caller times it.
+ *
+ *  @arg    kernel
+ *              Kernel, see MATMULT_BENCH_*.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *
+ *  @ret    None
+ *
+ *  @enter  MATMULT_benchOperands () was called for the size, and no
+ *          Strassen-Winograd job is in progress.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_benchOperands
+ *  ============================================================================
+ */
+Void MATMULT_bench(Uint16 kernel, Uint16 matrixSize);
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyStrassen
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 with the
+ *          Strassen-Winograd algorithm. The whole product is computed into
+ *          the arena when rowStart is 0; the rows are then copied out.
+ *          Arithmetic is modulo 2^32 throughout, so the result is exactly
+ *          that of MATMULT_multiply.
+ *
+ *  @arg    result
+ *              Row block receiving the product, with a row stride of
+ *              matrixSize.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *  @arg    cutoff
+ *              Size at or below which the recursion switches to the base
+ *              kernel. At least MATMULT_MIN_CUTOFF.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The operands are stored in mat1 and mat2. Row blocks are
+ *          requested in order, starting at row 0.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiply
+ *  ============================================================================
+ */
+Uint32 MATMULT_multiplyStrassen(Uint32* result, Uint16 matrixSize,
+                                Uint16 rowStart, Uint16 rowEnd, Uint16 cutoff);
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyPacked
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1Packed * mat2Packed,
+ *          four 8-bit products per multiply-accumulate. The products of
+ *          8-bit operands always fit in 32 bits.
+ *
+ *  @arg    result
+ *              Row block receiving the product, with a row stride of
+ *              matrixSize.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The operands are stored in mat1Packed and mat2Packed.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiply
+ *  ============================================================================
+ */
+Uint32 MATMULT_multiplyPacked(Uint32* result, Uint16 matrixSize,
+                              Uint16 rowStart, Uint16 rowEnd);
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplySparse
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of the sparse first operand
+ *          times mat2, in time proportional to the non-zeros of those rows.
+ *
+ *  @arg    result
+ *              Row block receiving the product, with a row stride of
+ *              matrixSize.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The first operand is stored in matSparseRowPtr, matSparseCol and
+ *          matSparseVal, the second in mat2.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiply
+ *  ============================================================================
+ */
+Uint32 MATMULT_multiplySparse(Uint32* result, Uint16 matrixSize,
+                              Uint16 rowStart, Uint16 rowEnd);
+
+
+/** ============================================================================
+ *  @func   MATMULT_expandSparse
+ *
+ *  @desc   Stores the sparse first operand densely in mat1, for the kernels
+ *          that need it so.
+ *
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The first operand is stored in matSparseRowPtr, matSparseCol and
+ *          matSparseVal.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiplySparse
+ *  ============================================================================
+ */
+Uint32 MATMULT_expandSparse(Uint16 matrixSize);
+
+
+/** ============================================================================
+ *  @func   MATMULT_checkRangeSparse
+ *
+ *  @desc   MATMULT_checkRange for a first operand stored in sparse form.
+ *
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    narrow
+ *              Set to TRUE when no element of the product exceeds 32 bits.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The first operand is stored in matSparseRowPtr, matSparseCol and
+ *          matSparseVal, the second in mat2.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_checkRange
+ *  ============================================================================
+ */
+Uint32 MATMULT_checkRangeSparse(Uint16 matrixSize, Bool* narrow);
+
+
+/** ============================================================================
+ *  @func   MATMULT_checkRange
+ *
+ *  @desc   Bounds every element of mat1 * mat2 by the sum of its row of mat1
+ *          times the largest element of mat2, and tells whether the product
+ *          fits in 32 bits. The row sums are kept for MATMULT_multiplyWide.
+ *
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    narrow
+ *              Set to TRUE when no element of the product exceeds 32 bits.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The operands are stored in mat1 and mat2.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiplyWide
+ *  ============================================================================
+ */
+Uint32 MATMULT_checkRange(Uint16 matrixSize, Bool* narrow);
+
+
+/** ============================================================================
+ *  @func   MATMULT_multiplyWide
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of mat1 * mat2 with 64-bit
+ *          elements. Each row of a tile is accumulated in 32 bits when its
+ *          bound allows it, and in a MATMULT_Accum otherwise.
+ *
+ *  @arg    result
+ *              Row block receiving the product as pairs of words, low word
+ *              first, with a row stride of matrixSize pairs.
+ *  @arg    matrixSize
+ *              Size of the operands.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  MATMULT_checkRange () was called for the operands.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_checkRange
+ *  ============================================================================
+ */
+Uint32 MATMULT_multiplyWide(Uint32* result, Uint16 matrixSize,
+                            Uint16 rowStart, Uint16 rowEnd);
+
+
+/** ============================================================================
+ *  @func   MATMULT_gemm
+ *
+ *  @desc   Computes rows [rowStart, rowEnd) of alpha * op(mat1) * op(mat2),
+ *          where op() transposes mat1 when transA is set and mat2 when
+ *          transB is, modulo 2^32. Each combination of transposes has its own loop order so
+ *          that the inner loop runs along rows of the operands as stored.
+ *
+ *  @arg    result
+ *              Row block receiving the product, with a row stride of n.
+ *  @arg    n
+ *              Columns of the product.
+ *  @arg    k
+ *              Inner dimension of the product.
+ *  @arg    transA
+ *              TRUE when mat1 holds the transpose of the first operand.
+ *  @arg    transB
+ *              TRUE when mat2 holds the transpose of the second operand.
+ *  @arg    alpha
+ *              Scale of the product.
+ *  @arg    rowStart
+ *              First row to compute.
+ *  @arg    rowEnd
+ *              Row after the last row to compute.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The operands are stored in mat1 and mat2 as sent, op(mat1)
+ *          having at least rowEnd rows.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiply
+ *  ============================================================================
+ */
+Uint32 MATMULT_gemm(Uint32* result, Uint16 n, Uint16 k, Bool transA, Bool transB,
+                    Uint32 alpha, Uint16 rowStart, Uint16 rowEnd);
+
+
+/** ============================================================================
+ *  @func   MATMULT_gemv
+ *
+ *  @desc   Multiplies matResident by a batch of vectors, modulo 2^32.
+ *
+ *  @arg    result
+ *              Products, one after the other, m elements each.
+ *  @arg    m
+ *              Rows of matResident.
+ *  @arg    k
+ *              Columns of matResident and elements per vector.
+ *  @arg    x
+ *              Vectors, one after the other, k elements each.
+ *  @arg    numVectors
+ *              Number of vectors.
+ *
+ *  @ret    Number of cycles spent.
+ *
+ *  @enter  The matrix is stored in matResident.
+ *
+ *  @leave  None
+ *
+ *  @see    MATMULT_multiply
+ *  ============================================================================
+ */
+Uint32 MATMULT_gemv(Uint32* result, Uint16 m, Uint16 k, const Uint16* x,
+                    Uint16 numVectors);
+
+
+#ifdef __cplusplus
+}
+#endif /* extern "C" */
+
+
+#endif /* MATMULT_ */
@@ -18,15 +18,20 @@
 #include <sem.h>
 #include <msgq.h>
 #include <pool.h>
+#include <bcache.h>
+#include <mem.h>
+#include <tsk.h>
 
 /*  ----------------------------------- DSP/BIOS LINK Headers       */
 #include <dsplink.h>
 #include <platform.h>
 #include <failure.h>
+#include <notify.h>
 
 /*  ----------------------------------- Sample Headers              */
 #include <helloDSP_config.h>
 #include <tskMessage.h>
+#include <matMult.h>
 
 /*  ----------------------------------- Timer Headers               */
 #include "c6x.h"
@@ -42,15 +47,180 @@ extern "C" {
 /* Place holder for the MSGQ name created on DSP */
 Uint8 dspMsgQName[DSP_MAX_STRLEN];
 
-/* Number of iterations message transfers to be done by the application. */
-extern Uint16 matrixSize;
+/* Clock ticks to wait before retrying when the pool is exhausted. */
+#define RETRY_TICKS     1
 
-#define MAXSIZE         128
+/* Attempts to allocate a reply, RETRY_TICKS apart, before it is dropped:
+ * about ten seconds for a GPP to release the buffers it holds. */
+#define ALLOC_RETRIES   10000
 
-/* Matrices to store results from GPP */
-Uint16 mat1[MAXSIZE][MAXSIZE];
-Uint16 mat2[MAXSIZE][MAXSIZE];
+/* Clock ticks a job may wait for its next block before it is abandoned,
+ * as when its client went away between two blocks. */
+#define JOB_TIMEOUT_TICKS   2000
 
+/* Clock ticks a job may wait for its next block before it is abandoned,
+ * as when its client went away between two blocks. */
+#define JOB_TIMEOUT_TICKS   2000
+
+/* Stores a cycle count as two words, low word first. */
+#define CYCLES_TO_WORDS(words, cycles)                                        \
+    ((words)[0] = (Uint32) (cycles), (words)[1] = (Uint32) ((cycles) >> 32))
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storeOperand
+ *
+ *  @desc   Copies an operand row block into mat1 or mat2. Returns SYS_EBUSY
+ *          when the block belongs to another job than the one in progress.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storeOperand(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                   MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_generateRows
+ *
+ *  @desc   Computes the rows of a generated operand block into mat or
+ *          matPacked.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_generateRows(TSKMESSAGE_TransferInfo* info, const GenSpec* spec,
+                                    Uint16 rowStart, Uint16 numRows, Uint16 width,
+                                    Uint16 (*mat)[MAXSIZE], Uint8 (*matPacked)[MAXSIZE]);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_sendResult
+ *
+ *  @desc   Computes the product of the job in progress and sends it back in
+ *          row blocks.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_sendResult(TSKMESSAGE_TransferInfo* info);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_allocReply
+ *
+ *  @desc   Allocates a reply, waiting a bounded time for the pool.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_allocReply(Uint16 size, MSGQ_Msg* msgPtr);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_defer
+ *
+ *  @desc   Appends a request to the deferred requests.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_defer(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_abandonJob
+ *
+ *  @desc   Gives up the job in progress and tells its client.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_abandonJob(TSKMESSAGE_TransferInfo* info);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storeResident
+ *
+ *  @desc   Copies a row block of the resident matrix into matResident and
+ *          acknowledges the last one.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storeResident(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                    MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_multiplyVectors
+ *
+ *  @desc   Multiplies the resident matrix by a block of vectors and sends
+ *          the products back.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_multiplyVectors(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                      MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storeTuning
+ *
+ *  @desc   Replaces the tuning table and acknowledges it.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storeTuning(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                  MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_reportStats
+ *
+ *  @desc   Replies with the statistics of the DSP.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_reportStats(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                  MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storePool
+ *
+ *  @desc   Records the description of the message pool and replies with
+ *          the statistics of the DSP.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storePool(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_runBench
+ *
+ *  @desc   Times the kernels of MATMULT_bench and replies with the table.
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_runBench(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                               MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_echo
+ *
+ *  @desc   Sends a CMD_ECHO message back to its sender.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_echo(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                            MSGQ_Queue replyQueue);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_echoNotify
+ *
+ *  @desc   NOTIFY callback of the link benchmark events.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_echoNotify(Uint32 eventNo, Ptr arg, Ptr info);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_echoEvent
+ *
+ *  @desc   Notifies a link benchmark event back to the GPP.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_echoEvent(Arg arg0, Arg arg1);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_acknowledge
+ *
+ *  @desc   Sends a reply with the given command and payload.
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_acknowledge(TSKMESSAGE_TransferInfo* info, MSGQ_Queue replyQueue,
+                                   Uint16 command, Uint16 jobId, Uint16 numRows,
+                                   Uint16 dimM, Uint16 dimK,
+                                   const Void* payload, Uint16 payloadBytes);
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_now
+ *
+ *  @desc   Reads the 64-bit time stamp counter.
+ *  ----------------------------------------------------------------------------
+ */
+static TSKMESSAGE_Cycles TSKMESSAGE_now(Void);
 
 /** ============================================================================
  *  @func   TSKMESSAGE_create
@@ -66,8 +236,10 @@ Int TSKMESSAGE_create(TSKMESSAGE_TransferInfo** infoPtr)
 {
     Int status = SYS_OK;
     MSGQ_Attrs msgqAttrs = MSGQ_ATTRS;
+    MSGQ_Attrs deferredAttrs = MSGQ_ATTRS;
+    SWI_Attrs swiAttrs = SWI_ATTRS;
     TSKMESSAGE_TransferInfo* info = NULL;
-    MSGQ_LocateAttrs syncLocateAttrs;
+    Uint16 i;
 
     /* Allocate TSKMESSAGE_TransferInfo structure that will be initialized
      * and passed to other phases of the application */
@@ -80,13 +252,62 @@ Int TSKMESSAGE_create(TSKMESSAGE_TransferInfo** infoPtr)
     else
     {
         info = *infoPtr;
-        info->matrixSize = matrixSize;
+        info->jobActive = FALSE;
+        info->jobQueue = MSGQ_INVALIDMSGQ;
+        info->jobTick = 0;
+        info->abandonedQueue = MSGQ_INVALIDMSGQ;
+        info->abandonedId = 0;
+        info->jobId = 0;
+        info->matrixSize = 0;
+        info->kernel = KERNEL_BASE;
+        info->kernelParam = 0;
+        info->accum = ACCUM_WRAP;
+        info->elemSize = sizeof(Uint16);
+        info->dimM = 0;
+        info->dimN = 0;
+        info->dimK = 0;
+        info->trans = 0;
+        info->alpha = 1;
+        info->heightA = 0;
+        info->widthA = 0;
+        info->heightB = 0;
+        info->widthB = 0;
+        info->sparseA = FALSE;
+        info->packed = FALSE;
+        info->rowsA = 0;
+        info->rowsB = 0;
+        info->residentQueue = MSGQ_INVALIDMSGQ;
+        info->residentId = 0;
+        info->residentRows = 0;
+        info->residentCols = 0;
+        info->residentLoaded = 0;
+        for (i = 0; i < TUNE_CLASSES; i++)
+            info->tuning[i] = 0;
+        info->cycles = 0;
+        info->cacheCycles = 0;
+        info->cacheBytes = 0;
+        info->statsStart = 0;
+        info->waitCycles = 0;
+        info->copyCycles = 0;
+        info->computeCycles = 0;
+        info->messages = 0;
+        info->heapPeak = 0;
+        info->poolSize = 0;
+        info->poolDepth = 0;
         info->localMsgq = MSGQ_INVALIDMSGQ;
-        info->locatedMsgq = MSGQ_INVALIDMSGQ;
+        info->deferredMsgq = MSGQ_INVALIDMSGQ;
+        info->deferredCount = 0;
+        info->echoSwi = NULL;
+        info->echoValue = 0;
     }
 
     if (status == SYS_OK)
     {
+        /* Start the free-running time stamp counter. Any write starts it;
+         * afterwards it is only read, and differences are taken modulo 2^32. */
+        TSCL = 0;
+        info->statsStart = TSKMESSAGE_now();
+
         /* Set the semaphore to a known state. */
         SEM_new(&(info->notifySemObj), 0);
 
@@ -108,27 +329,49 @@ Int TSKMESSAGE_create(TSKMESSAGE_TransferInfo** infoPtr)
             /* Set the message queue that will receive any async. errors. */
             MSGQ_setErrorHandler(info->localMsgq, SAMPLE_POOL_ID);
 
-            /* Synchronous locate.                           */
-            /* Wait for the initial startup message from GPP */
-            status = SYS_ENOTFOUND;
-            while ((status == SYS_ENOTFOUND) || (status == SYS_ENODEV))
+            /* Deferred requests are only taken when known to be there, so
+             * the queue needs neither a name nor a semaphore. */
+            status = MSGQ_open(NULL, &info->deferredMsgq, &deferredAttrs);
+            if (status != SYS_OK)
             {
-                syncLocateAttrs.timeout = SYS_FOREVER;
-                status = MSGQ_locate(GPP_MSGQNAME, &info->locatedMsgq, &syncLocateAttrs);
-                if ((status == SYS_ENOTFOUND) || (status == SYS_ENODEV))
-                {
-                    TSK_sleep(1000);
-                }
-                else if(status != SYS_OK)
-                {
+                SET_FAILURE_REASON(status);
+            }
+        }
+
+        if (status == SYS_OK)
+        {
+            /* Echo the events of the link benchmark. The callback runs in
+             * the interrupt of the IPS, so it hands them to a software
+             * interrupt. Without it the benchmark only covers MSGQ. */
+            swiAttrs.fxn = (SWI_Fxn) TSKMESSAGE_echoEvent;
+            swiAttrs.arg0 = (Arg) info;
+            info->echoSwi = SWI_create(&swiAttrs);
+            if ((info->echoSwi != NULL)
+                && (NOTIFY_register(ID_GPP, ECHO_IPS_ID, ECHO_EVENT_NO,
+                                    (FnNotifyCbck) TSKMESSAGE_echoNotify, info) != SYS_OK))
+            {
+                SWI_delete(info->echoSwi);
+                info->echoSwi = NULL;
+            }
 #if !defined (LOG_COMPONENT)
-                    LOG_printf(&trace, "MSGQ_locate (msgqOut) failed. Status = 0x%x\n", status);
+            if (info->echoSwi == NULL)
+            {
+                LOG_printf(&trace, "NOTIFY echo unavailable");
+            }
 #endif
-                }
+
+            /* Replies go to the source queue of each request, so the GPP
+             * queue does not have to be located. Tell the GPP that the DSP
+             * message queue can now be located. The GPP may not have
+             * registered for the event yet, so retry for a while. A lost
+             * notification only delays the GPP, which then polls. */
+            for (i = 0; i < READY_NOTIFY_RETRIES; i++)
+            {
+                if (NOTIFY_notify(ID_GPP, READY_IPS_ID, READY_EVENT_NO, 0) == SYS_OK)
+                    break;
+                TSK_sleep(1);
             }
         }
-       /* Initialize the sequenceNumber */
-        info->sequenceNumber = 0;
     }
 
     return status;
@@ -138,8 +381,27 @@ Int TSKMESSAGE_create(TSKMESSAGE_TransferInfo** infoPtr)
 /** ============================================================================
  *  @func   TSKMESSAGE_execute
  *
- *  @desc   Execute phase function for the TSKMESSAGE application. Application
- *          receives a message, verifies the id and executes the DSP processing.
+ *  @desc   Execute phase function for the TSKMESSAGE application. Serves
+ *          requests from any GPP process, replying to the source queue of
+ *          each message, until a CMD_SHUTDOWN message is received.
+ *
+ *          A job is the row blocks of the first operand followed by those
+ *          of the second. Operand messages are freed as soon as they are
+ *          copied, and the product is sent back in freshly allocated row
+ *          blocks once both operands are complete. Blocks of another job
+ *          arriving in the meantime, and requests that must wait for the
+ *          job, are deferred in order of arrival. Whenever no job is in
+ *          progress, the requests deferred so far are taken again once,
+ *          in that order, before any new one; those still waiting go back
+ *          in the same order.
+ *          Matrix-vector requests use storage of their own and are served
+ *          as they come, in between the blocks of a job, and so are echo
+ *          requests, which go back in their own buffer.
+ *          A job whose next block does not arrive within
+ *          JOB_TIMEOUT_TICKS is abandoned, so that a client that went away
+ *          in the middle of a job does not hold up the others. Either way
+ *          a job ends with the last block of its product or with a single
+ *          CMD_ERROR, in the order the jobs of a client were sent.
  *
  *  @modif  None.
  *  ============================================================================
@@ -147,168 +409,1233 @@ Int TSKMESSAGE_create(TSKMESSAGE_TransferInfo** infoPtr)
 Int TSKMESSAGE_execute(TSKMESSAGE_TransferInfo* info)
 {
     Int status = SYS_OK;
-    /* Two different types of message (see struct typedef for more info) */
+    Int jobStatus;
+    Bool running = TRUE;
     ControlMsgS* msgS;
-    ControlMsgL* msgL;
-    Uint8 i;
-    Uint8 j, k, l;
+    MSGQ_Queue replyQueue;
+    TSKMESSAGE_Cycles start;
+    Uint32 replay = 0;
+    Bool replayed;
+    Bool requeued = FALSE;
+    Uns waited;
+    Uns timeout;
 
-    /* Pointers to a matrix */
-    Uint16 (*matrixPtS)[MAXSIZE];
-    Uint32 (*matrixPtL)[MAXSIZE];
+    while (running && (status == SYS_OK))
+    {
+        if ((replay == 0) && !info->jobActive)
+        {
+            replay = info->deferredCount;
+            requeued = FALSE;
+        }
 
-    /* Cycle counters */
-    int start, stop, total;
+        /* Receive a deferred request, or else a message from the GPP */
+        replayed = (replay > 0);
+        if (replayed)
+        {
+            replay--;
+            info->deferredCount--;
+            status = MSGQ_get(info->deferredMsgq, (MSGQ_Msg*) &msgS, 0);
+        }
+        else
+        {
+            /* Wait no longer than the job in progress may */
+            timeout = SYS_FOREVER;
+            if (info->jobActive)
+            {
+                waited = TSK_time() - info->jobTick;
+                if (waited >= JOB_TIMEOUT_TICKS)
+                {
+                    TSKMESSAGE_abandonJob(info);
+                    continue;
+                }
+                timeout = JOB_TIMEOUT_TICKS - waited;
+            }
 
-    /* Allocate and send the message */
-    status = MSGQ_alloc(SAMPLE_POOL_ID, (MSGQ_Msg*) &msgS, APP_BUFFER_SIZE);
-    matrixPtS = msgS->arg2;
+            start = TSKMESSAGE_now();
+            status = MSGQ_get(info->localMsgq, (MSGQ_Msg*) &msgS, timeout);
+            info->waitCycles += TSKMESSAGE_now() - start;
+            if (status == SYS_ETIMEOUT)
+            {
+                status = SYS_OK;
+                continue;
+            }
+        }
+        if (status != SYS_OK)
+        {
+            SET_FAILURE_REASON(status);
+            break;
+        }
 
-    if (status == SYS_OK)
-    {
-        MSGQ_setMsgId((MSGQ_Msg) msgS, info->sequenceNumber);
-        MSGQ_setSrcQueue((MSGQ_Msg) msgS, info->localMsgq);
-        msgS->command = 0x01;
+        /* Check if the message is an asynchronous error message. A client
+         * that went away must not bring the service down. */
+        if (MSGQ_getMsgId((MSGQ_Msg) msgS) == MSGQ_ASYNCERRORMSGID)
+        {
+#if !defined (LOG_COMPONENT)
+            LOG_printf(&trace, "Transport error Type = %d",((MSGQ_AsyncErrorMsg *) msgS)->errorType);
+#endif
+            /* Must free the message */
+            MSGQ_free((MSGQ_Msg) msgS);
+            continue;
+        }
+
+        if (MSGQ_getSrcQueue((MSGQ_Msg) msgS, &replyQueue) != SYS_OK)
+        {
+#if !defined (LOG_COMPONENT)
+            LOG_printf(&trace, "Message without reply queue!");
+#endif
+            MSGQ_free((MSGQ_Msg) msgS);
+            continue;
+        }
+
+        if (!replayed)
+        {
+            info->messages++;
+        }
+
+        /* Once a request went back, a job ending in the middle of the
+         * pass must not let the later requests of its sender go first. */
+        if (replayed && requeued && !info->jobActive)
+        {
+            TSKMESSAGE_defer(info, msgS);
+            continue;
+        }
+
+        start = TSKMESSAGE_now();
+        switch (msgS->command)
+        {
+            case CMD_MATRIX_A:
+            case CMD_MATRIX_B:
+                jobStatus = TSKMESSAGE_storeOperand(info, msgS, replyQueue);
+                info->copyCycles += TSKMESSAGE_now() - start;
+                if (jobStatus == SYS_OK)
+                {
+                    info->jobTick = TSK_time();
+                }
+                else if (jobStatus != SYS_EBUSY)
+                {
+                    /* A job is rejected once: its later blocks are dropped */
+                    info->abandonedQueue = replyQueue;
+                    info->abandonedId = msgS->jobId;
+                }
+                break;
+
+            case CMD_LOAD_A:
+                jobStatus = TSKMESSAGE_storeResident(info, msgS, replyQueue);
+                info->copyCycles += TSKMESSAGE_now() - start;
+                break;
+
+            case CMD_VECTORS:
+                jobStatus = TSKMESSAGE_multiplyVectors(info, msgS, replyQueue);
+                info->computeCycles += TSKMESSAGE_now() - start;
+                break;
+
+            case CMD_TUNE:
+                jobStatus = TSKMESSAGE_storeTuning(info, msgS, replyQueue);
+                break;
+
+            case CMD_STATS:
+                jobStatus = TSKMESSAGE_reportStats(info, msgS, replyQueue);
+                break;
+
+            case CMD_POOL:
+                jobStatus = TSKMESSAGE_storePool(info, msgS, replyQueue);
+                break;
+
+            case CMD_BENCH:
+                jobStatus = TSKMESSAGE_runBench(info, msgS, replyQueue);
+                info->computeCycles += TSKMESSAGE_now() - start;
+                break;
+
+            case CMD_ECHO:
+                /* The message goes back itself: there is nothing to free. */
+                TSKMESSAGE_echo(info, msgS, replyQueue);
+                continue;
+
+            case CMD_SHUTDOWN:
+                running = FALSE;
+                jobStatus = SYS_OK;
+                break;
+
+            default:
+#if !defined (LOG_COMPONENT)
+                LOG_printf(&trace, "Unknown command 0x%x", msgS->command);
+#endif
+                jobStatus = SYS_EINVAL;
+                break;
+        }
+
+        if (jobStatus == SYS_EBUSY)
+        {
+            /* Another job is in progress: defer and let its blocks in. */
+            TSKMESSAGE_defer(info, msgS);
+            requeued = requeued || replayed;
+        }
+        else if (jobStatus != SYS_OK)
+        {
+            /* Reject the request on the message itself. The message id is
+             * echoed untouched so that the GPP can match the reply. A
+             * client that went away must not bring the service down. */
+            msgS->command = CMD_ERROR;
+            MSGQ_setSrcQueue((MSGQ_Msg) msgS, info->localMsgq);
+            if (MSGQ_put(replyQueue, (MSGQ_Msg) msgS) != SYS_OK)
+            {
+#if !defined (LOG_COMPONENT)
+                LOG_printf(&trace, "Rejection dropped");
+#endif
+                MSGQ_free((MSGQ_Msg) msgS);
+            }
+        }
+        else
+        {
+            MSGQ_free((MSGQ_Msg) msgS);
+
+            /* Both operands are complete: compute and send the product. */
+            if (info->jobActive
+                && (info->rowsA == info->heightA)
+                && (info->rowsB == info->heightB))
+            {
+                start = TSKMESSAGE_now();
+                TSKMESSAGE_sendResult(info);
+                info->computeCycles += TSKMESSAGE_now() - start;
+                info->jobActive = FALSE;
+            }
+        }
 
-        status = MSGQ_put(info->locatedMsgq, (MSGQ_Msg) msgS);
         if (status != SYS_OK)
         {
-            /* Must free the message */
-            MSGQ_free ((MSGQ_Msg) msgS);
             SET_FAILURE_REASON(status);
         }
     }
+
+    return status;
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storeOperand
+ *
+ *  @desc   Copies an operand row block into mat1 or mat2. 8-bit operands of
+ *          the base kernel are kept packed in mat1Packed or mat2Packed
+ *          instead; those of other kernels are widened. A first operand
+ *          sent in CSR form is kept in that form for the sparse kernel; a
+ *          second one is expanded. Delta-coded blocks are decoded as they
+ *          are stored, and generated ones computed. Operands of a GEMM job
+ *          are stored as sent, with rows of widthA or widthB elements. The
+ *          first block of the first operand starts a job; later blocks must
+ *          belong to the same job and follow each other. On an invalid
+ *          block the job is abandoned.
+ *
+ *  @modif  info
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storeOperand(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                   MSGQ_Queue replyQueue)
+{
+    Uint16 (*mat)[MAXSIZE];
+    Uint8 (*matPacked)[MAXSIZE];
+    Uint16* rowPtr = NULL;
+    Uint16* cols = NULL;
+    Uint16* values;
+    Uint8* bytes;
+    const Uint32* words;
+    Uint32 bitPos;
+    Uint32 shift;
+    Uint32 mask;
+    Uint32 code;
+    Uint16 value;
+    Uint16 expectedRow;
+    Uint16 height, width;
+    Uint16 base;
+    Uint16 j, k, p;
+
+    if (!info->jobActive)
+    {
+        /* Only the first block of a job can start it. The client of an
+         * abandoned job was told once: its late blocks are dropped. */
+        if ((msgS->command != CMD_MATRIX_A) || (msgS->rowStart != 0))
+        {
+            if ((replyQueue == info->abandonedQueue) && (msgS->jobId == info->abandonedId))
+                return SYS_OK;
+            return SYS_EINVAL;
+        }
+        if (msgS->kernel == KERNEL_GEMM)
+        {
+            if ((msgS->dimM == 0) || (msgS->dimM > MAXSIZE)
+                || (msgS->dimN == 0) || (msgS->dimN > MAXSIZE)
+                || (msgS->dimK == 0) || (msgS->dimK > MAXSIZE)
+                || (msgS->trans > (TRANS_A | TRANS_B))
+                || (msgS->accum != ACCUM_WRAP) || (msgS->elemSize != sizeof(Uint16))
+                || (msgS->format != FORMAT_DENSE))
+            {
+                return SYS_EINVAL;
+            }
+        }
+        else if ((msgS->matrixSize == 0) || (msgS->matrixSize > MAXSIZE))
+        {
+            return SYS_EINVAL;
+        }
+        if (((msgS->kernel != KERNEL_BASE) || !MATMULT_VARIANT_VALID(msgS->kernelParam))
+            && (msgS->kernel != KERNEL_GEMM)
+            && ((msgS->kernel != KERNEL_STRASSEN) || (msgS->kernelParam < MATMULT_MIN_CUTOFF)))
+        {
+            return SYS_EINVAL;
+        }
+        if ((msgS->accum != ACCUM_WRAP) && (msgS->accum != ACCUM_CHECKED))
+        {
+            return SYS_EINVAL;
+        }
+        if ((msgS->elemSize != sizeof(Uint8)) && (msgS->elemSize != sizeof(Uint16)))
+        {
+            return SYS_EINVAL;
+        }
+
+        info->jobActive = TRUE;
+        info->jobQueue = replyQueue;
+        info->jobId = msgS->jobId;
+        if (replyQueue == info->abandonedQueue)
+            info->abandonedQueue = MSGQ_INVALIDMSGQ;
+        info->matrixSize = msgS->matrixSize;
+        info->kernel = msgS->kernel;
+        info->kernelParam = msgS->kernelParam;
+        info->accum = msgS->accum;
+        info->elemSize = msgS->elemSize;
+        if (msgS->kernel == KERNEL_GEMM)
+        {
+            info->dimM = msgS->dimM;
+            info->dimN = msgS->dimN;
+            info->dimK = msgS->dimK;
+            info->trans = msgS->trans;
+            info->alpha = msgS->alpha;
+        }
+        else
+        {
+            info->dimM = msgS->matrixSize;
+            info->dimN = msgS->matrixSize;
+            info->dimK = msgS->matrixSize;
+            info->trans = 0;
+            info->alpha = 1;
+        }
+        info->heightA = (info->trans & TRANS_A) ? info->dimK : info->dimM;
+        info->widthA = (info->trans & TRANS_A) ? info->dimM : info->dimK;
+        info->heightB = (info->trans & TRANS_B) ? info->dimN : info->dimK;
+        info->widthB = (info->trans & TRANS_B) ? info->dimK : info->dimN;
+        info->sparseA = (msgS->format == FORMAT_CSR);
+        info->packed = (msgS->elemSize == sizeof(Uint8)) && (msgS->kernel == KERNEL_BASE)
+                       && !info->sparseA;
+        info->rowsA = 0;
+        info->rowsB = 0;
+        info->cycles = 0;
+        info->cacheCycles = 0;
+        info->cacheBytes = 0;
+        matSparseRowPtr[0] = 0;
+    }
+    else if ((replyQueue != info->jobQueue) || (msgS->jobId != info->jobId))
+    {
+        return SYS_EBUSY;
+    }
+
+    if (msgS->command == CMD_MATRIX_A)
+    {
+        mat = mat1;
+        matPacked = mat1Packed;
+        expectedRow = info->rowsA;
+        height = info->heightA;
+        width = info->widthA;
+    }
     else
     {
-        SET_FAILURE_REASON(status);
+        mat = mat2;
+        matPacked = mat2Packed;
+        expectedRow = (info->rowsA == info->heightA) ? info->rowsB : 0xFFFF;
+        height = info->heightB;
+        width = info->widthB;
     }
 
-    /* Execute the loop to receive the two matrices and send back the result */
-    for (i = 0; ( (i < 2) && (status == SYS_OK) ); i++)
+    if ((msgS->matrixSize != info->matrixSize) || (msgS->elemSize != info->elemSize)
+        || (msgS->rowStart != expectedRow)
+        || (msgS->numRows == 0) || (msgS->numRows > height - msgS->rowStart)
+        || ((msgS->format != FORMAT_DENSE) && (msgS->format != FORMAT_CSR)
+            && (msgS->format != FORMAT_DELTA) && (msgS->format != FORMAT_GENERATED))
+        || ((msgS->format == FORMAT_DELTA) && (msgS->nnz > DELTA_MAX_BITS))
+        || ((msgS->format == FORMAT_GENERATED)
+            && (((const GenSpec*) msgS->arg2)->kind > GEN_RANDOM))
+        || ((info->kernel == KERNEL_GEMM) && (msgS->format != FORMAT_DENSE))
+        || ((msgS->command == CMD_MATRIX_A) && ((msgS->format == FORMAT_CSR) != info->sparseA)))
     {
-        /* Receive a message from the GPP */
-        status = MSGQ_get(info->localMsgq,(MSGQ_Msg*) &msgS, SYS_FOREVER);
-        if (status == SYS_OK)
+        info->jobActive = FALSE;
+        return SYS_EINVAL;
+    }
+
+    /* Locate the parts of a sparse block and check its structure */
+    if (msgS->format == FORMAT_CSR)
+    {
+        rowPtr = msgS->arg2;
+        cols = rowPtr + msgS->numRows + 1;
+        if ((rowPtr[0] != 0) || (rowPtr[msgS->numRows] != msgS->nnz)
+            || (msgS->nnz > msgS->numRows * width))
+        {
+            info->jobActive = FALSE;
+            return SYS_EINVAL;
+        }
+        for (j = 0; j < msgS->numRows; j++)
         {
-            /* Check if the message is an asynchronous error message */
-            if (MSGQ_getMsgId((MSGQ_Msg) msgS) == MSGQ_ASYNCERRORMSGID)
+            if ((rowPtr[j + 1] < rowPtr[j]) || (rowPtr[j + 1] - rowPtr[j] > width))
             {
-#if !defined (LOG_COMPONENT)
-                LOG_printf(&trace, "Transport error Type = %d",((MSGQ_AsyncErrorMsg *) msgS)->errorType);
-#endif
-                /* Must free the message */
-                MSGQ_free((MSGQ_Msg) msgS);
-                status = SYS_EBADIO;
-                SET_FAILURE_REASON(status);
+                info->jobActive = FALSE;
+                return SYS_EINVAL;
             }
-            /* Check if the message received has the correct sequence number */
-            else if (MSGQ_getMsgId ((MSGQ_Msg) msgS) != info->sequenceNumber)
+        }
+        for (p = 0; p < msgS->nnz; p++)
+        {
+            if (cols[p] >= width)
             {
-#if !defined (LOG_COMPONENT)
-                LOG_printf(&trace, "Out of sequence message!");
-#endif
-                MSGQ_free((MSGQ_Msg) msgS);
-                status = SYS_EBADIO;
-                SET_FAILURE_REASON(status);
+                info->jobActive = FALSE;
+                return SYS_EINVAL;
             }
-            else
-            {
-
-		/* Include your control flag or processing code here */
-
-                /* Increment the sequenceNumber for next received message */
-                info->sequenceNumber++;
-                /* Make sure that sequenceNumber stays within the range of iterations */
-                if (info->sequenceNumber == MSGQ_INTERNALIDSSTART)
-                    info->sequenceNumber = 0;
-                MSGQ_setMsgId((MSGQ_Msg) msgS, info->sequenceNumber);
-                MSGQ_setSrcQueue((MSGQ_Msg) msgS, info->localMsgq);
+        }
+        values = cols + msgS->nnz;
+    }
+    else
+    {
+        values = msgS->arg2;
+    }
+    bytes = (Uint8*) values;
 
-                if (i == 0) 
-                {
-                    /* Store first matrix */
-                    for (j=0; j<matrixSize; j++)
-                        for (k=0; k<matrixSize; k++)
-                            mat1[j][k] = matrixPtS[j][k];
-                    msgS->command = 0x02;
-
-                    /* Send the ACK back to the GPP */
-                    status = MSGQ_put(info->locatedMsgq,(MSGQ_Msg) msgS);
-                    if (status != SYS_OK)
-                        SET_FAILURE_REASON(status);
-                }
+    /* Store the rows: a sparse first operand as it is, anything else
+     * dense, packed or widened to 16 bits */
+    if ((msgS->command == CMD_MATRIX_A) && info->sparseA)
+    {
+        base = matSparseRowPtr[msgS->rowStart];
+        for (j = 0; j < msgS->numRows; j++)
+            matSparseRowPtr[msgS->rowStart + j + 1] = base + rowPtr[j + 1];
+        for (p = 0; p < msgS->nnz; p++)
+        {
+            matSparseCol[base + p] = cols[p];
+            matSparseVal[base + p] = (info->elemSize == sizeof(Uint16)) ? values[p] : bytes[p];
+        }
+    }
+    else if (msgS->format == FORMAT_CSR)
+    {
+        for (j = 0; j < msgS->numRows; j++)
+        {
+            for (k = 0; k < width; k++)
+            {
+                if (info->packed)
+                    matPacked[msgS->rowStart + j][k] = 0;
+                else
+                    mat[msgS->rowStart + j][k] = 0;
+            }
+            for (p = rowPtr[j]; p < rowPtr[j + 1]; p++)
+            {
+                if (info->packed)
+                    matPacked[msgS->rowStart + j][cols[p]] = bytes[p];
+                else if (info->elemSize == sizeof(Uint16))
+                    mat[msgS->rowStart + j][cols[p]] = values[p];
                 else
+                    mat[msgS->rowStart + j][cols[p]] = bytes[p];
+            }
+        }
+    }
+    else if (msgS->format == FORMAT_GENERATED)
+    {
+        TSKMESSAGE_generateRows(info, (const GenSpec*) msgS->arg2, msgS->rowStart,
+                                msgS->numRows, width, mat, matPacked);
+    }
+    else if (msgS->format == FORMAT_DELTA)
+    {
+        /* values holds the row heads, then come the packed deltas */
+        words = (const Uint32*) (values + CTRLMSG_DELTA_HEADS(msgS->numRows));
+        mask = (1 << msgS->nnz) - 1;
+        bitPos = 0;
+        for (j = 0; j < msgS->numRows; j++)
+        {
+            value = values[j];
+            for (k = 0; k < width; k++)
+            {
+                if ((k != 0) && (msgS->nnz != 0))
                 {
-                    /* Store second matrix */
-                    for (j=0; j < matrixSize; j++)
-                        for (k=0; k < matrixSize; k++)
-                            mat2[j][k] = matrixPtS[j][k];
-                    msgS->command = 0x02;
-
-                    /* Free the message and allocate a new one */
-                    MSGQ_free((MSGQ_Msg) msgS);
-                    status = MSGQ_alloc(SAMPLE_POOL_ID, (MSGQ_Msg*) &msgL, APP_BUFFER_SIZE);
-                    matrixPtL = msgL->arg2;
-
-                    if (status == SYS_OK) {
-                        MSGQ_setMsgId((MSGQ_Msg) msgL, info->sequenceNumber);
-                        MSGQ_setSrcQueue((MSGQ_Msg) msgL, info->localMsgq);
-
-                        /* Compute the product and time the computation */
-                        TSCL = 0;
-                        start = TSCL;
-			#pragma UNROLL(4)
-                        for (j = 0; (j < matrixSize) && (j < MAXSIZE/2); j++)
-                            for (k = 0; k < matrixSize; k++)
-                            {
-                                matrixPtL[j][k] = 0;
-                                for(l = 0; l < matrixSize; l++)
-                                    matrixPtL[j][k] = matrixPtL[j][k] + 
-                                                      ((Uint32)mat1[j][l]) * ((Uint32)mat2[l][k]);
-                            }
-                        stop = TSCL;
-                        total += stop - start;
-                        start = TSCL;
-
-                        /* Send the first half of the result back to the GPP */
-                        status = MSGQ_put(info->locatedMsgq,(MSGQ_Msg) msgL);
-                        if (status != SYS_OK)
-                            SET_FAILURE_REASON(status);
-
-                        status = MSGQ_get(info->localMsgq,(MSGQ_Msg*) &msgL, SYS_FOREVER);
-                        MSGQ_setMsgId((MSGQ_Msg) msgL, info->sequenceNumber);
-                        MSGQ_setSrcQueue((MSGQ_Msg) msgL, info->localMsgq);
-
-                        for (j = MAXSIZE/2; j < matrixSize; j++)
-                            for (k = 0; k < matrixSize; k++)
-                            {
-                                matrixPtL[j-MAXSIZE/2][k] = 0;
-                                for(l = 0; l < matrixSize; l++)
-                                    matrixPtL[j-MAXSIZE/2][k] = matrixPtL[j-MAXSIZE/2][k] + 
-                                                                ((Uint32)mat1[j][l]) * ((Uint32)mat2[l][k]);
-                            }
-                        stop = TSCL;
-                        total += stop - start;
-                        msgS->arg1 = total;
-
-                        /* Send the second half of the result back to the GPP */
-                        status = MSGQ_put(info->locatedMsgq,(MSGQ_Msg) msgL);
-                        if (status != SYS_OK)
-                            SET_FAILURE_REASON(status);
-                    }        
+                    shift = bitPos & 31;
+                    code = words[bitPos >> 5] >> shift;
+                    if (shift + msgS->nnz > 32)
+                        code |= words[(bitPos >> 5) + 1] << (32 - shift);
+                    code &= mask;
+                    bitPos += msgS->nnz;
+                    value += (Uint16) ((code >> 1) ^ ((code & 1) ? 0xFFFF : 0));
                 }
+                if (info->packed)
+                    matPacked[msgS->rowStart + j][k] = (Uint8) value;
+                else
+                    mat[msgS->rowStart + j][k] = value;
+            }
+        }
+    }
+    else if (info->elemSize == sizeof(Uint16))
+    {
+        for (j = 0; j < msgS->numRows; j++)
+            for (k = 0; k < width; k++)
+                mat[msgS->rowStart + j][k] = values[j * width + k];
+    }
+    else if (info->packed)
+    {
+        for (j = 0; j < msgS->numRows; j++)
+            for (k = 0; k < width; k++)
+                matPacked[msgS->rowStart + j][k] = bytes[j * width + k];
+    }
+    else
+    {
+        for (j = 0; j < msgS->numRows; j++)
+            for (k = 0; k < width; k++)
+                mat[msgS->rowStart + j][k] = bytes[j * width + k];
+    }
+
+    if (msgS->command == CMD_MATRIX_A)
+        info->rowsA += msgS->numRows;
+    else
+        info->rowsB += msgS->numRows;
+
+    /* The transport invalidated the message when it was received */
+    info->cacheBytes += CTRLMSG_SIZE((msgS->format == FORMAT_CSR)
+                                     ? CTRLMSG_CSR_BYTES(msgS->numRows, msgS->nnz, info->elemSize)
+                                     : (msgS->format == FORMAT_DELTA)
+                                     ? CTRLMSG_DELTA_BYTES(msgS->numRows, width, msgS->nnz)
+                                     : (msgS->format == FORMAT_GENERATED)
+                                     ? sizeof(GenSpec)
+                                     : msgS->numRows * width * info->elemSize);
+
+    return SYS_OK;
+}
 
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_generateRows
+ *
+ *  @desc   Computes rows rowStart to rowStart + numRows - 1 of a generated
+ *          operand, width elements each, into mat, or into matPacked for a
+ *          packed job. Elements are reduced to the element size of the job,
+ *          as the GPP does when it generates the same operand. A random
+ *          operand is drawn from the first row of the block on.
+ *
+ *  @modif  mat, matPacked
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_generateRows(TSKMESSAGE_TransferInfo* info, const GenSpec* spec,
+                                    Uint16 rowStart, Uint16 numRows, Uint16 width,
+                                    Uint16 (*mat)[MAXSIZE], Uint8 (*matPacked)[MAXSIZE])
+{
+    Uint16 mask = (info->elemSize == sizeof(Uint8)) ? 0xFF : 0xFFFF;
+    Uint32 state = spec->seed;
+    Uint16 value;
+    Uint16 j, k;
+
+    for (j = rowStart; j < rowStart + numRows; j++)
+    {
+        for (k = 0; k < width; k++)
+        {
+            switch (spec->kind)
+            {
+                case GEN_CONSTANT:
+                    value = spec->base;
+                    break;
+
+                case GEN_IDENTITY:
+                    value = (j == k) ? spec->base : 0;
+                    break;
+
+                case GEN_BANDED:
+                    value = ((j > k + spec->band) || (k > j + spec->band)) ? 0
+                            : (Uint16) (spec->base + spec->rowStep * j + spec->colStep * k);
+                    break;
+
+                case GEN_RANDOM:
+                    state = GEN_LCG_NEXT(state);
+                    value = (Uint16) (state >> 16);
+                    break;
+
+                default:
+                    value = (Uint16) (spec->base + spec->rowStep * j + spec->colStep * k);
+                    break;
             }
+            if (info->packed)
+                matPacked[j][k] = (Uint8) value;
+            else
+                mat[j][k] = value & mask;
+        }
+    }
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_sendResult
+ *
+ *  @desc   Computes the product of the job in progress and sends it back in
+ *          row blocks. A checked job whose product may exceed 32 bits is
+ *          computed with the wide kernel and sent with 64-bit elements;
+ *          otherwise the job runs its own kernel at 32-bit speed, or the
+ *          sparse kernel when the first operand came in CSR form. A GEMM
+ *          job gives a dimM x dimN product. Products of 8-bit operands
+ *          never need 64 bits. Allocation is retried while the GPP still
+ *          holds earlier results. A block that cannot be allocated or
+ *          delivered, as when the client went away, drops the rest of the
+ *          job. Each block is written back explicitly and only over the
+ *          bytes that were written, which is also all the transport
+ *          maintains as the block is allocated with the size it needs.
+ *
+ *  @modif  info
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_sendResult(TSKMESSAGE_TransferInfo* info)
+{
+    Int status = SYS_OK;
+    ControlMsgL* msgL;
+    Bool narrow = TRUE;
+    Uint16 elemSize;
+    Uint16 blockRows;
+    Uint16 numRows;
+    Uint16 msgSize;
+    Uint32 start;
+    Uint16 j;
+
+    if ((info->accum == ACCUM_CHECKED) && (info->elemSize == sizeof(Uint16)))
+    {
+        if (info->sparseA)
+            info->cycles += MATMULT_checkRangeSparse(info->matrixSize, &narrow);
+        else
+            info->cycles += MATMULT_checkRange(info->matrixSize, &narrow);
+    }
+
+    /* The wide kernel is dense */
+    if (!narrow && info->sparseA)
+    {
+        info->cycles += MATMULT_expandSparse(info->matrixSize);
+    }
+
+    elemSize = narrow ? sizeof(Uint32) : 2 * sizeof(Uint32);
+    blockRows = CTRLMSG_ROW_BLOCK_ROWS(info->dimM, info->dimN, elemSize);
+
+    for (j = 0; (j < info->dimM) && (status == SYS_OK); j += numRows)
+    {
+        numRows = (info->dimM - j < blockRows) ? (info->dimM - j) : blockRows;
+        msgSize = CTRLMSG_SIZE(numRows * info->dimN * elemSize);
+
+        status = TSKMESSAGE_allocReply(msgSize, (MSGQ_Msg*) &msgL);
+        if (status != SYS_OK)
+        {
+            break;
         }
+
+        /* Compute the product and time the computation */
+        if (info->kernel == KERNEL_GEMM)
+            info->cycles += MATMULT_gemm(msgL->arg2, info->dimN, info->dimK,
+                                         (info->trans & TRANS_A) != 0,
+                                         (info->trans & TRANS_B) != 0,
+                                         info->alpha, j, j + numRows);
+        else if (!narrow)
+            info->cycles += MATMULT_multiplyWide(msgL->arg2, info->matrixSize, j, j + numRows);
+        else if (info->sparseA)
+            info->cycles += MATMULT_multiplySparse(msgL->arg2, info->matrixSize, j, j + numRows);
+        else if (info->packed)
+            info->cycles += MATMULT_multiplyPacked(msgL->arg2, info->matrixSize, j, j + numRows);
+        else if (info->kernel == KERNEL_STRASSEN)
+            info->cycles += MATMULT_multiplyStrassen(msgL->arg2, info->matrixSize, j, j + numRows,
+                                                     info->kernelParam);
         else
+            info->cycles += MATMULT_multiplyVariant(msgL->arg2, info->matrixSize, j, j + numRows,
+                                                    (info->kernelParam != 0) ? info->kernelParam
+                                                    : info->tuning[TUNE_CLASS(info->matrixSize)]);
+
+        msgL->command = CMD_RESULT;
+        msgL->matrixSize = info->matrixSize;
+        msgL->jobId = info->jobId;
+        msgL->rowStart = j;
+        msgL->numRows = numRows;
+        msgL->dspConfig = DSPCONFIG(MEMPROFILE, L2CACHE_KB);
+        msgL->kernel = (narrow && !info->sparseA) ? info->kernel : KERNEL_BASE;
+        msgL->kernelParam = (narrow && !info->sparseA) ? info->kernelParam : 0;
+        msgL->accum = info->accum;
+        msgL->elemSize = elemSize;
+        msgL->format = (narrow && info->sparseA) ? FORMAT_CSR : FORMAT_DENSE;
+        msgL->nnz = 0;
+        msgL->dimM = info->dimM;
+        msgL->dimN = info->dimN;
+        msgL->dimK = info->dimK;
+        msgL->trans = info->trans;
+        msgL->alpha = info->alpha;
+        msgL->arg1 = info->cycles;
+        MSGQ_setMsgId((MSGQ_Msg) msgL, info->jobId);
+        MSGQ_setSrcQueue((MSGQ_Msg) msgL, info->localMsgq);
+
+        /* Write back the block while it is still hot in the cache. The
+         * statistics are filled in afterwards and go out with the writeback
+         * the transport does on put. */
+        start = TSCL;
+        BCACHE_wb((Ptr) msgL, msgSize, TRUE);
+        info->cacheCycles += TSCL - start;
+        info->cacheBytes += msgSize;
+        msgL->cacheCycles = info->cacheCycles;
+        msgL->cacheBytes = info->cacheBytes;
+
+        /* Send the row block back to the GPP */
+        status = MSGQ_put(info->jobQueue, (MSGQ_Msg) msgL);
+        if (status != SYS_OK)
+        {
+            /* Must free the message */
+            MSGQ_free((MSGQ_Msg) msgL);
+        }
+    }
+
+#if !defined (LOG_COMPONENT)
+    if (status != SYS_OK)
+    {
+        LOG_printf(&trace, "Result of job %d dropped", info->jobId);
+    }
+#endif
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storeResident
+ *
+ *  @desc   Copies a row block of the resident matrix into matResident. The
+ *          first block of a load replaces the resident matrix and makes
+ *          the sender its owner; later blocks must follow it. The last
+ *          block is acknowledged with a header-only CMD_LOADED message.
+ *          An invalid block from the owner abandons the load.
+ *
+ *  @modif  info
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storeResident(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                    MSGQ_Queue replyQueue)
+{
+    Int status = SYS_OK;
+    Uint16 j, k;
+
+    if ((msgS->rowStart == 0)
+        && (msgS->dimM != 0) && (msgS->dimM <= MAXSIZE)
+        && (msgS->dimK != 0) && (msgS->dimK <= MAXSIZE))
+    {
+        info->residentQueue = replyQueue;
+        info->residentId = msgS->jobId;
+        info->residentRows = msgS->dimM;
+        info->residentCols = msgS->dimK;
+        info->residentLoaded = 0;
+    }
+
+    if ((replyQueue != info->residentQueue) || (msgS->jobId != info->residentId)
+        || (msgS->dimM != info->residentRows) || (msgS->dimK != info->residentCols)
+        || (msgS->elemSize != sizeof(Uint16)) || (msgS->format != FORMAT_DENSE)
+        || (msgS->rowStart != info->residentLoaded)
+        || (msgS->numRows == 0) || (msgS->numRows > info->residentRows - msgS->rowStart))
+    {
+        if (replyQueue == info->residentQueue)
+            info->residentLoaded = 0;
+        return SYS_EINVAL;
+    }
+
+    for (j = 0; j < msgS->numRows; j++)
+        for (k = 0; k < info->residentCols; k++)
+            matResident[msgS->rowStart + j][k] = msgS->arg2[j * info->residentCols + k];
+    info->residentLoaded += msgS->numRows;
+
+    if (info->residentLoaded == info->residentRows)
+    {
+        TSKMESSAGE_acknowledge(info, replyQueue, CMD_LOADED, info->residentId,
+                               info->residentRows, info->residentRows, info->residentCols,
+                               NULL, 0);
+    }
+
+    return status;
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storeTuning
+ *
+ *  @desc   Replaces the tuning table with the one in the message, once all
+ *          its variants are known to be valid, and acknowledges it. Jobs
+ *          already received keep the variant they were given.
+ *
+ *  @modif  info->tuning
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storeTuning(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                  MSGQ_Queue replyQueue)
+{
+    Uint16 c;
+
+    if ((msgS->numRows != TUNE_CLASSES) || (msgS->elemSize != sizeof(Uint16)))
+    {
+        return SYS_EINVAL;
+    }
+    for (c = 0; c < TUNE_CLASSES; c++)
+    {
+        if (!MATMULT_VARIANT_VALID(msgS->arg2[c]))
+            return SYS_EINVAL;
+    }
+
+    for (c = 0; c < TUNE_CLASSES; c++)
+        info->tuning[c] = msgS->arg2[c];
+
+    TSKMESSAGE_acknowledge(info, replyQueue, CMD_TUNED, msgS->jobId, TUNE_CLASSES, 0, 0,
+                           NULL, 0);
+
+    return SYS_OK;
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_reportStats
+ *
+ *  @desc   Replies to a CMD_STATS message with the statistics of the DSP
+ *          so far, see DspStats. The heap and the stack are sampled as the
+ *          report is made.
+ *
+ *  @modif  info
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_reportStats(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                  MSGQ_Queue replyQueue)
+{
+    DspStats stats;
+    MEM_Stat memStat;
+    TSK_Stat tskStat;
+    TSKMESSAGE_Cycles now = TSKMESSAGE_now();
+
+    CYCLES_TO_WORDS(stats.elapsedCycles, now - info->statsStart);
+    CYCLES_TO_WORDS(stats.waitCycles, info->waitCycles);
+    CYCLES_TO_WORDS(stats.copyCycles, info->copyCycles);
+    CYCLES_TO_WORDS(stats.computeCycles, info->computeCycles);
+    stats.messages = info->messages;
+
+    if (!MEM_stat(DSPLINK_SEGID, &memStat))
+    {
+        memStat.size = 0;
+        memStat.used = 0;
+        memStat.length = 0;
+    }
+    if (memStat.used > info->heapPeak)
+        info->heapPeak = memStat.used;
+    stats.heapSize = memStat.size;
+    stats.heapUsed = memStat.used;
+    stats.heapPeak = info->heapPeak;
+    stats.heapLargestFree = memStat.length;
+
+    TSK_stat(TSK_self(), &tskStat);
+    stats.stackSize = tskStat.attrs.stacksize;
+    stats.stackUsed = tskStat.used;
+    stats.poolSize = info->poolSize;
+    stats.poolDepth = info->poolDepth;
+
+    TSKMESSAGE_acknowledge(info, replyQueue, CMD_STATS_REPORT, msgS->jobId, 1, 0, 0,
+                           &stats, sizeof(DspStats));
+
+    return SYS_OK;
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_storePool
+ *
+ *  @desc   Records the largest job size and the number of such jobs the
+ *          message pool was sized for, so that processes attaching later
+ *          can find them in the statistics, and replies with those.
+ *
+ *  @modif  info->poolSize, info->poolDepth
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_storePool(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                MSGQ_Queue replyQueue)
+{
+    if ((msgS->matrixSize == 0) || (msgS->matrixSize > ARG2_SIZE) || (msgS->kernelParam == 0))
+    {
+        return SYS_EINVAL;
+    }
+
+    info->poolSize = msgS->matrixSize;
+    info->poolDepth = msgS->kernelParam;
+
+    return TSKMESSAGE_reportStats(info, msgS, replyQueue);
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_runBench
+ *
+ *  @desc   Replies to a CMD_BENCH message with a CMD_BENCH_REPORT of
+ *          BENCH_ENTRIES BenchEntry, see helloDSP_config.h. Each kernel is
+ *          run once after the caches are written back and invalidated and
+ *          once more right after. The benchmark operands overwrite mat1 and
+ *          mat2, so the request waits while a job is in progress.
+ *
+ *  @modif  mat1, mat2, benchTable
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_runBench(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                               MSGQ_Queue replyQueue)
+{
+    static BenchEntry benchTable[BENCH_ENTRIES];
+    BenchEntry* entry = benchTable;
+    TSKMESSAGE_Cycles start;
+    Uint16 matrixSize;
+    Uint16 i;
+    Uint16 kernel;
+    Uint16 warm;
+
+    if (info->jobActive)
+    {
+        return SYS_EBUSY;
+    }
+
+    for (i = 0; i < BENCH_SIZES; i++)
+    {
+        matrixSize = BENCH_SIZE(i);
+        MATMULT_benchOperands(matrixSize);
+        for (kernel = 0; kernel < BENCH_KERNELS; kernel++)
         {
-            SET_FAILURE_REASON (status);
+            BCACHE_wbInvAll();
+            for (warm = 0; warm < 2; warm++, entry++)
+            {
+                start = TSKMESSAGE_now();
+                MATMULT_bench(kernel, matrixSize);
+                CYCLES_TO_WORDS(entry->cycles, TSKMESSAGE_now() - start);
+                entry->kernel = kernel;
+                entry->matrixSize = matrixSize;
+                entry->warm = warm;
+                entry->reserved = 0;
+            }
         }
     }
+
+    TSKMESSAGE_acknowledge(info, replyQueue, CMD_BENCH_REPORT, msgS->jobId, BENCH_ENTRIES,
+                           0, 0, benchTable, sizeof(benchTable));
+
+    return SYS_OK;
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_echo
+ *
+ *  @desc   Sends a CMD_ECHO message back to its sender as CMD_ECHOED, in
+ *          the same buffer. With ECHO_TOUCH, the payload is complemented
+ *          and the message written back first, and both steps are timed
+ *          into the reply. A reply that cannot be delivered is dropped.
+ *
+ *  @modif  msgS
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_echo(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                            MSGQ_Queue replyQueue)
+{
+    Uint32 msgSize = MSGQ_getMsgSize((MSGQ_Msg) msgS);
+    Uint32* words = (Uint32*) msgS->arg2;
+    Uint32 start;
+    Uint32 i;
+
+    msgS->arg1 = 0;
+    msgS->cacheCycles = 0;
+    msgS->cacheBytes = 0;
+    if (msgS->kernelParam & ECHO_TOUCH)
+    {
+        /* The transport invalidated the message when it was received */
+        start = TSCL;
+        for (i = 0; i < (msgSize - CTRLMSG_HDR_SIZE) / sizeof(Uint32); i++)
+            words[i] = ~words[i];
+        msgS->arg1 = TSCL - start;
+
+        start = TSCL;
+        BCACHE_wb((Ptr) msgS, msgSize, TRUE);
+        msgS->cacheCycles = TSCL - start;
+        msgS->cacheBytes = msgSize;
+    }
+
+    msgS->command = CMD_ECHOED;
+    msgS->dspConfig = DSPCONFIG(MEMPROFILE, L2CACHE_KB);
+    MSGQ_setSrcQueue((MSGQ_Msg) msgS, info->localMsgq);
+
+    /* A client that went away must not bring the service down */
+    if (MSGQ_put(replyQueue, (MSGQ_Msg) msgS) != SYS_OK)
+    {
+#if !defined (LOG_COMPONENT)
+        LOG_printf(&trace, "Echo dropped");
+#endif
+        MSGQ_free((MSGQ_Msg) msgS);
+    }
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_echoNotify
+ *
+ *  @desc   Keeps the payload of a link benchmark event and posts the
+ *          software interrupt that notifies it back. The GPP waits for each
+ *          echo before sending the next event.
+ *
+ *  @modif  info->echoValue
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_echoNotify(Uint32 eventNo, Ptr arg, Ptr info)
+{
+    TSKMESSAGE_TransferInfo* transferInfo = (TSKMESSAGE_TransferInfo*) arg;
+    (Void) eventNo;
+
+    transferInfo->echoValue = (Uint32) info;
+    SWI_post(transferInfo->echoSwi);
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_echoEvent
+ *
+ *  @desc   Notifies the last link benchmark event back to the GPP.
+ *
+ *  @modif  None
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_echoEvent(Arg arg0, Arg arg1)
+{
+    TSKMESSAGE_TransferInfo* info = (TSKMESSAGE_TransferInfo*) arg0;
+    (Void) arg1;
+
+    NOTIFY_notify(ID_GPP, ECHO_IPS_ID, ECHO_EVENT_NO, info->echoValue);
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_acknowledge
+ *
+ *  @desc   Sends a reply with the given command, waiting for the pool
+ *          like result blocks. The reply carries payloadBytes copied from
+ *          payload, none for a header-only acknowledgement. A reply that
+ *          cannot be allocated or delivered is dropped.
+ *
+ *  @modif  None
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_acknowledge(TSKMESSAGE_TransferInfo* info, MSGQ_Queue replyQueue,
+                                   Uint16 command, Uint16 jobId, Uint16 numRows,
+                                   Uint16 dimM, Uint16 dimK,
+                                   const Void* payload, Uint16 payloadBytes)
+{
+    ControlMsgS* ack;
+    Uint16 i;
+
+    if (TSKMESSAGE_allocReply(CTRLMSG_SIZE(payloadBytes), (MSGQ_Msg*) &ack) != SYS_OK)
+    {
+#if !defined (LOG_COMPONENT)
+        LOG_printf(&trace, "Acknowledgement 0x%x dropped", command);
+#endif
+        return;
+    }
+
+    ack->command = command;
+    ack->matrixSize = 0;
+    ack->jobId = jobId;
+    ack->rowStart = 0;
+    ack->numRows = numRows;
+    ack->dspConfig = DSPCONFIG(MEMPROFILE, L2CACHE_KB);
+    ack->kernel = KERNEL_BASE;
+    ack->kernelParam = 0;
+    ack->accum = ACCUM_WRAP;
+    ack->elemSize = sizeof(Uint16);
+    ack->format = FORMAT_DENSE;
+    ack->nnz = 0;
+    ack->dimM = dimM;
+    ack->dimN = 0;
+    ack->dimK = dimK;
+    ack->trans = 0;
+    ack->alpha = 1;
+    ack->arg1 = 0;
+    ack->cacheCycles = 0;
+    ack->cacheBytes = 0;
+    for (i = 0; i < payloadBytes / sizeof(Uint16); i++)
+        ack->arg2[i] = ((const Uint16*) payload)[i];
+    MSGQ_setMsgId((MSGQ_Msg) ack, jobId);
+    MSGQ_setSrcQueue((MSGQ_Msg) ack, info->localMsgq);
+
+    /* A client that went away must not bring the service down */
+    if (MSGQ_put(replyQueue, (MSGQ_Msg) ack) != SYS_OK)
+    {
+#if !defined (LOG_COMPONENT)
+        LOG_printf(&trace, "Acknowledgement 0x%x dropped", command);
+#endif
+        MSGQ_free((MSGQ_Msg) ack);
+    }
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_multiplyVectors
+ *
+ *  @desc   Multiplies the resident matrix by the vectors of a CMD_VECTORS
+ *          message from its owner, and replies with the products in a
+ *          freshly allocated CMD_RESULT message. The statistics of the
+ *          reply cover this message only: the cycles of the products, the
+ *          cycles of the explicit writeback and the bytes of both
+ *          messages. The request is rejected when no reply can be
+ *          allocated.
+ *
+ *  @modif  None
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_multiplyVectors(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS,
+                                      MSGQ_Queue replyQueue)
+{
+    Int status = SYS_OK;
+    ControlMsgL* msgL;
+    Uint16 msgSize;
+    Uint32 start;
+
+    if ((replyQueue != info->residentQueue) || (info->residentRows == 0)
+        || (info->residentLoaded != info->residentRows)
+        || (msgS->dimM != info->residentRows) || (msgS->dimK != info->residentCols)
+        || (msgS->elemSize != sizeof(Uint16)) || (msgS->format != FORMAT_DENSE)
+        || (msgS->numRows == 0) || (msgS->numRows > GEMV_MAX_VECTORS))
+    {
+        return SYS_EINVAL;
+    }
+
+    msgSize = CTRLMSG_SIZE(msgS->numRows * info->residentRows * sizeof(Uint32));
+    status = TSKMESSAGE_allocReply(msgSize, (MSGQ_Msg*) &msgL);
+    if (status != SYS_OK)
+    {
+        return status;
+    }
+
+    msgL->arg1 = MATMULT_gemv(msgL->arg2, info->residentRows, info->residentCols,
+                              msgS->arg2, msgS->numRows);
+
+    msgL->command = CMD_RESULT;
+    msgL->matrixSize = 0;
+    msgL->jobId = msgS->jobId;
+    msgL->rowStart = msgS->rowStart;
+    msgL->numRows = msgS->numRows;
+    msgL->dspConfig = DSPCONFIG(MEMPROFILE, L2CACHE_KB);
+    msgL->kernel = KERNEL_BASE;
+    msgL->kernelParam = 0;
+    msgL->accum = ACCUM_WRAP;
+    msgL->elemSize = sizeof(Uint32);
+    msgL->format = FORMAT_DENSE;
+    msgL->nnz = 0;
+    msgL->dimM = info->residentRows;
+    msgL->dimN = msgS->numRows;
+    msgL->dimK = info->residentCols;
+    msgL->trans = 0;
+    msgL->alpha = 1;
+    MSGQ_setMsgId((MSGQ_Msg) msgL, msgS->jobId);
+    MSGQ_setSrcQueue((MSGQ_Msg) msgL, info->localMsgq);
+
+    start = TSCL;
+    BCACHE_wb((Ptr) msgL, msgSize, TRUE);
+    msgL->cacheCycles = TSCL - start;
+    msgL->cacheBytes = CTRLMSG_SIZE(msgS->numRows * info->residentCols * sizeof(Uint16)) + msgSize;
+
+    /* A client that went away must not bring the service down */
+    if (MSGQ_put(replyQueue, (MSGQ_Msg) msgL) != SYS_OK)
+    {
+#if !defined (LOG_COMPONENT)
+        LOG_printf(&trace, "Products of vector block %d dropped", msgS->rowStart);
+#endif
+        MSGQ_free((MSGQ_Msg) msgL);
+    }
+
     return status;
 }
 
 
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_allocReply
+ *
+ *  @desc   Allocates a message of the given size from the pool, retrying
+ *          ALLOC_RETRIES times while GPP processes hold its buffers. A
+ *          client that stopped reading its replies then only loses its
+ *          own.
+ *
+ *  @modif  None
+ *  ----------------------------------------------------------------------------
+ */
+static Int TSKMESSAGE_allocReply(Uint16 size, MSGQ_Msg* msgPtr)
+{
+    Int status;
+    Uint32 retries = 0;
+
+    do
+    {
+        status = MSGQ_alloc(SAMPLE_POOL_ID, msgPtr, size);
+        if (status != SYS_OK)
+            TSK_sleep(RETRY_TICKS);
+    } while ((status != SYS_OK) && (++retries < ALLOC_RETRIES));
+
+    return status;
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_defer
+ *
+ *  @desc   Puts a request at the end of deferredMsgq, to be taken again
+ *          once no job is in progress. A request that cannot be deferred
+ *          is dropped.
+ *
+ *  @modif  info->deferredCount
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_defer(TSKMESSAGE_TransferInfo* info, ControlMsgS* msgS)
+{
+    if (MSGQ_put(info->deferredMsgq, (MSGQ_Msg) msgS) == SYS_OK)
+    {
+        info->deferredCount++;
+    }
+    else
+    {
+#if !defined (LOG_COMPONENT)
+        LOG_printf(&trace, "Request 0x%x dropped", msgS->command);
+#endif
+        MSGQ_free((MSGQ_Msg) msgS);
+    }
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_abandonJob
+ *
+ *  @desc   Gives up the job in progress, whose client sent no block for
+ *          JOB_TIMEOUT_TICKS, and sends it a single CMD_ERROR for the job.
+ *          A client that went away cannot take it, and is not waited for
+ *          any longer; later blocks of the job are dropped.
+ *
+ *  @modif  info
+ *  ----------------------------------------------------------------------------
+ */
+static Void TSKMESSAGE_abandonJob(TSKMESSAGE_TransferInfo* info)
+{
+#if !defined (LOG_COMPONENT)
+    LOG_printf(&trace, "Job %d abandoned", info->jobId);
+#endif
+    info->jobActive = FALSE;
+    info->abandonedQueue = info->jobQueue;
+    info->abandonedId = info->jobId;
+    TSKMESSAGE_acknowledge(info, info->jobQueue, CMD_ERROR, info->jobId, 0, 0, 0, NULL, 0);
+}
+
+
+/** ----------------------------------------------------------------------------
+ *  @func   TSKMESSAGE_now
+ *
+ *  @desc   Reads the time stamp counter started by TSKMESSAGE_create () as
+ *          64 bits. Reading TSCL latches TSCH, so it must be read first.
+ *
+ *  @modif  None
+ *  ----------------------------------------------------------------------------
+ */
+static TSKMESSAGE_Cycles TSKMESSAGE_now(Void)
+{
+    Uint32 low = TSCL;
+
+    return ((TSKMESSAGE_Cycles) TSCH << 32) | low;
+}
+
+
 /** ============================================================================
  *  @func   TSKMESSAGE_delete
  *
@@ -324,13 +1651,28 @@ Int TSKMESSAGE_delete(TSKMESSAGE_TransferInfo* info)
     Int status = SYS_OK;
     Int tmpStatus = SYS_OK;
     Bool freeStatus = FALSE;
+    ControlMsgS* msgS;
 
-    /* Release the located message queue */
-    if (info->locatedMsgq != MSGQ_INVALIDMSGQ)
+    if (info->echoSwi != NULL)
     {
-        status = MSGQ_release(info->locatedMsgq);
-        if (status != SYS_OK)
+        NOTIFY_unregister(ID_GPP, ECHO_IPS_ID, ECHO_EVENT_NO,
+                          (FnNotifyCbck) TSKMESSAGE_echoNotify, info);
+        SWI_delete(info->echoSwi);
+    }
+
+    /* Drop the requests still deferred */
+    if (info->deferredMsgq != MSGQ_INVALIDMSGQ)
+    {
+        while ((info->deferredCount > 0)
+               && (MSGQ_get(info->deferredMsgq, (MSGQ_Msg*) &msgS, 0) == SYS_OK))
         {
+            MSGQ_free((MSGQ_Msg) msgS);
+            info->deferredCount--;
+        }
+        tmpStatus = MSGQ_close(info->deferredMsgq);
+        if ((status == SYS_OK) && (tmpStatus != SYS_OK))
+        {
+            status = tmpStatus;
             SET_FAILURE_REASON(status);
         }
     }
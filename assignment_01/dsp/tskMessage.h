@@ -24,6 +24,7 @@
 /*  ----------------------------------- DSP/BIOS Headers            */
 #include <msgq.h>
 #include <sem.h>
+#include <swi.h>
 
 
 #ifdef __cplusplus
@@ -31,30 +32,150 @@ extern "C" {
 #endif
 
 
+/** ============================================================================
+ *  @name   TSKMESSAGE_Cycles
+ *
+ *  @desc   A 64-bit time stamp or count of DSP cycles.
+ *  ============================================================================
+ */
+typedef unsigned long long TSKMESSAGE_Cycles;
+
+
 /** ============================================================================
  *  @name   TSKMESSAGE_TransferInfo
  *
  *  @desc   Structure used to keep various information needed by various phases
  *          of the application.
  *
- *  @field  sequenceNumber
- *              Expected id from the GPP.
+ *  @field  jobActive
+ *              TRUE while the operands of a job are being received.
+ *  @field  jobQueue
+ *              Reply queue of the job in progress.
+ *  @field  jobId
+ *              Id of the job in progress.
+ *  @field  jobTick
+ *              Clock tick at which the last block of the job in progress
+ *              arrived.
+ *  @field  abandonedQueue, abandonedId
+ *              Reply queue and id of the last job abandoned, whose late
+ *              blocks are dropped.
  *  @field  matrixSize
- *              Matrix size.
+ *              Matrix size of the job in progress.
+ *  @field  kernel
+ *              Kernel computing the job in progress.
+ *  @field  kernelParam
+ *              Parameter of the kernel.
+ *  @field  accum
+ *              Accumulation of the job in progress, see ACCUM_*.
+ *  @field  elemSize
+ *              Bytes per operand element of the job in progress.
+ *  @field  dimM, dimN, dimK
+ *              Dimensions of the job in progress, matrixSize for jobs other
+ *              than KERNEL_GEMM.
+ *  @field  trans
+ *              Transposed operands of the job in progress, see TRANS_*.
+ *  @field  alpha
+ *              Scale of the product of the job in progress.
+ *  @field  heightA, widthA, heightB, widthB
+ *              Rows and row length of the operands as sent.
+ *  @field  sparseA
+ *              TRUE when the first operand is kept in CSR form.
+ *  @field  packed
+ *              TRUE when the operands are kept as packed 8-bit elements.
+ *  @field  rowsA
+ *              Rows of the first operand received so far.
+ *  @field  rowsB
+ *              Rows of the second operand received so far.
+ *  @field  residentQueue
+ *              Reply queue of the process owning the resident matrix.
+ *  @field  residentId
+ *              Id of the load of the resident matrix.
+ *  @field  residentRows, residentCols
+ *              Dimensions of the resident matrix.
+ *  @field  residentLoaded
+ *              Rows of the resident matrix received so far.
+ *  @field  tuning
+ *              Variant of the base kernel per size class, see CMD_TUNE.
+ *  @field  cycles
+ *              Cycles spent so far on the product of the job in progress.
+ *  @field  cacheCycles
+ *              Cycles spent so far on explicit cache maintenance of the
+ *              shared buffers of the job in progress.
+ *  @field  cacheBytes
+ *              Bytes of shared buffers of the job in progress maintained so
+ *              far, by the transport or explicitly.
+ *  @field  statsStart
+ *              Time stamp at which the statistics started.
+ *  @field  waitCycles, copyCycles, computeCycles, messages
+ *              Statistics so far, see DspStats.
+ *  @field  heapPeak
+ *              Most heap bytes in use at a statistics report.
+ *  @field  poolSize, poolDepth
+ *              Description of the message pool, see CMD_POOL.
  *  @field  localMsgq
  *              Handle of opened message queue.
- *  @field  locatedMsgqHandle
- *              Handle to located message queue.
  *  @field  notifySemObj
  *              Semaphore used for message notification.
+ *  @field  deferredMsgq
+ *              Local queue of the requests deferred while a job is in
+ *              progress, in order of arrival.
+ *  @field  deferredCount
+ *              Requests in deferredMsgq.
+ *  @field  echoSwi
+ *              Software interrupt echoing NOTIFY events, NULL when the echo
+ *              is unavailable.
+ *  @field  echoValue
+ *              Payload of the last NOTIFY event to echo.
  *  ============================================================================
  */
 typedef struct TSKMESSAGE_TransferInfo_tag {
-    Uint16     sequenceNumber;
+    Bool       jobActive;
+    MSGQ_Queue jobQueue;
+    Uint16     jobId;
+    Uns        jobTick;
+    MSGQ_Queue abandonedQueue;
+    Uint16     abandonedId;
     Uint16     matrixSize;
+    Uint16     kernel;
+    Uint16     kernelParam;
+    Uint16     accum;
+    Uint16     elemSize;
+    Uint16     dimM;
+    Uint16     dimN;
+    Uint16     dimK;
+    Uint16     trans;
+    Uint32     alpha;
+    Uint16     heightA;
+    Uint16     widthA;
+    Uint16     heightB;
+    Uint16     widthB;
+    Bool       sparseA;
+    Bool       packed;
+    Uint16     rowsA;
+    Uint16     rowsB;
+    MSGQ_Queue residentQueue;
+    Uint16     residentId;
+    Uint16     residentRows;
+    Uint16     residentCols;
+    Uint16     residentLoaded;
+    Uint16     tuning[TUNE_CLASSES];
+    Uint32     cycles;
+    Uint32     cacheCycles;
+    Uint32     cacheBytes;
+    TSKMESSAGE_Cycles statsStart;
+    TSKMESSAGE_Cycles waitCycles;
+    TSKMESSAGE_Cycles copyCycles;
+    TSKMESSAGE_Cycles computeCycles;
+    Uint32     messages;
+    Uint32     heapPeak;
+    Uint16     poolSize;
+    Uint16     poolDepth;
     MSGQ_Queue localMsgq;
-    MSGQ_Queue locatedMsgq;
     SEM_Obj    notifySemObj;
+    MSGQ_Queue deferredMsgq;
+    Uint32     deferredCount;
+    SWI_Handle echoSwi;
+    volatile Uint32 echoValue;
 } TSKMESSAGE_TransferInfo;
 
 
@@ -83,7 +204,8 @@ Int TSKMESSAGE_create(TSKMESSAGE_TransferInfo** transferInfo);
 /** ============================================================================
  *  @func   TSKMESSAGE_execute
  *
- *  @desc   Excecute phase function of TSKMESSAGE application.
+ *  @desc   Excecute phase function of TSKMESSAGE application. Serves jobs
+ *          from any GPP process until a CMD_SHUTDOWN message is received.
  *
  *  @arg    transferInfo
  *              Information for transfer.
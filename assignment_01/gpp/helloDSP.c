@@ -16,12 +16,15 @@
 #include <proc.h>
 #include <msgq.h>
 #include <pool.h>
+#include <notify.h>
 
 /*  ----------------------------------- Application Header              */
 #include <helloDSP.h>
 #include <system_os.h>
 
 #include <stdio.h>
+#include <stddef.h>
+#include <string.h>
 
 
 #if defined (__cplusplus)
@@ -29,9 +32,6 @@ extern "C"
 {
 #endif /* defined (__cplusplus) */
 
-    /* Number of arguments specified to the DSP application. */
-#define NUM_ARGS 1
-
     /* Argument size passed to the control message queue */
 #define ARG1_SIZE       256
 #define ARG2_SIZE       128
@@ -42,37 +42,352 @@ extern "C"
     /* ID of the POOL used by helloDSP. */
 #define SAMPLE_POOL_ID  0
 
-    /*  Number of BUF pools in the entire memory pool */
-#define NUMMSGPOOLS     4
+    /* IPS and event number used by the DSP to signal that its message queue
+     * is open. Must match the definitions in the DSP helloDSP_config.h and
+     * must not clash with the events reserved by DSP/BIOS LINK. */
+#define READY_IPS_ID    0
+#define READY_EVENT_NO  5
+
+    /* IPS and event number of the link benchmark, echoed by the DSP with
+     * the same payload. Must match the definitions in the DSP
+     * helloDSP_config.h. */
+#define ECHO_IPS_ID     0
+#define ECHO_EVENT_NO   6
+
+    /* Longest wait for the echo of an event before it is taken as lost. */
+#define ECHO_TIMEOUT_USEC   1000000
+
+    /* Upper bound on the wait for the ready event before MSGQ_locate is
+     * retried. The event normally arrives first; this only matters when
+     * notification is unavailable. */
+#define LOCATE_RETRY_USEC   10000
+
+    /* Retry policy for MSGQ_alloc when the application buffers are in use
+     * by other jobs or by another process attached to the same DSP. */
+#define ALLOC_RETRY_USEC    1000
+#define ALLOC_RETRIES       10000
+
+    /* Commands carried in the command field of a control message.
+     * Must match the definitions in the DSP helloDSP_config.h. */
+#define CMD_MATRIX_A        0x01    /* GPP->DSP: row block of first operand  */
+#define CMD_MATRIX_B        0x02    /* GPP->DSP: row block of second operand */
+#define CMD_LOAD_A          0x03    /* GPP->DSP: row block of resident A     */
+#define CMD_SHUTDOWN        0x04    /* GPP->DSP: leave the service loop      */
+#define CMD_VECTORS         0x05    /* GPP->DSP: vectors to multiply by A    */
+#define CMD_TUNE            0x06    /* GPP->DSP: kernel tuning table         */
+#define CMD_STATS           0x07    /* GPP->DSP: report the DSP statistics   */
+#define CMD_BENCH           0x08    /* GPP->DSP: run the kernel benchmarks   */
+#define CMD_ECHO            0x09    /* GPP->DSP: send the message back       */
+#define CMD_POOL            0x0A    /* GPP->DSP: describe the message pool   */
+#define CMD_RESULT          0x11    /* DSP->GPP: row block of the product    */
+#define CMD_LOADED          0x12    /* DSP->GPP: resident A stored           */
+#define CMD_TUNED           0x13    /* DSP->GPP: tuning table stored         */
+#define CMD_STATS_REPORT    0x14    /* DSP->GPP: DSP statistics, see DspStats */
+#define CMD_BENCH_REPORT    0x15    /* DSP->GPP: BENCH_ENTRIES BenchEntry    */
+#define CMD_ECHOED          0x16    /* DSP->GPP: the CMD_ECHO message back   */
+#define CMD_ERROR           0x1F    /* DSP->GPP: request rejected            */
+
+    /* Option of a CMD_ECHO message, in kernelParam: the DSP complements
+     * the 32-bit words of the payload and writes the message back from its
+     * cache before returning it. Must match the definition in the DSP
+     * helloDSP_config.h. */
+#define ECHO_TOUCH          0x1
+
+    /* Round trips per message size and link in helloDSP_LinkBench (), and
+     * most messages it keeps in flight to measure bandwidth. */
+#define LINKBENCH_PASSES    1000
+#define LINKBENCH_WINDOW    8
+
+    /* Most vectors per CMD_VECTORS message. Must match the definition in
+     * the DSP helloDSP_config.h. */
+#define GEMV_MAX_VECTORS    64
+
+    /* Size of the POOLMEM region the pool is carved from (see LINKCFG),
+     * and the part of it kept for the pool's own bookkeeping. */
+#define POOL_MEM_SIZE       0xd0000
+#define POOL_RESERVE_SIZE   0x1000
+
+    /* Largest number of buffer classes in the pool: the three used by the
+     * transport, full and last operand and result blocks, the statistics
+     * messages and the benchmark report. */
+#define MAX_BUF_POOLS       9
+
+    /* Jobs kept in flight and jobs run when not given on the command line. */
+#define DEFAULT_PIPELINE_DEPTH  2
+#define DEFAULT_BATCH_SIZE      1
+
+    /* Number of transport messages of each kind in the pool. */
+#define NUM_CTRLMSG         2
+#define NUM_LOCATEMSG       2
+#define NUM_ERRORMSG        4
+
+    /* Buffers kept for a CMD_STATS request and its report, so that the
+     * statistics can be read while jobs hold the other buffers. */
+#define NUM_STATSMSG        2
+
+    /* Buffers kept for a CMD_BENCH_REPORT, which outgrows the others. */
+#define NUM_BENCHMSG        1
+
+    /* Interval at which the daemon logs the DSP statistics. */
+#define DSPSTATS_PERIOD_USEC    10000000
+
+    /* Kernels computing a job, given with kernelParam in the first operand
+     * block of the job. Must match the definitions in the DSP
+     * helloDSP_config.h. */
+#define KERNEL_BASE         0       /* Tiled triple loop                     */
+#define KERNEL_STRASSEN     1       /* Strassen-Winograd, kernelParam=cutoff */
+#define KERNEL_GEMM         2       /* alpha * op(A) * op(B)                 */
+
+    /* Variants of the base kernel, given as kernelParam of a KERNEL_BASE
+     * job: staged tile columns in the low byte, 4, 8 or 16, and options.
+     * 0 selects the variant of the tuning table for the size class of the
+     * job. Must match MATMULT_VARIANT_* in the DSP matMult.h and the size
+     * classes of the DSP helloDSP_config.h. */
+#define VARIANT_TILE        0x00FF
+#define VARIANT_UNROLL4     0x0100  /* four dot products per row pass       */
+#define VARIANT_AXPY        0x0200  /* rows of the tile accumulated instead */
+#define VARIANT_DIRECT      0x0400  /* tile read in place, not staged       */
+#define VARIANT_FIXED       0x0800  /* default, specialised for some sizes  */
+
+#define VARIANT_VALID(v)                                                      \
+    (((v) == 0) || ((v) == VARIANT_FIXED)                                     \
+     || ((((v) & ~(VARIANT_TILE | VARIANT_UNROLL4 | VARIANT_AXPY | VARIANT_DIRECT)) == 0) \
+         && ((((v) & VARIANT_TILE) == 4) || (((v) & VARIANT_TILE) == 8)       \
+             || (((v) & VARIANT_TILE) == 16))                                 \
+         && (((v) & (VARIANT_AXPY | VARIANT_UNROLL4)) != (VARIANT_AXPY | VARIANT_UNROLL4))))
+
+#define TUNE_CLASSES        6
+
+    /* Variants timed by helloDSP_Tune (). */
+#define TUNE_VARIANTS       19
+
+    /* Tuning table saved by helloDSP_Tune () and sent to the DSP by
+     * helloDSP_Create (), in the working directory. */
+#define TUNE_FILE           "helloDSP.tune"
+
+    /* Transposed operands of a KERNEL_GEMM job, given in its trans field.
+     * Operands are sent as stored. Must match the definitions in the DSP
+     * helloDSP_config.h. */
+#define TRANS_A             0x1
+#define TRANS_B             0x2
+
+    /* Smallest Strassen-Winograd cutoff accepted by the DSP
+     * (MATMULT_MIN_CUTOFF in the DSP matMult.h). */
+#define STRASSEN_MIN_CUTOFF 16
+
+    /* Accumulation of a job, given in the first operand block of the job.
+     * Must match the definitions in the DSP helloDSP_config.h. */
+#define ACCUM_WRAP          0       /* 32-bit product, modulo 2^32           */
+#define ACCUM_CHECKED       1       /* 64-bit product when it may overflow   */
+
+    /* Element of a product as received from the DSP. */
+    typedef unsigned long long AccumWide;
+
+    /* Statistics of the DSP, the payload of a CMD_STATS_REPORT message.
+     * Cycle counts are 64-bit, low word first, and run from the start of
+     * the DSP; a reader takes the difference of two reports. waitCycles is
+     * the idle time of the DSP, copyCycles its time storing operands and
+     * computeCycles its time computing and sending products. poolSize and
+     * poolDepth describe the pool as given with CMD_POOL by the process
+     * that opened it. Must match the definition in the DSP
+     * helloDSP_config.h. */
+    typedef struct DspStats
+    {
+        Uint32  elapsedCycles[2];           // Since the DSP started
+        Uint32  waitCycles[2];              // Blocked in MSGQ_get ()
+        Uint32  copyCycles[2];              // Storing operand blocks
+        Uint32  computeCycles[2];           // Computing and sending products
+        Uint32  messages;                   // Requests handled
+        Uint32  heapSize;                   // Bytes of the DSP heap
+        Uint32  heapUsed;                   // Bytes in use
+        Uint32  heapPeak;                   // Most bytes in use at a report
+        Uint32  heapLargestFree;            // Largest free block
+        Uint32  stackSize;                  // Bytes of the DSP task stack
+        Uint32  stackUsed;                  // Most stack bytes ever used
+        Uint16  poolSize;                   // Largest job size of the pool
+        Uint16  poolDepth;                  // Jobs of poolSize it holds
+    } DspStats;
+
+#define DSPSTATS_CYCLES(words)  ((AccumWide) (words)[0] | ((AccumWide) (words)[1] << 32))
+
+    /* Kernel microbenchmarks, the payload of a CMD_BENCH_REPORT message:
+     * the whole product of each of BENCH_KERNELS kernels timed for
+     * BENCH_SIZES sizes, once with cold caches and once warm. Entries come
+     * sizes outermost, then kernels, cold run first. Must match the
+     * definitions in the DSP helloDSP_config.h and the kernels of
+     * MATMULT_bench () in the DSP matMult.h. */
+#define BENCH_SIZES         7
+#define BENCH_SIZE(i)       ((((i) & 1) ? 24 : 16) << ((i) >> 1))
+#define BENCH_KERNELS       5
+#define BENCH_ENTRIES       (BENCH_SIZES * BENCH_KERNELS * 2)
+
+    typedef struct BenchEntry
+    {
+        Uint16  kernel;                     // Index in benchKernels
+        Uint16  matrixSize;                 // Size of the operands
+        Uint16  warm;                       // 0 for the cold run
+        Uint16  reserved;
+        Uint32  cycles[2];                  // Of the whole product, low word first
+    } BenchEntry;
+
+    /* Layout of an operand row block, given in its format field. A CSR
+     * block holds numRows + 1 row offsets into the block and nnz column
+     * indices, all 16-bit, followed by the nnz values of elemSize bytes
+     * each. A delta block holds the first element of each row, 16-bit,
+     * padded to an even count, followed by 32-bit words packing the other
+     * elements as their difference to the previous one, modulo 2^16 and
+     * zigzag-coded, in nnz bits each from the least significant bit up.
+     * A generated block holds a GenSpec the DSP computes its rows from.
+     * Must match the definitions in the DSP helloDSP_config.h. */
+#define FORMAT_DENSE        0
+#define FORMAT_CSR          1
+#define FORMAT_DELTA        2
+#define FORMAT_GENERATED    3
+
+    /* Zigzag code of a 16-bit difference: small magnitudes of either sign
+     * get few bits. */
+#define DELTA_ZIGZAG(d)     ((Uint16) (((d) << 1) ^ (((d) & 0x8000) ? 0xFFFF : 0)))
+
+    /* Delta coding is used for an operand only when it at least halves its
+     * bytes: below that, decoding on the DSP costs about what the smaller
+     * messages save in copies and cache maintenance. */
+#define DELTA_MIN_RATIO     2
+
+    /* Generators of a FORMAT_GENERATED block, the same numbers as
+     * HELLODSP_GEN_*. Element (j, k) of the operand is modulo 2^16:
+     * base + rowStep * j + colStep * k for GEN_AFFINE, base for
+     * GEN_CONSTANT, base on the diagonal for GEN_IDENTITY, the affine
+     * value within band of the diagonal for GEN_BANDED, and the upper 16
+     * bits of the LCG state stepped once per element, row-major from seed,
+     * for GEN_RANDOM. Must match the definitions in the DSP
+     * helloDSP_config.h. */
+#define GEN_AFFINE          0
+#define GEN_CONSTANT        1
+#define GEN_IDENTITY        2
+#define GEN_BANDED          3
+#define GEN_RANDOM          4
 
-    /* Number of messages in each BUF pool. */
-#define NUMMSGINPOOL0   1
-#define NUMMSGINPOOL1   2
-#define NUMMSGINPOOL2   2
-#define NUMMSGINPOOL3   4
+    typedef struct GenSpec
+    {
+        Uint16  kind;                       // Generator, see GEN_*
+        Uint16  band;                       // Half-width of a banded operand
+        Uint16  base;                       // Constant term or diagonal
+        Uint16  rowStep;                    // Increment per row
+        Uint16  colStep;                    // Increment per column
+        Uint16  reserved;
+        Uint32  seed;                       // First state of a random operand
+    } GenSpec;
+
+#define GEN_LCG_NEXT(state) ((state) * 1103515245 + 12345)
 
 /* Control message data structure. */
 /* Must contain a reserved space for the header */
+/* arg2 holds numRows rows of matrixSize elements of elemSize bytes each,
+ * row-major. Operands have 8- or 16-bit elements, the same for all blocks
+ * of a job. 64-bit elements are two words, low word first. Messages
+ * are allocated with the size actually needed, see CTRLMSG_SIZE: the
+ * zero-copy transport writes back and invalidates the allocated size of a
+ * message, so that is all the cache maintenance a message costs. */
 typedef struct ControlMsgS
 {
     MSGQ_MsgHeader header;
     Uint16  command;
-    int     arg1;                           // Cycles timer from DSP
-    Uint16  arg2[ARG2_SIZE][ARG2_SIZE];     // 128x128, 16-bit-element matrix
+    Uint16  matrixSize;                     // Size of the operands
+    Uint16  jobId;                          // Job the message belongs to
+    Uint16  rowStart;                       // First matrix row in arg2
+    Uint16  numRows;                        // Number of matrix rows in arg2
+    Uint16  dspConfig;                      // DSP build, see DSPCONFIG
+    Uint16  kernel;                         // Kernel computing the job
+    Uint16  kernelParam;                    // Parameter of the kernel
+    Uint16  accum;                          // Accumulation, see ACCUM_*
+    Uint16  elemSize;                       // Bytes per element of arg2
+    Uint16  format;                         // Layout of arg2, see FORMAT_*
+    Uint16  nnz;                            // Non-zeros in a CSR block, bits per delta
+    Uint16  dimM;                           // Rows of the product
+    Uint16  dimN;                           // Columns of the product
+    Uint16  dimK;                           // Inner dimension
+    Uint16  trans;                          // Transposed operands, see TRANS_*
+    Uint32  alpha;                          // Scale of the product
+    Uint32  arg1;                           // Cycles timer from DSP
+    Uint32  cacheCycles;                    // DSP cycles in cache maintenance
+    Uint32  cacheBytes;                     // Bytes of shared buffers maintained
+    Uint16  arg2[1];                        // 8- or 16-bit-element row block
 } ControlMsgS;
 
 typedef struct ControlMsgL
 {
     MSGQ_MsgHeader header;
     Uint16  command;
-    int     arg1;                           // Cycles timer from DSP
-    Uint32  arg2[ARG2_SIZE/2][ARG2_SIZE];   // 64x128, 32-bit-element matrix
+    Uint16  matrixSize;                     // Size of the operands
+    Uint16  jobId;                          // Job the message belongs to
+    Uint16  rowStart;                       // First matrix row in arg2
+    Uint16  numRows;                        // Number of matrix rows in arg2
+    Uint16  dspConfig;                      // DSP build, see DSPCONFIG
+    Uint16  kernel;                         // Kernel computing the job
+    Uint16  kernelParam;                    // Parameter of the kernel
+    Uint16  accum;                          // Accumulation, see ACCUM_*
+    Uint16  elemSize;                       // Bytes per element of arg2
+    Uint16  format;                         // Layout of arg2, see FORMAT_*
+    Uint16  nnz;                            // Non-zeros in a CSR block, bits per delta
+    Uint16  dimM;                           // Rows of the product
+    Uint16  dimN;                           // Columns of the product
+    Uint16  dimK;                           // Inner dimension
+    Uint16  trans;                          // Transposed operands, see TRANS_*
+    Uint32  alpha;                          // Scale of the product
+    Uint32  arg1;                           // Cycles timer from DSP
+    Uint32  cacheCycles;                    // DSP cycles in cache maintenance
+    Uint32  cacheBytes;                     // Bytes of shared buffers maintained
+    Uint32  arg2[1];                        // 32- or 64-bit-element row block
 } ControlMsgL;
 
-    /* Messaging buffer used by the application.
-     * Note: This buffer must be aligned according to the alignment expected
-     * by the device/platform. */
-#define APP_BUFFER_SIZE DSPLINK_ALIGN (sizeof (ControlMsgS), DSPLINK_BUF_ALIGN)
+    /* Message size helpers. Must match the definitions in the DSP
+     * helloDSP_config.h. */
+#define CTRLMSG_HDR_SIZE    offsetof(ControlMsgS, arg2)
+#define CTRLMSG_MAX_SIZE    0xFF80
+#define CTRLMSG_MIN_SIZE    (2 * DSPLINK_BUF_ALIGN)
+
+#define CTRLMSG_SIZE(bytes)                                                   \
+    ((DSPLINK_ALIGN(CTRLMSG_HDR_SIZE + (bytes), DSPLINK_BUF_ALIGN) < CTRLMSG_MIN_SIZE) \
+        ? CTRLMSG_MIN_SIZE                                                    \
+        : DSPLINK_ALIGN(CTRLMSG_HDR_SIZE + (bytes), DSPLINK_BUF_ALIGN))
+
+#define CTRLMSG_ROW_CAPACITY(width, elemSize)                                 \
+    ((CTRLMSG_MAX_SIZE - CTRLMSG_HDR_SIZE) / ((width) * (elemSize)))
+#define CTRLMSG_ROW_BLOCKS(rows, width, elemSize)                             \
+    (((rows) + CTRLMSG_ROW_CAPACITY(width, elemSize) - 1)                     \
+        / CTRLMSG_ROW_CAPACITY(width, elemSize))
+#define CTRLMSG_ROW_BLOCK_ROWS(rows, width, elemSize)                         \
+    (((rows) + CTRLMSG_ROW_BLOCKS(rows, width, elemSize) - 1)                 \
+        / CTRLMSG_ROW_BLOCKS(rows, width, elemSize))
+#define CTRLMSG_BLOCKS(n, elemSize)         CTRLMSG_ROW_BLOCKS(n, n, elemSize)
+#define CTRLMSG_BLOCK_ROWS(n, elemSize)     CTRLMSG_ROW_BLOCK_ROWS(n, n, elemSize)
+
+#define CTRLMSG_CSR_BYTES(rows, nnz, elemSize)                                \
+    (((rows) + 1 + (nnz)) * sizeof(Uint16) + (nnz) * (elemSize))
+
+#define CTRLMSG_DELTA_HEADS(rows)           (((rows) + 1) & ~1)
+#define CTRLMSG_DELTA_BYTES(rows, width, bits)                                \
+    (CTRLMSG_DELTA_HEADS(rows) * sizeof(Uint16)                               \
+     + (((rows) * ((width) - 1) * (bits) + 31) / 32) * sizeof(Uint32))
+
+    /* Memory profiles of the DSP image and their encoding in the dspConfig
+     * field. Must match the definitions in the DSP helloDSP_config.h. */
+#define MEMPROFILE_DDR      0
+#define MEMPROFILE_SRAM     1
+
+#define DSPCONFIG_PROFILE(config)       ((config) >> 8)
+#define DSPCONFIG_L2CACHE(config)       ((config) & 0xFF)
+
+    /* Rows in the last row block, which may be shorter than the others. */
+#define CTRLMSG_TAIL_ROWS(n, elemSize)                                        \
+    ((n) - (CTRLMSG_BLOCKS(n, elemSize) - 1) * CTRLMSG_BLOCK_ROWS(n, elemSize))
+
+    /* Largest element of a product block: checked jobs may come back with
+     * 64-bit elements. */
+#define RESULT_ELEM_MAX     (2 * sizeof(Uint32))
+
+    /* Largest number of operand messages making up one job. */
+#define MAX_OPERAND_BLOCKS  (2 * CTRLMSG_BLOCKS(ARG2_SIZE, sizeof(Uint16)))
 
     /* Definitions required for the sample Message queue.
      * Using a Zero-copy based transport on the shared memory physical link. */
@@ -81,36 +396,26 @@ typedef struct ControlMsgL
     STATIC ZCPYMQT_Attrs mqtAttrs;
 #endif
 
-    /* Message sizes managed by the pool */
-    STATIC Uint32 SampleBufSizes[NUMMSGPOOLS] =
-    {
-        APP_BUFFER_SIZE,
-        SAMPLEMQT_CTRLMSG_SIZE,
-        DSPLINK_ALIGN (sizeof(MSGQ_AsyncLocateMsg), DSPLINK_BUF_ALIGN),
-        DSPLINK_ALIGN (sizeof(MSGQ_AsyncErrorMsg), DSPLINK_BUF_ALIGN)
-    };
+    /* Message sizes managed by the pool, in ascending order.
+     * Filled in by helloDSP_SizePool (). */
+    STATIC Uint32 SampleBufSizes[MAX_BUF_POOLS];
 
     /* Number of messages in each pool */
-    STATIC Uint32 SampleNumBuffers[NUMMSGPOOLS] =
-    {
-        NUMMSGINPOOL0,
-        NUMMSGINPOOL1,
-        NUMMSGINPOOL2,
-        NUMMSGINPOOL3
-    };
+    STATIC Uint32 SampleNumBuffers[MAX_BUF_POOLS];
 
     /* Definition of attributes for the pool based on physical link used by the transport */
 #if defined ZCPY_LINK
     STATIC SMAPOOL_Attrs SamplePoolAttrs =
     {
-        NUMMSGPOOLS,
+        0,
         SampleBufSizes,
         SampleNumBuffers,
-        TRUE   /* If allocating a buffer smaller than the POOL size, set this to FALSE */
+        FALSE   /* Small jobs use the buffer classes sized for the largest ones */
     };
 #endif
 
-    /* Name of the first MSGQ on the GPP and on the DSP. */
+    /* Name of the first MSGQ on the GPP and on the DSP.
+     * Attached processes make the GPP name unique by appending their pid. */
     STATIC Char8 SampleGppMsgqName[DSP_MAX_STRLEN] = "GPPMSGQ1";
     STATIC Char8 SampleDspMsgqName[DSP_MAX_STRLEN] = "DSPMSGQ";
 
@@ -124,458 +429,4935 @@ typedef struct ControlMsgL
     /* Extern declaration to the default DSP/BIOS LINK configuration structure. */
     extern LINKCFG_Object LINKCFG_config;
 
-#if defined (VERIFY_DATA)
-    /** ============================================================================
-     *  @func   helloDSP_VerifyData
-     *
-     *  @desc   This function verifies the data-integrity of given message.
-     *  ============================================================================
-     */
-    STATIC NORMAL_API DSP_STATUS helloDSP_VerifyData(IN MSGQ_Msg msgS, IN Uint16 sequenceNumber);
-#endif
+    /* Semaphore posted when the DSP signals that its message queue is open. */
+    STATIC Pvoid readySem = NULL;
 
+    /* Payload of the last event echoed by the DSP, see helloDSP_EchoNotify (). */
+    STATIC volatile Uint32 echoValue = 0;
 
-    /** ============================================================================
-     *  @func   helloDSP_Create
-     *
-     *  @desc   This function allocates and initializes resources used by
-     *          this application.
-     *
-     *  @modif  helloDSP_InpBufs , helloDSP_OutBufs
-     *  ============================================================================
-     */
-    NORMAL_API DSP_STATUS helloDSP_Create(IN Char8* dspExecutable, IN Char8* strMatrixSize, IN Uint8 processorId)
+    /* How this process uses the DSP, as given to helloDSP_Create (). */
+    STATIC HELLODSP_Mode sessionMode = HELLODSP_STANDALONE;
+
+    /* Number of jobs kept in flight, as fitted into the pool by
+     * helloDSP_SizePool (). */
+    STATIC Uint32 sessionDepth = 1;
+
+    /* Largest matrix size the pool was sized for by helloDSP_SizePool (). */
+    STATIC Uint32 sessionSize = 0;
+
+    /* Printed products are formatted into outputBuffer and written out a
+     * buffer at a time. OUTPUT_ELEM_MAX bounds the digits of an element. */
+#define OUTPUT_BUFFER_SIZE  65536
+#define OUTPUT_ELEM_MAX     20
+
+    STATIC Char8 outputBuffer[OUTPUT_BUFFER_SIZE];
+
+    /* Working buffers of the GPP are carved out of an arena allocated once
+     * by helloDSP_Create () for sessionSize: the operands and both products
+     * of a square job, at most 20 bytes per element, plus the alignment of
+     * each buffer. Allocations are released in LIFO order to a mark. */
+#define ARENA_ALIGN         64
+#define ARENA_BYTES(n)      ((2 * sizeof(Uint16) + 2 * sizeof(AccumWide)) * (n) * (n) + 4 * ARENA_ALIGN)
+
+    STATIC Uint8* arenaBase = NULL;
+    STATIC Uint32 arenaSize = 0;
+    STATIC Uint32 arenaUsed = 0;
+
+    /* Dimensions of the matrix resident on the DSP for helloDSP_Gemv (),
+     * 0 when none was loaded. */
+    STATIC Uint32 gemvRows = 0;
+    STATIC Uint32 gemvCols = 0;
+
+    /* Metrics of this process, dumped by helloDSP_DumpMetrics (). Counters
+     * are 32-bit, cumulative from helloDSP_Create () and wrap, so readers
+     * take differences between dumps. Jobs are submitted and collected by
+     * one thread and the signal handler only raises a flag, so the
+     * counters are plain variables. */
+#define METRIC_JOBS_SUBMITTED       0
+#define METRIC_JOBS_COMPLETED       1
+#define METRIC_JOBS_FAILED          2
+#define METRIC_MSGS_SENT            3
+#define METRIC_MSGS_RECEIVED        4
+#define METRIC_BYTES_SENT           5
+#define METRIC_BYTES_RECEIVED       6
+#define METRIC_ALLOC_RETRIES        7
+#define METRIC_ALLOC_FAILURES       8
+#define METRIC_JOBS_IN_FLIGHT       9       /* Gauge                         */
+#define METRIC_JOBS_IN_FLIGHT_PEAK  10
+#define NUM_METRICS                 11
+
+#define METRIC_ADD(id, n)           (metrics[id] += (Uint32) (n))
+#define METRIC_SENT(bytes)          (METRIC_ADD(METRIC_MSGS_SENT, 1), METRIC_ADD(METRIC_BYTES_SENT, bytes))
+#define METRIC_RECEIVED(msg)                                                  \
+    (METRIC_ADD(METRIC_MSGS_RECEIVED, 1),                                     \
+     METRIC_ADD(METRIC_BYTES_RECEIVED, MSGQ_getMsgSize((MsgqMsg) (msg))))
+
+    STATIC Uint32 metrics[NUM_METRICS];
+
+    /* Latency histograms, in uSec: helloDSP_Submit () of a job, each wait
+     * for a message of the DSP in helloDSP_NextView (), and a job from its
+     * submission to its last row block. Bucket b counts latencies below
+     * 2^b uSec not counted by bucket b - 1; the last one counts the rest. */
+#define LATENCY_SUBMIT              0
+#define LATENCY_WAIT                1
+#define LATENCY_JOB                 2
+#define NUM_LATENCIES               3
+#define LATENCY_BUCKETS             24
+
+    typedef struct LatencyHist
     {
-        DSP_STATUS status = DSP_SOK;
-        Uint32 numArgs = NUM_ARGS;
-        MSGQ_LocateAttrs syncLocateAttrs;
-        Char8* args[NUM_ARGS];
+        Uint32  count;                      // Latencies recorded
+        Uint32  sum;                        // uSec, wraps
+        Uint32  buckets[LATENCY_BUCKETS];
+    } LatencyHist;
 
-        SYSTEM_0Print("Entered helloDSP_Create ()\n");
+    STATIC LatencyHist latencies[NUM_LATENCIES];
 
-        /* Create and initialize the proc object. */
-        status = PROC_setup(NULL);
+    /* Dump line of each histogram up to its count, given the process id */
+    STATIC Char8* latencyFormats[NUM_LATENCIES] =
+    {
+        "helloDSP_latency,pid=%u,phase=submit count=%ui",
+        "helloDSP_latency,pid=%u,phase=wait count=%ui",
+        "helloDSP_latency,pid=%u,phase=job count=%ui"
+    };
 
-        /* Attach the Dsp with which the transfers have to be done. */
-        if (DSP_SUCCEEDED(status))
-        {
-            status = PROC_attach(processorId, NULL);
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("PROC_attach () failed. Status = [0x%x]\n", status);
-            }
-        }
+    /* Jobs complete in the order they were submitted, so jobs in flight
+     * are numbered in sequence from jobNext, the oldest. Submission times
+     * are kept for up to METRIC_JOB_SLOTS of them, oldest at jobHead; jobs
+     * submitted while those are all taken are not timed. */
+#define METRIC_JOB_SLOTS            256
 
-        /* Open the pool. */
-        if (DSP_SUCCEEDED(status))
-        {
-            status = POOL_open(POOL_makePoolId(processorId, SAMPLE_POOL_ID), &SamplePoolAttrs);
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("POOL_open () failed. Status = [0x%x]\n", status);
-            }
-        }
-        else
-        {
-            SYSTEM_1Print("PROC_setup () failed. Status = [0x%x]\n", status);
-        }
+    STATIC Uint32 jobSeq[METRIC_JOB_SLOTS];
+    STATIC Uint32 jobStart[METRIC_JOB_SLOTS];
+    STATIC Uint32 jobHead = 0;
+    STATIC Uint32 jobTimed = 0;
+    STATIC Uint32 jobNext = 0;
 
-        /* Open the GPP's message queue */
-        if (DSP_SUCCEEDED(status))
-        {
-            status = MSGQ_open(SampleGppMsgqName, &SampleGppMsgq, NULL);
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("MSGQ_open () failed. Status = [0x%x]\n", status);
-            }
-        }
+    /* Application buffers of the pool held by this process, per buffer
+     * class of SampleBufSizes, with the most held at once since the last
+     * helloDSP_ResetPoolPeak (). A buffer is held from its allocation or
+     * MSGQ_get () until MSGQ_put () or helloDSP_FreeMsg (); the DSP frees
+     * operand blocks as they arrive, so buffers it holds are not counted.
+     * Bytes are those of the buffers, not of the messages in them. */
+    STATIC Uint32 poolHeld[MAX_BUF_POOLS];
+    STATIC Uint32 poolHeldPeak[MAX_BUF_POOLS];
+    STATIC Uint32 poolBuffers = 0;
+    STATIC Uint32 poolBytes = 0;
+    STATIC Uint32 poolBuffersPeak = 0;
+    STATIC Uint32 poolBytesPeak = 0;
 
-        /* Set the message queue that will receive any async. errors */
-        if (DSP_SUCCEEDED(status))
-        {
-            status = MSGQ_setErrorHandler(SampleGppMsgq, POOL_makePoolId(processorId, SAMPLE_POOL_ID));
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("MSGQ_setErrorHandler () failed. Status = [0x%x]\n", status);
-            }
-        }
+    /* Phase of the GPP, read by the sampling profiler of HELLODSP_PROFILE
+     * every PHASE_PERIOD_USEC. Setup covers loading the DSP and opening the
+     * link, link allocating and sending messages, wait receiving them. */
+#define PHASE_OTHER         0
+#define PHASE_SETUP         1
+#define PHASE_PACK          2
+#define PHASE_LINK          3
+#define PHASE_WAIT          4
+#define PHASE_UNPACK        5
+#define PHASE_VERIFY        6
+#define NUM_PHASES          7
+#define PHASE_PERIOD_USEC   1000
 
-        /* Load the executable on the DSP. */
-        if (DSP_SUCCEEDED(status))
-        {
-            args [0] = strMatrixSize;
-            {
-                status = PROC_load(processorId, dspExecutable, numArgs, args);
-            }
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("PROC_load () failed. Status = [0x%x]\n", status);
-            }
-        }
+#define PHASE_ENTER(phase)  (gppPhase = (phase))
 
-        /* Start execution on DSP. */
-        if (DSP_SUCCEEDED(status))
-        {
-            status = PROC_start(processorId);
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("PROC_start () failed. Status = [0x%x]\n", status);
-            }
-        }
+    STATIC volatile Uint32 gppPhase = PHASE_OTHER;
+    STATIC Uint32 phaseSamples[NUM_PHASES];
 
-        /* Open the remote transport. */
-        if (DSP_SUCCEEDED(status))
-        {
-            mqtAttrs.poolId = POOL_makePoolId(processorId, SAMPLE_POOL_ID);
-            status = MSGQ_transportOpen(processorId, &mqtAttrs);
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("MSGQ_transportOpen () failed. Status = [0x%x]\n", status);
-            }
-        }
+    /* Profile line of each phase, given its samples and their percentage */
+    STATIC Char8* phaseFormats[NUM_PHASES] =
+    {
+        "  other   %8d samples %3d%%\n",
+        "  setup   %8d samples %3d%%\n",
+        "  pack    %8d samples %3d%%\n",
+        "  link    %8d samples %3d%%\n",
+        "  wait    %8d samples %3d%%\n",
+        "  unpack  %8d samples %3d%%\n",
+        "  verify  %8d samples %3d%%\n"
+    };
 
-        /* Locate the DSP's message queue */
-        /* At this point the DSP must open a message queue named "DSPMSGQ" */
-        if (DSP_SUCCEEDED(status))
-        {
-            syncLocateAttrs.timeout = WAIT_FOREVER;
-            status = DSP_ENOTFOUND;
-            SYSTEM_2Sprint(dspMsgqName, "%s%d", (Uint32) SampleDspMsgqName, processorId);
-            while ((status == DSP_ENOTFOUND) || (status == DSP_ENOTREADY))
-            {
-                status = MSGQ_locate(dspMsgqName, &SampleDspMsgq, &syncLocateAttrs);
-                if ((status == DSP_ENOTFOUND) || (status == DSP_ENOTREADY))
-                {
-                    SYSTEM_Sleep(100000);
-                }
-                else if (DSP_FAILED(status))
-                {
-                    SYSTEM_1Print("MSGQ_locate () failed. Status = [0x%x]\n", status);
-                }
-            }
-        }
+    /* Statistics of a job, or of a batch when accumulated.
+     * Cache maintenance covers the shared message buffers only. */
+    typedef struct JobStats
+    {
+        Uint32  jobs;                       // Jobs completed
+        Uint32  incorrect;                  // Jobs whose product did not verify
+        Uint32  jobsPeak;                   // Most jobs in flight
+        Uint32  buffersPeak;                // Most application buffers held
+        Uint32  bytesPeak;                  // Bytes of those buffers
+        Uint32  elapsedTime;                // uSec, verification excluded
+        Uint32  wideJobs;                   // Jobs whose product came back 64-bit
+        Uint32  sparseOperands;             // Operands sent in CSR form
+        Uint32  deltaOperands;              // Operands sent delta-coded
+        Uint32  generatedOperands;          // Operands generated by the DSP
+        Uint32  sparseJobs;                 // Jobs run by the sparse kernel
+        Uint32  cycles;                     // DSP cycles spent on multiplication
+        Uint32  dspCacheCycles;             // DSP cycles in explicit cache maintenance
+        Uint32  dspCacheBytes;              // Bytes maintained on the DSP
+        Uint32  gppCacheBytes;              // Bytes maintained on the GPP
+        Uint32  gppSendTime;                // uSec in MSGQ_put, writeback included
+        Uint16  dspConfig;                  // DSP build the job ran on
+    } JobStats;
 
-        SYSTEM_0Print("Leaving helloDSP_Create ()\n");
-        return status;
-    }
+    /* Statistics of a run of echoes of the link benchmark. */
+    typedef struct EchoStats
+    {
+        Uint32  messages;                   // Echoes received
+        Uint32  window;                     // Most messages in flight
+        Uint32  incorrect;                  // Echoes whose payload did not verify
+        Uint32  elapsedTime;                // uSec from the first send to the last echo
+        Uint32  touchCycles;                // DSP cycles complementing payloads
+        Uint32  cacheCycles;                // DSP cycles writing messages back
+        Uint16  dspConfig;                  // DSP build that echoed
+    } EchoStats;
+
+    /* A job as submitted: the dimM x dimN product alpha * op(A) * op(B)
+     * with an inner dimension of dimK. The operands are read in place, in
+     * the orientation they are stored in, from row-major storage with a
+     * row stride of lda and ldb elements, or generated by the DSP from gen
+     * when it is set. Square jobs have matrixSize set,
+     * equal dimensions, no transpose and an alpha of 1. */
+    typedef struct JobDesc
+    {
+        Uint16  matrixSize;                 // Size of square jobs, 0 for GEMM
+        Uint16  kernel;                     // Kernel computing the job
+        Uint16  kernelParam;                // Parameter of the kernel
+        Uint16  accum;                      // Accumulation, see ACCUM_*
+        Uint16  elemSize;                   // Bytes per operand element sent
+        Bool    compress;                   // Operands may be delta-coded
+        const GenSpec* gen;                 // Generators of a and b, or NULL
+        Uint16  dimM;                       // Rows of the product
+        Uint16  dimN;                       // Columns of the product
+        Uint16  dimK;                       // Inner dimension
+        Uint16  trans;                      // Transposed operands, see TRANS_*
+        Uint32  alpha;                      // Scale of the product
+        const Uint16* a;                    // First operand as stored
+        Uint32  lda;                        // Row stride of a
+        const Uint16* b;                    // Second operand as stored
+        Uint32  ldb;                        // Row stride of b
+    } JobDesc;
 
+    /* A row block of a product as received, read in place in the pool
+     * buffer of its message until helloDSP_ReleaseView (). 64-bit elements
+     * are stored as two words, low word first. */
+    typedef struct ResultView
+    {
+        const Uint32* data;                 // First element of the block
+        Uint32  rowStart;                   // First row of the product in the block
+        Uint32  numRows;                    // Rows in the block
+        Uint32  stride;                     // Row stride, in elements
+        Uint16  elemSize;                   // Bytes per element, 4 or 8
+        Bool    last;                       // The message ended its job
+        ControlMsgL* msg;                   // Message holding the block
+    } ResultView;
+
+    /* Whether a reply ends its job. The DSP ends a job with the last block
+     * of its product or with a single CMD_ERROR, and ends the jobs of a
+     * process in the order they were sent. */
+#define REPLY_ENDS_JOB(msg)                                                       (((msg)->command == CMD_ERROR)                                                 || (((msg)->command == CMD_RESULT) && ((msg)->rowStart + (msg)->numRows >= (msg)->dimM)))
+
+    /* Element (j, k) of a view, relative to the start of its block. */
+#define RESULT_VIEW_ELEM(view, j, k)                                          \
+    (((view)->elemSize == sizeof(Uint32))                                     \
+     ? (AccumWide) (view)->data[(j) * (view)->stride + (k)]                   \
+     : ((AccumWide) (view)->data[2 * ((j) * (view)->stride + (k))]            \
+        | ((AccumWide) (view)->data[2 * ((j) * (view)->stride + (k)) + 1] << 32)))
+
+#if defined (PROFILE)
+    /* Time at which helloDSP_Create () was entered, used to report the
+     * time-to-first-job from helloDSP_Execute (). */
+    STATIC Uint32 createStartTime = 0;
+#endif
 
     /** ============================================================================
-     *  @func   helloDSP_Execute
-     *
-     *  @desc   This function implements the execute phase for this application.
+     *  @func   helloDSP_ReadyNotify
      *
-     *  @modif  None
+     *  @desc   NOTIFY callback invoked when the DSP has opened its message
+     *          queue. Wakes up the locate in helloDSP_Create ().
      *  ============================================================================
      */
-    NORMAL_API DSP_STATUS helloDSP_Execute(IN Uint32 matrixSize, Uint8 processorId)
-    {
-        DSP_STATUS  status = DSP_SOK;
-        Uint16 sequenceNumber = 0;
-        Uint16 msgId = 0;
-        Uint8 i;
-        Uint8 j, k, l;
-        /* Two different types of message (see struct typedef for more info) */
-        ControlMsgS *msgS;
-        ControlMsgL *msgL;
+    STATIC NORMAL_API Void helloDSP_ReadyNotify(IN Uint32 eventNo, IN Pvoid arg, IN Pvoid info);
 
-        /* Variable to store product matrix from the DSP */
-        Uint32 resFromDSP[ARG2_SIZE][ARG2_SIZE];
+    /** ============================================================================
+     *  @func   helloDSP_EchoNotify
+     *
+     *  @desc   NOTIFY callback invoked when the DSP echoes an event of the
+     *          link benchmark.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_EchoNotify(IN Uint32 eventNo, IN Pvoid arg, IN Pvoid info);
 
-        /* Pointer to a matrix */
-        Uint16 (*matrixPtS)[ARG2_SIZE];
-        Uint32 (*matrixPtL)[ARG2_SIZE];
+    /** ============================================================================
+     *  @func   helloDSP_SendEcho
+     *
+     *  @desc   Sends a CMD_ECHO message.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_SendEcho(IN ControlMsgS* msgS, IN Uint32 seq,
+                                                   IN Bool touch);
 
-        /* Variable to store result from the timer */
-        Uint32 elapsedTime = 0;
+    /** ============================================================================
+     *  @func   helloDSP_RunEcho
+     *
+     *  @desc   Times echoes of messages of a size through MSGQ.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunEcho(IN Uint16 size, IN Uint32 window, IN Bool touch,
+                                                  OUT EchoStats* stats);
 
-#if defined (VERIF_MULT)
-        /* Matrices for verification purposes */
-        Uint16 mat1[ARG2_SIZE][ARG2_SIZE], mat2[ARG2_SIZE][ARG2_SIZE];
-        Uint32 prod[ARG2_SIZE][ARG2_SIZE];
+    /** ============================================================================
+     *  @func   helloDSP_RunNotifyEcho
+     *
+     *  @desc   Times echoes of NOTIFY events.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunNotifyEcho(IN Uint8 processorId, OUT EchoStats* stats);
 
-        /* Flag to verify multiplication correctness */
-        Uint8 isMultCorrect;
-#endif
-        SYSTEM_0Print("Entered helloDSP_Execute ()\n");
+    /** ============================================================================
+     *  @func   helloDSP_PrintEcho
+     *
+     *  @desc   Prints a line of the link benchmark.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintEcho(IN const Char8* link, IN Uint32 size,
+                                              IN const EchoStats* latency, IN const EchoStats* stream);
 
-        /* Start the timer */
-#if defined (PROFILE)
-        SYSTEM_GetStartTime();
-#endif
+    /** ============================================================================
+     *  @func   helloDSP_SizePool
+     *
+     *  @desc   Computes the buffer classes and counts of the pool for the
+     *          given workload and the pipeline depth that fits in POOLMEM.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_SizePool(IN Uint32 matrixSize, IN Uint32 pipelineDepth,
+                                                   IN Uint32 batchSize, IN Bool verbose);
 
-        /** 
-         * 4 messages are received from the DSP:
-         *     - first response after the DSP becomes active;
-         *     - acknowledgement after sending the first matrix;
-         *     - first half of result of the matrix multiplication;
-         *     - second half of result of the matrix multiplication.
-         */
-        for (i = 0; ( (i < 4) && (DSP_SUCCEEDED (status)) ); i++)
-        {
-            /* Receive the messages. */
-            if (i < 2)
-                status = MSGQ_get(SampleGppMsgq, WAIT_FOREVER, (MsgqMsg *) &msgS);
-            else
-                status = MSGQ_get(SampleGppMsgq, WAIT_FOREVER, (MsgqMsg *) &msgL);
+    /** ============================================================================
+     *  @func   helloDSP_JoinPool
+     *
+     *  @desc   Takes the buffer classes and the pipeline depth of an
+     *          attached process from the pool of the daemon.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_JoinPool(IN Uint32 matrixSize, IN Uint32 pipelineDepth,
+                                                   IN Uint32 batchSize);
 
-            if (DSP_FAILED(status))
-            {
-                SYSTEM_1Print("MSGQ_get () failed. Status = [0x%x]\n", status);
-            }
-#if defined (VERIFY_DATA)
-            /* Verify correctness of data received. */
-            if (DSP_SUCCEEDED(status))
-            {
-                status = helloDSP_VerifyData(msgS, sequenceNumber);
-                if (DSP_FAILED(status))
-                {
-                    MSGQ_free((MsgqMsg) msgS);
-                }
-            }
-#endif
-            /* Assign matrix pointers */
-            matrixPtS = msgS->arg2;
-            matrixPtL = msgL->arg2;
+    /** ============================================================================
+     *  @func   helloDSP_AddBufClass
+     *
+     *  @desc   Adds buffers of the given size to the pool configuration,
+     *          keeping the classes sorted by size.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_AddBufClass(IN Uint32 size, IN Uint32 count);
 
-            /* Generate the first matrix */
-            if (i == 0) {
+    /** ============================================================================
+     *  @func   helloDSP_AddJobClasses
+     *
+     *  @desc   Adds the row blocks of the given number of jobs to the pool
+     *          configuration, or only counts their bytes.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_AddJobClasses(IN Uint32 matrixSize, IN Uint32 numJobs, IN Bool add);
 
-                /* Matrix generation is not accunted in the elapsed time */
-#if defined (PROFILE)
-                SYSTEM_GetEndTime();
-                elapsedTime += SYSTEM_GetProfileInfo();
-#endif
-                for (j = 0; j < matrixSize; j++)
-                    for (k = 0; k < matrixSize; k++)
-                        matrixPtS[j][k] = j+k*2;
-            
-                /* Start the timer again */
-#if defined (PROFILE)
-                SYSTEM_GetStartTime();
-#endif
-            }
+    /** ============================================================================
+     *  @func   helloDSP_Generate
+     *
+     *  @desc   Generates the operands of the jobs.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_Generate(IN Uint32 matrixSize, IN Uint32 flags,
+                                             OUT Uint16* mat1, OUT Uint16* mat2);
 
-            /* Generate the second matrix */
-            else if (i == 1) {
+    /** ============================================================================
+     *  @func   helloDSP_GenSpecs
+     *
+     *  @desc   Describes the generators of both operands selected by flags.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_GenSpecs(IN Uint32 flags, OUT GenSpec* specs);
+
+    /** ============================================================================
+     *  @func   helloDSP_GenerateOperand
+     *
+     *  @desc   Computes an operand from its generator.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_GenerateOperand(IN const GenSpec* spec, IN Uint32 rows,
+                                                    IN Uint32 cols, IN Uint32 ld, IN Uint16 mask,
+                                                    OUT Uint16* dst);
+
+    /** ============================================================================
+     *  @func   helloDSP_Reference
+     *
+     *  @desc   Computes the product the DSP results are verified against.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_Reference(IN Uint32 matrixSize, IN const Uint16* a,
+                                              IN const Uint16* b, IN Uint32 ld,
+                                              OUT AccumWide* prod);
+
+    /** ============================================================================
+     *  @func   helloDSP_OutputResult
+     *
+     *  @desc   Prints a product in the format selected by flags.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_OutputResult(IN Uint32 matrixSize,
+                                                       IN const AccumWide* result,
+                                                       IN Uint32 flags);
+
+    /** ============================================================================
+     *  @func   helloDSP_MapMatrix
+     *
+     *  @desc   Maps a matrix file holding a square operand.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_MapMatrix(IN Char8* path, IN Uint32 matrixSize,
+                                                    OUT const Uint16** dataPtr,
+                                                    OUT Pvoid* mapPtr, OUT Uint32* mapSizePtr);
+
+    /** ============================================================================
+     *  @func   helloDSP_WriteMatrix
+     *
+     *  @desc   Writes a product to a matrix file.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_WriteMatrix(IN Char8* path, IN Uint32 matrixSize,
+                                                      IN Uint32 elemSize,
+                                                      IN const AccumWide* result);
+
+    /** ============================================================================
+     *  @func   helloDSP_RunBatch
+     *
+     *  @desc   Runs a batch of jobs on the DSP and collects their statistics.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunBatch(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                                   IN Uint16 kernel, IN Uint16 kernelParam,
+                                                   IN Uint16 accum, IN Uint16 elemSize, IN Bool compress,
+                                                   IN const GenSpec* gen,
+                                                   IN const Uint16* a, IN const Uint16* b, IN Uint32 ld,
+                                                   IN const AccumWide* prod,
+                                                   OUT AccumWide* resFromDSP, OUT JobStats* stats);
+
+    /** ============================================================================
+     *  @func   helloDSP_RunGemm
+     *
+     *  @desc   helloDSP_Gemm () with the statistics of its jobs.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunGemm(IN Bool transA, IN Bool transB,
+                                                  IN Uint32 m, IN Uint32 n, IN Uint32 k,
+                                                  IN Uint32 alpha, IN const Uint16* a, IN Uint32 lda,
+                                                  IN const Uint16* b, IN Uint32 ldb,
+                                                  IN Uint32 beta, IN OUT Uint32* c, IN Uint32 ldc,
+                                                  OUT JobStats* stats);
+
+    /** ============================================================================
+     *  @func   helloDSP_GemmRows
+     *
+     *  @desc   Largest number of product rows of a GEMM job whose product
+     *          blocks fit the pool.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_GemmRows(IN Uint32 n);
+
+    /** ============================================================================
+     *  @func   helloDSP_RunGemv
+     *
+     *  @desc   helloDSP_Gemv () with a given number of vectors per message
+     *          and the statistics of its messages.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunGemv(IN Uint32 numVectors, IN Uint32 blockVectors,
+                                                  IN const Uint16* x, IN Uint32 ldx,
+                                                  OUT Uint32* y, IN Uint32 ldy, OUT JobStats* stats);
+
+    /** ============================================================================
+     *  @func   helloDSP_GemvVectors
+     *
+     *  @desc   Most vectors per CMD_VECTORS message that fit the pool.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_GemvVectors(Void);
+
+    /** ============================================================================
+     *  @func   helloDSP_LoadTuning
+     *
+     *  @desc   Sends the tuning table of TUNE_FILE to the DSP, if there is one.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_LoadTuning(Void);
+
+    /** ============================================================================
+     *  @func   helloDSP_SendTuning
+     *
+     *  @desc   Sends a tuning table of TUNE_CLASSES variants to the DSP.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_SendTuning(IN const Uint16* table);
+
+    /** ============================================================================
+     *  @func   helloDSP_QueryStats
+     *
+     *  @desc   Reads the statistics of the DSP.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_QueryStats(OUT DspStats* dspStats);
+
+    /** ============================================================================
+     *  @func   helloDSP_Query
+     *
+     *  @desc   Sends a request without payload and copies the payload of the
+     *          reply.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_Query(IN Uint16 command, IN Uint16 matrixSize,
+                                                IN Uint16 kernelParam, IN Uint16 replyCommand,
+                                                OUT Pvoid payload, IN Uint32 payloadBytes,
+                                                OUT Uint16* dspConfig);
+
+    /** ============================================================================
+     *  @func   helloDSP_PrintDspStats
+     *
+     *  @desc   Prints the DSP statistics between two reports.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintDspStats(IN const DspStats* first, IN const DspStats* last);
+
+    /** ============================================================================
+     *  @func   helloDSP_Monitor
+     *
+     *  @desc   Logs the DSP statistics periodically until termination.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_Monitor(Void);
+
+    /** ============================================================================
+     *  @func   helloDSP_PrintVariant
+     *
+     *  @desc   Prints a variant of the base kernel.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintVariant(IN Uint16 variant);
+
+    /** ============================================================================
+     *  @func   helloDSP_RecordLatency
+     *
+     *  @desc   Adds a latency to one of the latency histograms.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_RecordLatency(IN Uint32 latency, IN Uint32 uSec);
+
+    /** ============================================================================
+     *  @func   helloDSP_JobSubmitted
+     *
+     *  @desc   Counts a job handed over to the DSP.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_JobSubmitted(IN Uint32 start);
+
+    /** ============================================================================
+     *  @func   helloDSP_JobDone
+     *
+     *  @desc   Counts the oldest job in flight as completed or failed.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_JobDone(IN Bool failed);
+
+    /** ============================================================================
+     *  @func   helloDSP_PrintProfile
+     *
+     *  @desc   Prints the flat profile of the GPP by phase.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintProfile(Void);
+
+    /** ============================================================================
+     *  @func   helloDSP_AllocMsg
+     *
+     *  @desc   Allocates an application message of the given size, waiting
+     *          while the pool is exhausted.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_AllocMsg(IN Uint16 size, OUT ControlMsgS** msgPtr);
+
+    /** ============================================================================
+     *  @func   helloDSP_FreeMsg
+     *
+     *  @desc   Frees an application message held by this process.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_FreeMsg(IN MsgqMsg msg);
+
+    /** ============================================================================
+     *  @func   helloDSP_PutMsg
+     *
+     *  @desc   Sends an application message held by this process to the DSP.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_PutMsg(IN MsgqMsg msg);
+
+    /** ============================================================================
+     *  @func   helloDSP_GetMsg
+     *
+     *  @desc   Waits for a message of the DSP.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_GetMsg(OUT MsgqMsg* msgPtr);
+
+    /** ============================================================================
+     *  @func   helloDSP_CountBuffer
+     *
+     *  @desc   Counts the buffer of a message of the given size as taken
+     *          or given back by this process.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_CountBuffer(IN Uint32 size, IN Bool held);
+
+    /** ============================================================================
+     *  @func   helloDSP_ResetPoolPeak
+     *
+     *  @desc   Starts the high-water marks of the pool over.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_ResetPoolPeak(Void);
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaAlloc
+     *
+     *  @desc   Allocates a working buffer from the arena.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_ArenaAlloc(IN Uint32 size, OUT Pvoid* addrPtr);
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaOperands
+     *
+     *  @desc   Allocates the operands and reference product of a square job.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_ArenaOperands(IN Uint32 matrixSize,
+                                                        OUT Uint16** mat1, OUT Uint16** mat2,
+                                                        OUT AccumWide** prod);
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaMark
+     *
+     *  @desc   Returns the current top of the arena.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_ArenaMark(Void);
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaRelease
+     *
+     *  @desc   Releases the buffers allocated since a mark.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_ArenaRelease(IN Uint32 mark);
+
+    /** ============================================================================
+     *  @func   helloDSP_Submit
+     *
+     *  @desc   Sends both operands of a job to the DSP in row blocks.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_Submit(IN Uint16 jobId, IN const JobDesc* job,
+                                                 IN OUT JobStats* stats);
+
+    /** ============================================================================
+     *  @func   helloDSP_NextView
+     *
+     *  @desc   Receives the next row block of the product of a job from the
+     *          DSP as a view into its message.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_NextView(IN Uint16 jobId, IN Uint32 numRows, IN Uint32 numCols,
+                                                   IN Uint32 row, OUT ResultView* view,
+                                                   IN OUT JobStats* stats);
+
+    /** ============================================================================
+     *  @func   helloDSP_ReleaseView
+     *
+     *  @desc   Returns the message of a view to the pool.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_ReleaseView(IN ResultView* view);
+
+    /** ============================================================================
+     *  @func   helloDSP_DrainJobs
+     *
+     *  @desc   Receives and frees the replies of jobs left in flight by a
+     *          failed run.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_DrainJobs(IN Bool open, IN Uint32 jobs);
+
+    /** ============================================================================
+     *  @func   helloDSP_CommitOperand
+     *
+     *  @desc   Sends the blocks of a reserved operand as part of a job.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_CommitOperand(IN Uint16 jobId, IN Uint16 command,
+                                                        IN Uint16 kernel, IN Uint16 kernelParam,
+                                                        IN HELLODSP_Operand* operand,
+                                                        IN OUT JobStats* stats);
+
+    /** ============================================================================
+     *  @func   helloDSP_GatherView
+     *
+     *  @desc   Copies the rows of a view into a contiguous product.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_GatherView(IN const ResultView* view, OUT AccumWide* result,
+                                               IN Uint32 ld);
+
+#if defined (VERIFY_DATA)
+    /** ============================================================================
+     *  @func   helloDSP_VerifyData
+     *
+     *  @desc   This function verifies the data-integrity of given message.
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_VerifyData(IN MSGQ_Msg msgS, IN Uint16 sequenceNumber);
+#endif
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Create
+     *
+     *  @desc   This function allocates and initializes resources used by
+     *          this application. In HELLODSP_ATTACH mode the DSP executable
+     *          is not loaded: the process joins the session of a running
+     *          helloDSP daemon and only has to locate the DSP queue.
+     *          The pool is sized for the given workload and described to
+     *          the DSP; when attaching, the pool of the daemon is used as it
+     *          is and the workload has to fit the jobs it was sized for.
+     *
+     *  @modif  SampleBufSizes, SampleNumBuffers, sessionDepth, sessionSize,
+     *          arenaBase, arenaSize
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Create(IN Char8* dspExecutable, IN HELLODSP_Mode mode,
+                                          IN Uint32 matrixSize, IN Uint32 pipelineDepth,
+                                          IN Uint32 batchSize, IN Uint8 processorId)
+    {
+        DSP_STATUS status = DSP_SOK;
+        DSP_STATUS notifyStatus = DSP_EFAIL;
+        PROC_State procState = ProcState_Unknown;
+        MSGQ_LocateAttrs syncLocateAttrs;
+        DspStats dspStats;
+#if defined (PROFILE)
+        Uint32 loadTime = 0;
+        Uint32 startTime = 0;
+        Uint32 transportTime = 0;
+        Uint32 locateTime = 0;
+
+        createStartTime = SYSTEM_GetUsecTime();
+#endif
+
+        SYSTEM_0Print("Entered helloDSP_Create ()\n");
+
+        sessionMode = mode;
+
+        /* SIGUSR1 asks for a dump of the metrics, see helloDSP_DumpMetrics () */
+        SYSTEM_InstallDumpSignal();
+
+        /* Each attached process needs its own reply queue. */
+        if (mode == HELLODSP_ATTACH)
+        {
+            SYSTEM_1Sprint(SampleGppMsgqName, "GPPMSGQ%d", SYSTEM_GetProcessId());
+        }
+
+        /* Fit the buffers needed by the workload into POOLMEM. An attached
+         * process learns the pool of the daemon once it found the DSP. */
+        if (mode != HELLODSP_ATTACH)
+        {
+            status = helloDSP_SizePool(matrixSize, pipelineDepth, batchSize, TRUE);
+        }
+
+        /* The working buffers of the GPP, allocated once for the session.
+         * A daemon runs no jobs of its own. */
+        if (DSP_SUCCEEDED(status) && (mode != HELLODSP_DAEMON))
+        {
+            status = SYSTEM_AllocAligned(ARENA_BYTES(matrixSize), ARENA_ALIGN, (Pvoid*) &arenaBase);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("Could not allocate %d bytes of working buffers\n", ARENA_BYTES(matrixSize));
+            }
+            else
+            {
+                arenaSize = ARENA_BYTES(matrixSize);
+                arenaUsed = 0;
+            }
+        }
+
+        /* Create and initialize the proc object. */
+        if (DSP_SUCCEEDED(status))
+        {
+            status = PROC_setup(NULL);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("PROC_setup () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Attach the Dsp with which the transfers have to be done. */
+        if (DSP_SUCCEEDED(status))
+        {
+            status = PROC_attach(processorId, NULL);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("PROC_attach () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* An attached process relies on the daemon having started the DSP. */
+        if (DSP_SUCCEEDED(status) && (mode == HELLODSP_ATTACH))
+        {
+            status = PROC_getState(processorId, &procState);
+            if (DSP_SUCCEEDED(status) && (procState != ProcState_Started))
+            {
+                status = DSP_ENOTREADY;
+                SYSTEM_0Print("No helloDSP daemon is running on this DSP\n");
+            }
+        }
+
+        /* Open the pool. The pool and the transport below are already open
+         * when attaching, which DSP/BIOS LINK reports as success, and the
+         * attributes of the daemon apply. */
+        if (DSP_SUCCEEDED(status))
+        {
+            status = POOL_open(POOL_makePoolId(processorId, SAMPLE_POOL_ID), &SamplePoolAttrs);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("POOL_open () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Open the GPP's message queue */
+        if (DSP_SUCCEEDED(status))
+        {
+            status = MSGQ_open(SampleGppMsgqName, &SampleGppMsgq, NULL);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("MSGQ_open () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Set the message queue that will receive any async. errors */
+        if (DSP_SUCCEEDED(status))
+        {
+            status = MSGQ_setErrorHandler(SampleGppMsgq, POOL_makePoolId(processorId, SAMPLE_POOL_ID));
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("MSGQ_setErrorHandler () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Create the semaphore posted by the ready event. */
+        if (DSP_SUCCEEDED(status) && (mode != HELLODSP_ATTACH))
+        {
+            status = SYSTEM_CreateSem(&readySem);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("SYSTEM_CreateSem () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Load the executable on the DSP. */
+        if (DSP_SUCCEEDED(status) && (mode != HELLODSP_ATTACH))
+        {
+            status = PROC_load(processorId, dspExecutable, 0, NULL);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("PROC_load () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+#if defined (PROFILE)
+        loadTime = SYSTEM_GetUsecTime();
+#endif
+
+        /* Start execution on DSP. */
+        if (DSP_SUCCEEDED(status) && (mode != HELLODSP_ATTACH))
+        {
+            status = PROC_start(processorId);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("PROC_start () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Register for the ready event. The DSP retries the notification
+         * until it is accepted, so registering after PROC_start () is safe.
+         * A failure here is not fatal: the locate below falls back to
+         * polling. An attached process finds the DSP queue already open. */
+        if (DSP_SUCCEEDED(status) && (mode != HELLODSP_ATTACH))
+        {
+            notifyStatus = NOTIFY_register(processorId, READY_IPS_ID, READY_EVENT_NO,
+                                           (FnNotifyCbck) helloDSP_ReadyNotify, readySem);
+            if (DSP_FAILED(notifyStatus))
+            {
+                SYSTEM_1Print("NOTIFY_register () failed. Status = [0x%x]\n", notifyStatus);
+            }
+        }
+
+#if defined (PROFILE)
+        startTime = SYSTEM_GetUsecTime();
+#endif
+
+        /* Open the remote transport. */
+        if (DSP_SUCCEEDED(status))
+        {
+            mqtAttrs.poolId = POOL_makePoolId(processorId, SAMPLE_POOL_ID);
+            status = MSGQ_transportOpen(processorId, &mqtAttrs);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("MSGQ_transportOpen () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+#if defined (PROFILE)
+        transportTime = SYSTEM_GetUsecTime();
+#endif
+
+        /* Locate the DSP's message queue */
+        /* At this point the DSP must open a message queue named "DSPMSGQ".
+         * Each attempt first waits for the ready event, so the locate is
+         * normally issued exactly once, right after the DSP opened its queue. */
+        if (DSP_SUCCEEDED(status))
+        {
+            syncLocateAttrs.timeout = WAIT_FOREVER;
+            status = DSP_ENOTFOUND;
+            SYSTEM_2Sprint(dspMsgqName, "%s%d", (Uint32) SampleDspMsgqName, processorId);
+            if (mode == HELLODSP_ATTACH)
+            {
+                /* The daemon's DSP queue is already open: a single locate. */
+                status = MSGQ_locate(dspMsgqName, &SampleDspMsgq, &syncLocateAttrs);
+                if (DSP_FAILED(status))
+                {
+                    SYSTEM_1Print("MSGQ_locate () failed. Status = [0x%x]\n", status);
+                }
+            }
+            while ((mode != HELLODSP_ATTACH)
+                   && ((status == DSP_ENOTFOUND) || (status == DSP_ENOTREADY)))
+            {
+                if (DSP_SUCCEEDED(notifyStatus))
+                {
+                    SYSTEM_WaitSem(readySem, LOCATE_RETRY_USEC);
+                }
+                else
+                {
+                    SYSTEM_Sleep(LOCATE_RETRY_USEC);
+                }
+
+                status = MSGQ_locate(dspMsgqName, &SampleDspMsgq, &syncLocateAttrs);
+                if (DSP_FAILED(status) && (status != DSP_ENOTFOUND) && (status != DSP_ENOTREADY))
+                {
+                    SYSTEM_1Print("MSGQ_locate () failed. Status = [0x%x]\n", status);
+                }
+            }
+        }
+
+        /* The ready event is only needed during startup. */
+        if (DSP_SUCCEEDED(notifyStatus))
+        {
+            NOTIFY_unregister(processorId, READY_IPS_ID, READY_EVENT_NO,
+                              (FnNotifyCbck) helloDSP_ReadyNotify, readySem);
+        }
+
+        /* Tell the DSP what the pool holds, for the processes attaching
+         * later, or find out when attaching. */
+        if (DSP_SUCCEEDED(status) && (mode != HELLODSP_ATTACH))
+        {
+            status = helloDSP_Query(CMD_POOL, (Uint16) sessionSize, (Uint16) sessionDepth,
+                                    CMD_STATS_REPORT, &dspStats, sizeof(DspStats), NULL);
+        }
+        if (DSP_SUCCEEDED(status) && (mode == HELLODSP_ATTACH))
+        {
+            status = helloDSP_JoinPool(matrixSize, pipelineDepth, batchSize);
+        }
+
+        /* The table applies to every process using the DSP, so an
+         * attached process leaves the daemon's in place. */
+        if (DSP_SUCCEEDED(status) && (mode != HELLODSP_ATTACH))
+        {
+            status = helloDSP_LoadTuning();
+        }
+
+#if defined (PROFILE)
+        if (DSP_SUCCEEDED(status))
+        {
+            locateTime = SYSTEM_GetUsecTime();
+            SYSTEM_1Print("Startup: setup and load   %d uSec\n", loadTime - createStartTime);
+            SYSTEM_1Print("Startup: DSP start        %d uSec\n", startTime - loadTime);
+            SYSTEM_1Print("Startup: transport open   %d uSec\n", transportTime - startTime);
+            SYSTEM_1Print("Startup: DSP ready/locate %d uSec\n", locateTime - transportTime);
+            SYSTEM_1Print("Startup: total            %d uSec\n", locateTime - createStartTime);
+        }
+#endif
+
+        SYSTEM_0Print("Leaving helloDSP_Create ()\n");
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Execute
+     *
+     *  @desc   This function implements the execute phase for this application.
+     *          A batch of jobs is run with up to sessionDepth jobs in
+     *          flight: new jobs are submitted while earlier ones are being
+     *          computed, and the product of each job is verified as it
+     *          comes back. The operands are generated or read from mapped
+     *          matrix files, or, with HELLODSP_DSPGEN, generated by the DSP
+     *          as well as here for verification. The statistics of the DSP
+     *          over the batch are printed with those of the jobs, and the
+     *          product of the last job is printed or written to a matrix
+     *          file.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Execute(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                           IN Uint16 kernel, IN Uint16 kernelParam,
+                                           IN Uint32 flags, IN Char8* inputA, IN Char8* inputB,
+                                           IN Char8* output, IN Uint8 processorId)
+    {
+        DSP_STATUS  status = DSP_SOK;
+        Uint16 accum = (flags & HELLODSP_WRAP) ? ACCUM_WRAP : ACCUM_CHECKED;
+        Uint16 elemSize = (flags & HELLODSP_PACKED) ? sizeof(Uint8) : sizeof(Uint16);
+        Bool compress = (flags & HELLODSP_COMPRESS) != 0;
+        JobStats stats;
+        GenSpec specs[2];
+        const GenSpec* gen = NULL;
+        DspStats dspBefore;
+        DspStats dspAfter;
+        Bool dspStats = FALSE;
+        Uint32 arenaMark = helloDSP_ArenaMark();
+        Uint32 i;
+
+        /* Operands of every job, generated or mapped, with a row stride of
+         * matrixSize */
+        Uint16* mat1 = NULL;
+        Uint16* mat2 = NULL;
+        const Uint16* a = NULL;
+        const Uint16* b = NULL;
+        Pvoid mapA = NULL;
+        Pvoid mapB = NULL;
+        Uint32 mapSizeA = 0;
+        Uint32 mapSizeB = 0;
+
+        /* Variable to store product matrix from the DSP */
+        AccumWide* resFromDSP = NULL;
+
+#if defined (VERIF_MULT)
+        /* Matrix for verification purposes */
+        AccumWide* prod = NULL;
+#endif
+        (Void) processorId;
+
+        SYSTEM_0Print("Entered helloDSP_Execute ()\n");
+
+        status = helloDSP_ArenaAlloc(matrixSize * matrixSize * sizeof(AccumWide), (Pvoid*) &resFromDSP);
+#if defined (VERIF_MULT)
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(matrixSize * matrixSize * sizeof(AccumWide), (Pvoid*) &prod);
+        }
+#endif
+
+        /* Generate the matrices or map them; jobs read mapped operands in
+         * place. Neither is accounted in the elapsed time. */
+        if (DSP_SUCCEEDED(status) && (inputA != NULL))
+        {
+            status = helloDSP_MapMatrix(inputA, matrixSize, &a, &mapA, &mapSizeA);
+            if (DSP_SUCCEEDED(status))
+            {
+                status = helloDSP_MapMatrix(inputB, matrixSize, &b, &mapB, &mapSizeB);
+            }
+        }
+        else if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(matrixSize * matrixSize * sizeof(Uint16), (Pvoid*) &mat1);
+            if (DSP_SUCCEEDED(status))
+            {
+                status = helloDSP_ArenaAlloc(matrixSize * matrixSize * sizeof(Uint16), (Pvoid*) &mat2);
+            }
+            if (DSP_SUCCEEDED(status))
+            {
+                PHASE_ENTER(PHASE_PACK);
+                helloDSP_Generate(matrixSize, flags, mat1, mat2);
+                PHASE_ENTER(PHASE_OTHER);
+                a = mat1;
+                b = mat2;
+            }
+
+            /* The DSP generates dense operands only */
+            if ((flags & HELLODSP_DSPGEN) && !(flags & HELLODSP_SPARSE))
+            {
+                helloDSP_GenSpecs(flags, specs);
+                gen = specs;
+            }
+        }
+
+        /* The DSP statistics are optional: a DSP image that does not
+         * report them rejects the request */
+        if (DSP_SUCCEEDED(status))
+        {
+            dspStats = DSP_SUCCEEDED(helloDSP_QueryStats(&dspBefore));
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+#if defined (VERIF_MULT)
+            PHASE_ENTER(PHASE_VERIFY);
+            helloDSP_Reference(matrixSize, a, b, matrixSize, prod);
+            PHASE_ENTER(PHASE_OTHER);
+            status = helloDSP_RunBatch(matrixSize, batchSize, kernel, kernelParam, accum, elemSize,
+                                       compress, gen, a, b, matrixSize, prod, resFromDSP, &stats);
+#else
+            status = helloDSP_RunBatch(matrixSize, batchSize, kernel, kernelParam, accum, elemSize,
+                                       compress, gen, a, b, matrixSize, NULL, resFromDSP, &stats);
+#endif
+        }
+
+        if (DSP_SUCCEEDED(status) && dspStats)
+        {
+            dspStats = DSP_SUCCEEDED(helloDSP_QueryStats(&dspAfter));
+        }
+
+        SYSTEM_UnmapFile(mapA, mapSizeA);
+        SYSTEM_UnmapFile(mapB, mapSizeB);
+
+        /* Print or write the result of the last job.
+         * This is not accounted in the elapsed time */
+        PHASE_ENTER(PHASE_UNPACK);
+        if (DSP_SUCCEEDED(status) && (output != NULL))
+        {
+            status = helloDSP_WriteMatrix(output, matrixSize,
+                                          (accum == ACCUM_WRAP) ? sizeof(Uint32) : sizeof(AccumWide),
+                                          resFromDSP);
+        }
+        else if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_OutputResult(matrixSize, resFromDSP, flags);
+        }
+        PHASE_ENTER(PHASE_OTHER);
+
+        if (DSP_SUCCEEDED(status))
+        {
+
+#if defined (VERIF_MULT)
+            SYSTEM_0Print("\n\nMultiplication result has been verified and it is ");
+            if (stats.incorrect == 0)
+                SYSTEM_0Print("CORRECT");
+            else
+                SYSTEM_0Print("NOT CORRECT");
+#endif
+
+            SYSTEM_0Print("\n\n");
+            SYSTEM_0Print((DSPCONFIG_PROFILE(stats.dspConfig) == MEMPROFILE_SRAM)
+                          ? "DSP memory profile: sram" : "DSP memory profile: ddr");
+            SYSTEM_1Print(", L2 cache %d KB\n", DSPCONFIG_L2CACHE(stats.dspConfig));
+            if (kernel == KERNEL_STRASSEN)
+                SYSTEM_1Print("Kernel: Strassen-Winograd, cutoff %d\n", kernelParam);
+            else
+                SYSTEM_0Print("Kernel: base\n");
+            SYSTEM_0Print((elemSize == sizeof(Uint8)) ? "Operands: 8-bit" : "Operands: 16-bit");
+            SYSTEM_2Print(", %d of %d sent in CSR form", stats.sparseOperands, 2 * stats.jobs);
+            SYSTEM_1Print(", %d delta-coded", stats.deltaOperands);
+            SYSTEM_1Print(", %d generated by the DSP\n", stats.generatedOperands);
+            SYSTEM_2Print("Jobs run by the sparse kernel: %d of %d\n", stats.sparseJobs, stats.jobs);
+            if (accum == ACCUM_WRAP)
+                SYSTEM_0Print("Accumulation: 32-bit, modulo 2^32\n");
+            else
+                SYSTEM_2Print("Accumulation: checked, %d of %d jobs needed 64-bit products\n",
+                              stats.wideJobs, stats.jobs);
+            SYSTEM_1Print("Cycles spent on multiplication per job: %d\n", stats.cycles / stats.jobs);
+            SYSTEM_2Print("Cache maintenance per job on DSP: %d bytes, %d cycles of writeback\n",
+                          stats.dspCacheBytes / stats.jobs, stats.dspCacheCycles / stats.jobs);
+            SYSTEM_2Print("Cache maintenance per job on GPP: %d bytes, %d uSec in MSGQ_put ()\n",
+                          stats.gppCacheBytes / stats.jobs, stats.gppSendTime / stats.jobs);
+            SYSTEM_2Print("Jobs: %d, at most %d in flight\n", stats.jobs, stats.jobsPeak);
+            SYSTEM_2Print("Pool high-water mark: %d application buffers, %d bytes\n",
+                          stats.buffersPeak, stats.bytesPeak);
+            for (i = 0; i < SamplePoolAttrs.numBufPools; i++)
+            {
+                if (poolHeldPeak[i] > 0)
+                {
+                    SYSTEM_2Print("  %d buffers of %d bytes", poolHeldPeak[i], SampleBufSizes[i]);
+                    SYSTEM_1Print(" of %d\n", SampleNumBuffers[i]);
+                }
+            }
+            if (dspStats)
+                helloDSP_PrintDspStats(&dspBefore, &dspAfter);
+        }
+
+#if defined (PROFILE)
+        if (DSP_SUCCEEDED(status))
+        {
+            SYSTEM_1Print("Time taken to exchange messages and compute the result: %d uSec\n", stats.elapsedTime);
+            SYSTEM_1Print("Average time per job: %d uSec\n", stats.elapsedTime / stats.jobs);
+        }
+#endif
+
+        helloDSP_ArenaRelease(arenaMark);
+
+        SYSTEM_0Print("Leaving helloDSP_Execute ()\n");
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Crossover
+     *
+     *  @desc   Runs the batch with the base kernel and with Strassen-Winograd
+     *          at every cutoff from half the matrix size down to the smallest
+     *          one, halving each time, and reports the fastest. Each halving
+     *          adds a level of recursion, so the fastest cutoff is the size
+     *          below which a further level no longer pays off.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Crossover(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                             IN Uint32 flags, IN Uint8 processorId)
+    {
+        DSP_STATUS  status = DSP_SOK;
+        Uint16 accum = (flags & HELLODSP_WRAP) ? ACCUM_WRAP : ACCUM_CHECKED;
+        Uint16 elemSize = (flags & HELLODSP_PACKED) ? sizeof(Uint8) : sizeof(Uint16);
+        Bool compress = (flags & HELLODSP_COMPRESS) != 0;
+        JobStats stats;
+        Uint16 cutoff = 0;
+        Uint16 bestCutoff = 0;
+        Uint32 bestCycles = 0;
+        Uint32 arenaMark = helloDSP_ArenaMark();
+        Uint16* mat1 = NULL;
+        Uint16* mat2 = NULL;
+        AccumWide* prod = NULL;
+        GenSpec specs[2];
+        const GenSpec* gen = NULL;
+        (Void) processorId;
+
+        SYSTEM_0Print("Entered helloDSP_Crossover ()\n");
+
+        status = helloDSP_ArenaOperands(matrixSize, &mat1, &mat2, &prod);
+        if (DSP_SUCCEEDED(status))
+        {
+            helloDSP_Generate(matrixSize, flags, mat1, mat2);
+            if ((flags & HELLODSP_DSPGEN) && !(flags & HELLODSP_SPARSE))
+            {
+                helloDSP_GenSpecs(flags, specs);
+                gen = specs;
+            }
+            helloDSP_Reference(matrixSize, mat1, mat2, matrixSize, prod);
+
+            SYSTEM_1Print("Strassen-Winograd crossover, matrix size %d\n", matrixSize);
+            SYSTEM_0Print("cutoff\tcycles/job\tuSec/job\tcorrect\n");
+        }
+
+        /* Cutoff 0 stands for the base kernel */
+        while (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_RunBatch(matrixSize, batchSize,
+                                       (cutoff == 0) ? KERNEL_BASE : KERNEL_STRASSEN, cutoff, accum, elemSize,
+                                       compress, gen, mat1, mat2, matrixSize, prod, NULL, &stats);
+            if (DSP_SUCCEEDED(status))
+            {
+                if (cutoff == 0)
+                    SYSTEM_0Print("base");
+                else
+                    SYSTEM_1Print("%d", cutoff);
+                SYSTEM_2Print("\t%d\t\t%d", stats.cycles / stats.jobs, stats.elapsedTime / stats.jobs);
+                SYSTEM_0Print((stats.incorrect == 0) ? "\t\tyes\n" : "\t\tNO\n");
+
+                if ((stats.incorrect == 0) && ((cutoff == 0) || (stats.cycles < bestCycles)))
+                {
+                    bestCycles = stats.cycles;
+                    bestCutoff = cutoff;
+                }
+            }
+
+            /* Next cutoff */
+            cutoff = (cutoff == 0) ? (Uint16) ((matrixSize + 1) / 2) : (Uint16) ((cutoff + 1) / 2);
+            if (cutoff < STRASSEN_MIN_CUTOFF)
+                break;
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            if (bestCutoff == 0)
+                SYSTEM_0Print("Fastest: base kernel\n");
+            else
+                SYSTEM_1Print("Fastest: Strassen-Winograd with cutoff %d\n", bestCutoff);
+        }
+
+        helloDSP_ArenaRelease(arenaMark);
+
+        SYSTEM_0Print("Leaving helloDSP_Crossover ()\n");
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Tune
+     *
+     *  @desc   Times every variant of the base kernel on the top size of
+     *          each size class up to matrixSize and on three quarters of
+     *          it, so that both the sizes with a specialised kernel and the
+     *          others count. The fastest correct variant of each class goes
+     *          into the tuning table, which is saved to TUNE_FILE and sent
+     *          to the DSP. Classes above matrixSize keep the default.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Tune(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                        IN Uint32 flags, IN Uint8 processorId)
+    {
+        DSP_STATUS  status = DSP_SOK;
+        JobStats stats;
+        FILE* file;
+        Uint16 table[TUNE_CLASSES];
+        Uint16 variants[TUNE_VARIANTS];
+        Uint32 numVariants = 0;
+        Uint32 sizes[2];
+        Uint32 cycles;
+        Uint32 defaultCycles = 0;
+        Uint32 bestCycles = 0;
+        Uint16 best;
+        Bool found;
+        Bool correct;
+        Uint32 c, i, s, t;
+        Uint32 arenaMark = helloDSP_ArenaMark();
+        Uint16* mat1 = NULL;
+        Uint16* mat2 = NULL;
+        AccumWide* prod = NULL;
+        (Void) processorId;
+
+        SYSTEM_0Print("Entered helloDSP_Tune ()\n");
+
+        /* Sized for the largest class timed; smaller ones are packed with
+         * their own row stride. */
+        status = helloDSP_ArenaOperands(matrixSize, &mat1, &mat2, &prod);
+
+        /* The default kernel first, so that it wins ties */
+        variants[numVariants++] = VARIANT_FIXED;
+        for (t = 4; t <= 16; t *= 2)
+        {
+            variants[numVariants++] = (Uint16) t;
+            variants[numVariants++] = (Uint16) (t | VARIANT_UNROLL4);
+            variants[numVariants++] = (Uint16) (t | VARIANT_AXPY);
+            variants[numVariants++] = (Uint16) (t | VARIANT_DIRECT);
+            variants[numVariants++] = (Uint16) (t | VARIANT_UNROLL4 | VARIANT_DIRECT);
+            variants[numVariants++] = (Uint16) (t | VARIANT_AXPY | VARIANT_DIRECT);
+        }
+
+        SYSTEM_0Print("sizes\t\tvariant\t\t\tcycles/job\tdefault\n");
+
+        for (c = 0; DSP_SUCCEEDED(status) && (c < TUNE_CLASSES); c++)
+        {
+            table[c] = 0;
+            sizes[0] = 4 << c;
+            sizes[1] = 3 << c;
+            if (sizes[0] > matrixSize)
+                continue;
+
+            /* Each class starts afresh: a variant that computed wrong
+             * products here must not leave the figures of the last one. */
+            best = 0;
+            bestCycles = 0;
+            defaultCycles = 0;
+            found = FALSE;
+            for (i = 0; DSP_SUCCEEDED(status) && (i < numVariants); i++)
+            {
+                cycles = 0;
+                correct = TRUE;
+                for (s = 0; DSP_SUCCEEDED(status) && (s < 2); s++)
+                {
+                    helloDSP_Generate(sizes[s], flags & HELLODSP_FULLRANGE, mat1, mat2);
+                    helloDSP_Reference(sizes[s], mat1, mat2, sizes[s], prod);
+                    status = helloDSP_RunBatch(sizes[s], batchSize, KERNEL_BASE, variants[i],
+                                               ACCUM_WRAP, sizeof(Uint16), FALSE, NULL, mat1, mat2,
+                                               sizes[s], prod, NULL, &stats);
+                    cycles += stats.cycles;
+                    if (stats.incorrect != 0)
+                        correct = FALSE;
+                }
+
+                if (DSP_SUCCEEDED(status) && !correct)
+                {
+                    SYSTEM_1Print("Variant 0x%x computed wrong products, skipped\n", variants[i]);
+                }
+                else if (DSP_SUCCEEDED(status))
+                {
+                    if (i == 0)
+                        defaultCycles = cycles;
+                    if (!found || (cycles < bestCycles))
+                    {
+                        bestCycles = cycles;
+                        best = variants[i];
+                        found = TRUE;
+                    }
+                }
+            }
+
+            if (DSP_SUCCEEDED(status))
+            {
+                table[c] = (best == VARIANT_FIXED) ? 0 : best;
+                SYSTEM_2Print("%d, %d\t\t", sizes[1], sizes[0]);
+                helloDSP_PrintVariant(table[c]);
+                SYSTEM_2Print("\t%d\t\t%d\n", bestCycles / (2 * batchSize), defaultCycles / (2 * batchSize));
+            }
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            file = fopen(TUNE_FILE, "w");
+            if (file == NULL)
+            {
+                SYSTEM_0Print("Could not write " TUNE_FILE "\n");
+            }
+            else
+            {
+                for (c = 0; c < TUNE_CLASSES; c++)
+                    fprintf(file, "%u 0x%04x\n", (unsigned int) (4 << c), (unsigned int) table[c]);
+                fclose(file);
+                SYSTEM_0Print("Tuning table saved to " TUNE_FILE "\n");
+            }
+
+            status = helloDSP_SendTuning(table);
+        }
+
+        helloDSP_ArenaRelease(arenaMark);
+
+        SYSTEM_0Print("Leaving helloDSP_Tune ()\n");
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Bench
+     *
+     *  @desc   Sends a CMD_BENCH message and prints the table of the report:
+     *          the cycles per multiply-accumulate of each kernel and size,
+     *          with the operands fetched from DDR2 and then cached, and the
+     *          speedup of the warm run. Sizes that are not a power of two
+     *          take the general path of the specialised kernel.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Bench(IN Uint8 processorId)
+    {
+        DSP_STATUS status = DSP_SOK;
+        const Char8* benchKernels[BENCH_KERNELS] = { "naive", "transposed", "tiled",
+                                                     "simd", "fixed" };
+        BenchEntry table[BENCH_ENTRIES];
+        Uint16 dspConfig = 0;
+        AccumWide macs;
+        AccumWide cold;
+        AccumWide warm;
+        Uint32 i;
+        (Void) processorId;
+
+        SYSTEM_0Print("Entered helloDSP_Bench ()\n");
+
+        status = helloDSP_Query(CMD_BENCH, 0, 0, CMD_BENCH_REPORT, table, sizeof(table), &dspConfig);
+
+        if (DSP_SUCCEEDED(status))
+        {
+            SYSTEM_0Print((DSPCONFIG_PROFILE(dspConfig) == MEMPROFILE_SRAM)
+                          ? "DSP memory profile: sram" : "DSP memory profile: ddr");
+            SYSTEM_1Print(", L2 cache %d KB\n", DSPCONFIG_L2CACHE(dspConfig));
+            SYSTEM_0Print("size\tkernel\t\tcold\twarm\t(cycles/MAC)\tspeedup\n");
+
+            /* Entries come in pairs, cold run first */
+            for (i = 0; i + 1 < BENCH_ENTRIES; i += 2)
+            {
+                if ((table[i].kernel >= BENCH_KERNELS) || table[i].warm || !table[i + 1].warm)
+                {
+                    status = DSP_EFAIL;
+                    SYSTEM_1Print("Malformed benchmark entry %d\n", i);
+                    break;
+                }
+                macs = (AccumWide) table[i].matrixSize * table[i].matrixSize * table[i].matrixSize;
+                cold = DSPSTATS_CYCLES(table[i].cycles) * 100 / macs;
+                warm = DSPSTATS_CYCLES(table[i + 1].cycles) * 100 / macs;
+                SYSTEM_1Print("%d\t", table[i].matrixSize);
+                SYSTEM_1Print("%-12s\t", (Uint32) benchKernels[table[i].kernel]);
+                SYSTEM_2Print("%d.%02d\t", (Uint32) (cold / 100), (Uint32) (cold % 100));
+                SYSTEM_2Print("%d.%02d\t\t", (Uint32) (warm / 100), (Uint32) (warm % 100));
+                SYSTEM_1Print("%d%%\n", (warm == 0) ? 0 : (Uint32) (cold * 100 / warm));
+            }
+        }
+
+        SYSTEM_0Print("Leaving helloDSP_Bench ()\n");
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_LinkBench
+     *
+     *  @desc   Times round trips to the DSP one at a time and streams of up
+     *          to LINKBENCH_WINDOW in flight. MSGQ messages are echoed from
+     *          CTRLMSG_MIN_SIZE, the smallest application message, doubling
+     *          up to the largest buffer of the pool. They are first bounced
+     *          untouched, so only the headers and the cache maintenance of
+     *          the transport are paid for, then with the payload written
+     *          by the GPP, complemented and written back by the DSP, and
+     *          checked. NOTIFY events, which carry 32 bits and cannot be
+     *          pipelined, are echoed last.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_LinkBench(IN Uint8 processorId)
+    {
+        DSP_STATUS status = DSP_SOK;
+        const Char8* modes[2] = { "bounce", "touch" };
+        EchoStats latency;
+        EchoStats stream;
+        Uint32 maxSize = SampleBufSizes[SamplePoolAttrs.numBufPools - 1];
+        Uint32 size;
+        Uint32 touch;
+
+        SYSTEM_0Print("Entered helloDSP_LinkBench ()\n");
+
+        SYSTEM_0Print("link\t\tbytes\tround trip (us)\tMB/s\twindow\tDSP touch/wb (cycles)\n");
+        for (touch = 0; DSP_SUCCEEDED(status) && (touch < 2); touch++)
+        {
+            size = CTRLMSG_MIN_SIZE;
+            while (DSP_SUCCEEDED(status) && (size <= maxSize))
+            {
+                status = helloDSP_RunEcho((Uint16) size, 1, (Bool) touch, &latency);
+                if (DSP_SUCCEEDED(status))
+                {
+                    status = helloDSP_RunEcho((Uint16) size, LINKBENCH_WINDOW, (Bool) touch, &stream);
+                }
+                if (DSP_SUCCEEDED(status))
+                {
+                    helloDSP_PrintEcho(modes[touch], size, &latency, &stream);
+                }
+                size = ((size < maxSize) && (2 * size > maxSize)) ? maxSize : 2 * size;
+            }
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_RunNotifyEcho(processorId, &latency);
+            if (DSP_SUCCEEDED(status))
+            {
+                helloDSP_PrintEcho("notify", sizeof(Uint32), &latency, &latency);
+            }
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            SYSTEM_0Print((DSPCONFIG_PROFILE(stream.dspConfig) == MEMPROFILE_SRAM)
+                          ? "DSP memory profile: sram" : "DSP memory profile: ddr");
+            SYSTEM_1Print(", L2 cache %d KB\n", DSPCONFIG_L2CACHE(stream.dspConfig));
+        }
+
+        SYSTEM_0Print("Leaving helloDSP_LinkBench ()\n");
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Gemm
+     *
+     *  @desc   Computes C = alpha * op(A) * op(B) + beta * C on the DSP,
+     *          modulo 2^32. The operands are sent straight from the given
+     *          storage, submatrices included, and the product is added into
+     *          C in place as it comes back. The rows of C are split over as
+     *          many jobs as the pool needs, kept sessionDepth in flight.
+     *
+     *  @modif  c
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Gemm(IN Bool transA, IN Bool transB,
+                                        IN Uint32 m, IN Uint32 n, IN Uint32 k,
+                                        IN Uint32 alpha, IN const Uint16* a, IN Uint32 lda,
+                                        IN const Uint16* b, IN Uint32 ldb,
+                                        IN Uint32 beta, IN OUT Uint32* c, IN Uint32 ldc)
+    {
+        JobStats stats;
+
+        return helloDSP_RunGemm(transA, transB, m, n, k, alpha, a, lda, b, ldb,
+                                beta, c, ldc, &stats);
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemmCheck
+     *
+     *  @desc   Runs a GEMM on submatrices of the generated operands for each
+     *          combination of transposes, and verifies C against a
+     *          reference computed here.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_GemmCheck(IN Uint32 matrixSize, IN Uint32 flags,
+                                             IN Uint8 processorId)
+    {
+        DSP_STATUS  status = DSP_SOK;
+        JobStats stats;
+        Char8* names[4] = { "A * B    ", "A^T * B  ", "A * B^T  ", "A^T * B^T" };
+        Uint32 m = matrixSize;
+        Uint32 n = (matrixSize + 1) / 2;
+        Uint32 k = matrixSize - matrixSize / 3;
+        Uint32 alpha = 3;
+        Uint32 beta = 2;
+        Uint32 trans;
+        Uint32 incorrect;
+        Uint32 sum;
+        Uint32 i, j, l;
+        Uint32 arenaMark = helloDSP_ArenaMark();
+        Uint32 ld = matrixSize;
+        Uint16* mat1 = NULL;
+        Uint16* mat2 = NULL;
+        Uint32* c = NULL;
+        (Void) processorId;
+
+        SYSTEM_0Print("Entered helloDSP_GemmCheck ()\n");
+
+        status = helloDSP_ArenaAlloc(ld * ld * sizeof(Uint16), (Pvoid*) &mat1);
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(ld * ld * sizeof(Uint16), (Pvoid*) &mat2);
+        }
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(ld * ld * sizeof(Uint32), (Pvoid*) &c);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            helloDSP_Generate(matrixSize, flags, mat1, mat2);
+
+            SYSTEM_2Print("GEMM C = %d * op(A) * op(B) + %d * C", alpha, beta);
+            SYSTEM_2Print(", M = %d, N = %d", m, n);
+            SYSTEM_1Print(", K = %d\n", k);
+            SYSTEM_0Print("op\t\tcycles\tuSec\tcorrect\n");
+        }
+
+        for (trans = 0; DSP_SUCCEEDED(status) && (trans <= (TRANS_A | TRANS_B)); trans++)
+        {
+            for (i = 0; i < m; i++)
+                for (j = 0; j < n; j++)
+                    c[i * ld + j] = i + j;
+
+            status = helloDSP_RunGemm((trans & TRANS_A) != 0, (trans & TRANS_B) != 0, m, n, k,
+                                      alpha, mat1, ld, mat2, ld, beta, c, ld, &stats);
+            if (DSP_SUCCEEDED(status))
+            {
+                incorrect = 0;
+                for (i = 0; i < m; i++)
+                    for (j = 0; j < n; j++)
+                    {
+                        sum = 0;
+                        for (l = 0; l < k; l++)
+                            sum += ((trans & TRANS_A) ? (Uint32) mat1[l * ld + i] : (Uint32) mat1[i * ld + l])
+                                   * ((trans & TRANS_B) ? (Uint32) mat2[j * ld + l] : (Uint32) mat2[l * ld + j]);
+                        if (c[i * ld + j] != alpha * sum + beta * (i + j))
+                            incorrect++;
+                    }
+
+                SYSTEM_0Print(names[trans]);
+                SYSTEM_2Print("\t%d\t%d", stats.cycles, stats.elapsedTime);
+                SYSTEM_0Print((incorrect == 0) ? "\tyes\n" : "\tNO\n");
+            }
+        }
+
+        helloDSP_ArenaRelease(arenaMark);
+
+        SYSTEM_0Print("Leaving helloDSP_GemmCheck ()\n");
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemvLoad
+     *
+     *  @desc   Sends A to the DSP in CMD_LOAD_A row blocks, read in place,
+     *          and waits for the DSP to acknowledge it. A stays on the DSP
+     *          for helloDSP_Gemv () until another matrix is loaded. When a
+     *          block is rejected, the rejections of the blocks sent after
+     *          it are collected as well.
+     *
+     *  @modif  gemvRows, gemvCols
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_GemvLoad(IN Uint32 m, IN Uint32 k,
+                                            IN const Uint16* a, IN Uint32 lda)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* blocks[MAX_OPERAND_BLOCKS];
+        ControlMsgS* ack;
+        const Uint16* row;
+        Uint32 blockRows = 0;
+        Uint32 numBlocks = 0;
+        Uint32 allocated = 0;
+        Uint32 sent = 0;
+        Uint32 pending = 0;
+        Uint32 rowStart;
+        Uint32 numRows;
+        Uint16 size;
+        Uint32 i, j, l;
+
+        gemvRows = 0;
+        gemvCols = 0;
+
+        if ((m == 0) || (k == 0) || (m > sessionSize) || (k > sessionSize) || (lda < k))
+        {
+            status = DSP_EINVALIDARG;
+            SYSTEM_1Print("ERROR! GEMV dimensions must be between 1 and %d and fit the stride\n",
+                          sessionSize);
+        }
+        else
+        {
+            blockRows = CTRLMSG_ROW_BLOCK_ROWS(m, k, sizeof(Uint16));
+            numBlocks = CTRLMSG_ROW_BLOCKS(m, k, sizeof(Uint16));
+        }
+
+        while (DSP_SUCCEEDED(status) && (allocated < numBlocks))
+        {
+            rowStart = allocated * blockRows;
+            numRows = (m - rowStart < blockRows) ? (m - rowStart) : blockRows;
+            status = helloDSP_AllocMsg(CTRLMSG_SIZE(numRows * k * sizeof(Uint16)), &blocks[allocated]);
+            if (DSP_SUCCEEDED(status))
+            {
+                allocated++;
+            }
+        }
+
+        for (i = 0; DSP_SUCCEEDED(status) && (i < allocated); i++)
+        {
+            rowStart = i * blockRows;
+            numRows = (m - rowStart < blockRows) ? (m - rowStart) : blockRows;
+
+            blocks[i]->command = CMD_LOAD_A;
+            blocks[i]->matrixSize = 0;
+            blocks[i]->jobId = 0;
+            blocks[i]->rowStart = rowStart;
+            blocks[i]->numRows = numRows;
+            blocks[i]->kernel = KERNEL_BASE;
+            blocks[i]->kernelParam = 0;
+            blocks[i]->accum = ACCUM_WRAP;
+            blocks[i]->elemSize = sizeof(Uint16);
+            blocks[i]->format = FORMAT_DENSE;
+            blocks[i]->nnz = 0;
+            blocks[i]->dimM = m;
+            blocks[i]->dimN = 0;
+            blocks[i]->dimK = k;
+            blocks[i]->trans = 0;
+            blocks[i]->alpha = 1;
+            for (j = 0; j < numRows; j++)
+            {
+                row = a + (rowStart + j) * lda;
+                for (l = 0; l < k; l++)
+                    blocks[i]->arg2[j * k + l] = row[l];
+            }
+
+            MSGQ_setMsgId((MsgqMsg) blocks[i], 0);
+            MSGQ_setSrcQueue((MsgqMsg) blocks[i], SampleGppMsgq);
+        }
+
+        while (DSP_SUCCEEDED(status) && (sent < allocated))
+        {
+            size = MSGQ_getMsgSize((MsgqMsg) blocks[sent]);
+            status = helloDSP_PutMsg((MsgqMsg) blocks[sent]);
+            if (DSP_SUCCEEDED(status))
+            {
+                METRIC_SENT(size);
+                sent++;
+            }
+            else
+            {
+                SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Free what was not handed over to the DSP */
+        for (i = sent; i < allocated; i++)
+        {
+            helloDSP_FreeMsg((MsgqMsg) blocks[i]);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_GetMsg((MsgqMsg *) &ack);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("MSGQ_get () failed. Status = [0x%x]\n", status);
+            }
+            else
+            {
+                METRIC_RECEIVED(ack);
+                if (ack->command == CMD_LOADED)
+                {
+                    gemvRows = m;
+                    gemvCols = k;
+                }
+                else
+                {
+                    status = DSP_EFAIL;
+                    SYSTEM_0Print("DSP rejected the resident matrix\n");
+                    /* The DSP abandons the load at the rejected block, so
+                     * each block sent after it comes back rejected too. */
+                    if ((ack->command == CMD_ERROR) && (ack->rowStart / blockRows < sent))
+                    {
+                        pending = sent - 1 - ack->rowStart / blockRows;
+                    }
+                }
+                helloDSP_FreeMsg((MsgqMsg) ack);
+            }
+        }
+
+        /* Collect those rejections, lest they be taken for the replies to
+         * later requests. */
+        while (pending > 0)
+        {
+            if (DSP_FAILED(helloDSP_GetMsg((MsgqMsg *) &ack)))
+            {
+                break;
+            }
+            METRIC_RECEIVED(ack);
+            helloDSP_FreeMsg((MsgqMsg) ack);
+            pending--;
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Gemv
+     *
+     *  @desc   Computes y = A * x for each of a stream of vectors with the
+     *          A loaded by helloDSP_GemvLoad (), as many vectors per message
+     *          as the pool allows, up to GEMV_MAX_VECTORS.
+     *
+     *  @modif  y
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Gemv(IN Uint32 numVectors, IN const Uint16* x, IN Uint32 ldx,
+                                        OUT Uint32* y, IN Uint32 ldy)
+    {
+        JobStats stats;
+
+        return helloDSP_RunGemv(numVectors, helloDSP_GemvVectors(), x, ldx, y, ldy, &stats);
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemvCheck
+     *
+     *  @desc   Loads the first generated operand as A and streams the rows
+     *          of the second through helloDSP_Gemv () batchSize times, with
+     *          1, 4, 16 and 64 vectors per message. Prints the DSP cycles,
+     *          shared bytes and throughput per vector of each, and whether
+     *          the products verified.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_GemvCheck(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                             IN Uint32 flags, IN Uint8 processorId)
+    {
+        DSP_STATUS  status = DSP_SOK;
+        JobStats stats;
+        Uint32 maxVectors;
+        Uint32 blockVectors;
+        Uint32 vectors;
+        Uint32 cycles;
+        Uint32 bytes;
+        Uint32 elapsedTime;
+        Uint32 incorrect;
+        Uint32 sum;
+        Uint32 b, i, l, v;
+        Uint32 arenaMark = helloDSP_ArenaMark();
+        Uint32 ld = matrixSize;
+        Uint16* mat1 = NULL;
+        Uint16* mat2 = NULL;
+        Uint32* y = NULL;
+        (Void) processorId;
+
+        SYSTEM_0Print("Entered helloDSP_GemvCheck ()\n");
+
+        status = helloDSP_ArenaAlloc(ld * ld * sizeof(Uint16), (Pvoid*) &mat1);
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(ld * ld * sizeof(Uint16), (Pvoid*) &mat2);
+        }
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(ld * ld * sizeof(Uint32), (Pvoid*) &y);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            helloDSP_Generate(matrixSize, flags, mat1, mat2);
+            status = helloDSP_GemvLoad(matrixSize, matrixSize, mat1, ld);
+        }
+        maxVectors = helloDSP_GemvVectors();
+
+        if (DSP_SUCCEEDED(status))
+        {
+            SYSTEM_2Print("GEMV y = A * x, A %d x %d", matrixSize, matrixSize);
+            SYSTEM_1Print(", %d vectors per pass\n", matrixSize);
+            SYSTEM_0Print("vectors/msg\tcycles/vector\tbytes/vector\tvectors/sec\tcorrect\n");
+        }
+
+        for (blockVectors = 1; DSP_SUCCEEDED(status) && (blockVectors <= maxVectors); blockVectors *= 4)
+        {
+            vectors = 0;
+            cycles = 0;
+            bytes = 0;
+            elapsedTime = 0;
+            for (b = 0; DSP_SUCCEEDED(status) && (b < batchSize); b++)
+            {
+                status = helloDSP_RunGemv(matrixSize, blockVectors, mat2, ld, y, ld, &stats);
+                vectors += matrixSize;
+                cycles += stats.cycles;
+                bytes += stats.gppCacheBytes;
+                elapsedTime += stats.elapsedTime;
+            }
+
+            if (DSP_SUCCEEDED(status))
+            {
+                incorrect = 0;
+                for (v = 0; v < matrixSize; v++)
+                    for (i = 0; i < matrixSize; i++)
+                    {
+                        sum = 0;
+                        for (l = 0; l < matrixSize; l++)
+                            sum += ((Uint32) mat1[i * ld + l]) * ((Uint32) mat2[v * ld + l]);
+                        if (y[v * ld + i] != sum)
+                            incorrect++;
+                    }
+
+                SYSTEM_2Print("%d\t\t%d", blockVectors, cycles / vectors);
+                SYSTEM_2Print("\t\t%d\t\t%d", bytes / vectors,
+                              (elapsedTime == 0) ? 0 : (Uint32) (((AccumWide) vectors * 1000000) / elapsedTime));
+                SYSTEM_0Print((incorrect == 0) ? "\t\tyes\n" : "\t\tNO\n");
+            }
+        }
+
+        helloDSP_ArenaRelease(arenaMark);
+
+        SYSTEM_0Print("Leaving helloDSP_GemvCheck ()\n");
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ReserveOperand
+     *
+     *  @desc   Allocates the row blocks of a dense matrixSize square operand,
+     *          split as helloDSP_Submit () would split it, and points the
+     *          operand at their payloads.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_ReserveOperand(IN Uint32 matrixSize, OUT HELLODSP_Operand* operand)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* msgS;
+        Uint32 numBlocks = 0;
+        Uint32 rowStart;
+        Uint32 numRows;
+
+        operand->rows = matrixSize;
+        operand->cols = matrixSize;
+        operand->blockRows = 1;
+        operand->numBlocks = 0;
+
+        if ((matrixSize == 0) || (matrixSize > sessionSize)
+            || (CTRLMSG_BLOCKS(matrixSize, sizeof(Uint16)) > HELLODSP_OPERAND_MAX_BLOCKS))
+        {
+            status = DSP_EINVALIDARG;
+            SYSTEM_1Print("ERROR! Operand size must be between 1 and %d\n", sessionSize);
+        }
+        else
+        {
+            operand->blockRows = CTRLMSG_BLOCK_ROWS(matrixSize, sizeof(Uint16));
+            numBlocks = CTRLMSG_BLOCKS(matrixSize, sizeof(Uint16));
+        }
+
+        while (DSP_SUCCEEDED(status) && (operand->numBlocks < numBlocks))
+        {
+            rowStart = operand->numBlocks * operand->blockRows;
+            numRows = (matrixSize - rowStart < operand->blockRows) ? (matrixSize - rowStart)
+                                                                   : operand->blockRows;
+            status = helloDSP_AllocMsg(CTRLMSG_SIZE(numRows * matrixSize * sizeof(Uint16)), &msgS);
+            if (DSP_SUCCEEDED(status))
+            {
+                operand->msgs[operand->numBlocks] = (Pvoid) msgS;
+                operand->data[operand->numBlocks] = msgS->arg2;
+                operand->numBlocks++;
+            }
+        }
+
+        if (DSP_FAILED(status))
+        {
+            helloDSP_ReleaseOperand(operand);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ReleaseOperand
+     *
+     *  @desc   Frees the blocks of an operand that was not committed.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Void helloDSP_ReleaseOperand(IN HELLODSP_Operand* operand)
+    {
+        Uint32 i;
+
+        for (i = 0; i < operand->numBlocks; i++)
+        {
+            helloDSP_FreeMsg((MsgqMsg) operand->msgs[i]);
+        }
+        operand->numBlocks = 0;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_MultiplyOperands
+     *
+     *  @desc   Sends both reserved operands as a single job and adds nothing
+     *          on the way: the DSP gets the blocks the producer wrote. The
+     *          product is copied from its messages straight into C.
+     *
+     *  @modif  c
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_MultiplyOperands(IN HELLODSP_Operand* a, IN HELLODSP_Operand* b,
+                                                    IN Uint16 kernel, IN Uint16 kernelParam,
+                                                    OUT Uint32* c, IN Uint32 ldc)
+    {
+        DSP_STATUS status = DSP_SOK;
+        JobStats stats;
+        ResultView view;
+        Uint32 n = a->rows;
+        Uint32 row = 0;
+        Uint32* out;
+        Uint32 start;
+        Uint32 j, k;
+
+        memset(&stats, 0, sizeof(JobStats));
+        start = SYSTEM_GetUsecTime();
+
+        if ((a->numBlocks == 0) || (b->numBlocks == 0) || (b->rows != n) || (ldc < n))
+        {
+            status = DSP_EINVALIDARG;
+            SYSTEM_0Print("ERROR! Operands must be reserved, of the same size, and fit the stride\n");
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_CommitOperand(0, CMD_MATRIX_A, kernel, kernelParam, a, &stats);
+        }
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_CommitOperand(0, CMD_MATRIX_B, kernel, kernelParam, b, &stats);
+        }
+        if (DSP_SUCCEEDED(status))
+        {
+            helloDSP_RecordLatency(LATENCY_SUBMIT, SYSTEM_GetUsecTime() - start);
+            helloDSP_JobSubmitted(start);
+        }
+        else
+        {
+            METRIC_ADD(METRIC_JOBS_FAILED, 1);
+        }
+
+        /* An operand that could not be committed is freed here */
+        helloDSP_ReleaseOperand(a);
+        helloDSP_ReleaseOperand(b);
+
+        while (DSP_SUCCEEDED(status) && (row < n))
+        {
+            status = helloDSP_NextView(0, n, n, row, &view, &stats);
+            if (DSP_SUCCEEDED(status))
+            {
+                for (j = 0; j < view.numRows; j++)
+                {
+                    out = c + (row + j) * ldc;
+                    for (k = 0; k < n; k++)
+                        out[k] = (Uint32) RESULT_VIEW_ELEM(&view, j, k);
+                }
+                row += view.numRows;
+                helloDSP_ReleaseView(&view);
+            }
+            else
+            {
+                /* Collect the rest of the job, lest the next one, with the
+                 * same id, take it for its own. */
+                helloDSP_DrainJobs(!view.last, 0);
+            }
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Generate
+     *
+     *  @desc   Generates the operands of the jobs from the generators of
+     *          helloDSP_GenSpecs (), so that they are the ones the DSP
+     *          generates for the same flags. 8-bit operands are reduced
+     *          modulo 256. Sparse operands keep about one element in ten.
+     *          The operands are stored with a row stride of matrixSize.
+     *
+     *  @modif  mat1, mat2
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_Generate(IN Uint32 matrixSize, IN Uint32 flags,
+                                             OUT Uint16* mat1, OUT Uint16* mat2)
+    {
+        Uint16 j, k;
+        GenSpec specs[2];
+        Uint16 mask = (flags & HELLODSP_PACKED) ? 0xFF : 0xFFFF;
+
+        helloDSP_GenSpecs(flags, specs);
+        helloDSP_GenerateOperand(&specs[0], matrixSize, matrixSize, matrixSize, mask, mat1);
+        helloDSP_GenerateOperand(&specs[1], matrixSize, matrixSize, matrixSize, mask, mat2);
+
+        if (flags & HELLODSP_SPARSE)
+        {
+            for (j = 0; j < matrixSize; j++)
+                for (k = 0; k < matrixSize; k++)
+                {
+                    if ((j * 7 + k * 3) % 10 != 0)
+                        mat1[j * matrixSize + k] = 0;
+                    if ((j * 3 + k * 7) % 10 != 0)
+                        mat2[j * matrixSize + k] = 0;
+                }
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GenSpecs
+     *
+     *  @desc   Describes the generators of both operands: those of the
+     *          kind given with HELLODSP_DSPGEN, otherwise random ones for
+     *          HELLODSP_FULLRANGE and affine ones by default. Random
+     *          operands spread over all 16 bits, so that the product of a
+     *          large matrix no longer fits in 32 bits. The second operand
+     *          of an identity is affine, so that the product is that
+     *          operand. Banded operands are tridiagonal.
+     *
+     *  @modif  specs
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_GenSpecs(IN Uint32 flags, OUT GenSpec* specs)
+    {
+        Uint16 kind;
+
+        if (flags & HELLODSP_DSPGEN)
+            kind = (Uint16) ((flags & HELLODSP_GEN_MASK) >> HELLODSP_GEN_SHIFT);
+        else
+            kind = (flags & HELLODSP_FULLRANGE) ? GEN_RANDOM : GEN_AFFINE;
+
+        memset(specs, 0, 2 * sizeof(GenSpec));
+        specs[0].kind = kind;
+        specs[1].kind = (kind == GEN_IDENTITY) ? GEN_AFFINE : kind;
+        switch (kind)
+        {
+            case GEN_CONSTANT:
+                specs[0].base = 2;
+                specs[1].base = 3;
+                break;
+
+            case GEN_IDENTITY:
+                specs[0].base = 1;
+                break;
+
+            case GEN_RANDOM:
+                specs[0].seed = 1;
+                specs[1].seed = 2;
+                break;
+
+            default:
+                break;
+        }
+        if ((kind == GEN_AFFINE) || (kind == GEN_IDENTITY) || (kind == GEN_BANDED))
+        {
+            specs[0].rowStep = 1;
+            specs[0].colStep = 2;
+            specs[1].rowStep = 1;
+            specs[1].colStep = 3;
+        }
+        if (kind == GEN_BANDED)
+        {
+            specs[0].band = 1;
+            specs[1].band = 1;
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GenerateOperand
+     *
+     *  @desc   Computes a rows x cols operand from its generator, with a
+     *          row stride of ld, the way the DSP does for a generated block
+     *          covering the operand. Elements are reduced with mask.
+     *
+     *  @modif  dst
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_GenerateOperand(IN const GenSpec* spec, IN Uint32 rows,
+                                                    IN Uint32 cols, IN Uint32 ld, IN Uint16 mask,
+                                                    OUT Uint16* dst)
+    {
+        Uint32 state = spec->seed;
+        Uint16 value;
+        Uint32 j, k;
+
+        for (j = 0; j < rows; j++)
+            for (k = 0; k < cols; k++)
+            {
+                switch (spec->kind)
+                {
+                    case GEN_CONSTANT:
+                        value = spec->base;
+                        break;
+
+                    case GEN_IDENTITY:
+                        value = (j == k) ? spec->base : 0;
+                        break;
+
+                    case GEN_BANDED:
+                        value = ((j > k + spec->band) || (k > j + spec->band)) ? 0
+                                : (Uint16) (spec->base + spec->rowStep * j + spec->colStep * k);
+                        break;
+
+                    case GEN_RANDOM:
+                        state = GEN_LCG_NEXT(state);
+                        value = (Uint16) (state >> 16);
+                        break;
+
+                    default:
+                        value = (Uint16) (spec->base + spec->rowStep * j + spec->colStep * k);
+                        break;
+                }
+                dst[j * ld + k] = value & mask;
+            }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Reference
+     *
+     *  @desc   Computes the product the DSP results are verified against,
+     *          with a row stride of matrixSize.
+     *
+     *  @modif  prod
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_Reference(IN Uint32 matrixSize, IN const Uint16* a,
+                                              IN const Uint16* b, IN Uint32 ld,
+                                              OUT AccumWide* prod)
+    {
+        Uint16 j, k, l;
+
+        for (j = 0; j < matrixSize; j++)
+            for (k = 0; k < matrixSize; k++)
+            {
+                prod[j * matrixSize + k] = 0;
+                for(l = 0; l < matrixSize; l++)
+                    prod[j * matrixSize + k] = prod[j * matrixSize + k]
+                                               + ((AccumWide)a[j * ld + l]) * ((AccumWide)b[l * ld + k]);
+            }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_OutputResult
+     *
+     *  @desc   Formats a product into outputBuffer and writes it out with
+     *          one SYSTEM_Write () per buffer load, usually a single one
+     *          for the whole product. Text has a line per row with each
+     *          element after a tab, CSV a line per row with elements
+     *          separated by commas.
+     *
+     *  @modif  outputBuffer
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_OutputResult(IN Uint32 matrixSize,
+                                                       IN const AccumWide* result,
+                                                       IN Uint32 flags)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Bool csv = (flags & HELLODSP_CSV) != 0;
+        Char8 digits[OUTPUT_ELEM_MAX];
+        Uint32 used = 0;
+        Uint32 numDigits;
+        AccumWide value;
+        Uint32 j, k;
+
+        if (flags & HELLODSP_QUIET)
+        {
+            return DSP_SOK;
+        }
+
+        for (j = 0; DSP_SUCCEEDED(status) && (j < matrixSize); j++)
+        {
+            if (!csv)
+                outputBuffer[used++] = '\n';
+            for (k = 0; k < matrixSize; k++)
+            {
+                /* Digits come out least significant first */
+                value = result[j * matrixSize + k];
+                numDigits = 0;
+                do
+                {
+                    digits[numDigits++] = (Char8) ('0' + (Uint32) (value % 10));
+                    value /= 10;
+                } while (value != 0);
+
+                if (!csv)
+                    outputBuffer[used++] = '\t';
+                else if (k != 0)
+                    outputBuffer[used++] = ',';
+                while (numDigits != 0)
+                    outputBuffer[used++] = digits[--numDigits];
+                if (!csv)
+                    outputBuffer[used++] = ' ';
+
+                if (used > OUTPUT_BUFFER_SIZE - OUTPUT_ELEM_MAX - 2)
+                {
+                    status = SYSTEM_Write(outputBuffer, used);
+                    used = 0;
+                }
+            }
+            if (csv)
+                outputBuffer[used++] = '\n';
+        }
+
+        if (DSP_SUCCEEDED(status) && (used != 0))
+        {
+            status = SYSTEM_Write(outputBuffer, used);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_MapMatrix
+     *
+     *  @desc   Maps a matrix file and checks that it holds a matrixSize x
+     *          matrixSize matrix of 16-bit elements. The elements are
+     *          returned in place in the mapping, with a row stride of
+     *          matrixSize.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_MapMatrix(IN Char8* path, IN Uint32 matrixSize,
+                                                    OUT const Uint16** dataPtr,
+                                                    OUT Pvoid* mapPtr, OUT Uint32* mapSizePtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+        const HELLODSP_MatrixHeader* header;
+
+        status = SYSTEM_MapFile(path, mapPtr, mapSizePtr);
+        if (DSP_FAILED(status))
+        {
+            SYSTEM_1Print("Could not map %s\n", (Uint32) path);
+        }
+        else
+        {
+            header = (const HELLODSP_MatrixHeader*) *mapPtr;
+            if ((*mapSizePtr < sizeof(HELLODSP_MatrixHeader))
+                || (header->magic != HELLODSP_MATRIX_MAGIC)
+                || (header->rows != matrixSize) || (header->cols != matrixSize)
+                || (header->elemSize != sizeof(Uint16))
+                || (*mapSizePtr - sizeof(HELLODSP_MatrixHeader)
+                    < matrixSize * matrixSize * sizeof(Uint16)))
+            {
+                status = DSP_EINVALIDARG;
+                SYSTEM_2Print("%s is not a %d x", (Uint32) path, matrixSize);
+                SYSTEM_1Print(" %d matrix file of 16-bit elements\n", matrixSize);
+                SYSTEM_UnmapFile(*mapPtr, *mapSizePtr);
+                *mapPtr = NULL;
+                *mapSizePtr = 0;
+            }
+            else
+            {
+                *dataPtr = (const Uint16*) (header + 1);
+            }
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_WriteMatrix
+     *
+     *  @desc   Writes a matrixSize x matrixSize product to a matrix file
+     *          through a mapping, with 32-bit elements (the products modulo
+     *          2^32) or 64-bit ones.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_WriteMatrix(IN Char8* path, IN Uint32 matrixSize,
+                                                      IN Uint32 elemSize,
+                                                      IN const AccumWide* result)
+    {
+        DSP_STATUS status = DSP_SOK;
+        HELLODSP_MatrixHeader* header;
+        Uint32* words;
+        Uint32 size = sizeof(HELLODSP_MatrixHeader) + matrixSize * matrixSize * elemSize;
+        Pvoid map;
+        Uint32 j, k;
+
+        status = SYSTEM_CreateMappedFile(path, size, &map);
+        if (DSP_FAILED(status))
+        {
+            SYSTEM_1Print("Could not create %s\n", (Uint32) path);
+        }
+        else
+        {
+            header = (HELLODSP_MatrixHeader*) map;
+            header->magic = HELLODSP_MATRIX_MAGIC;
+            header->rows = matrixSize;
+            header->cols = matrixSize;
+            header->elemSize = elemSize;
+
+            if (elemSize == sizeof(AccumWide))
+            {
+                memcpy(header + 1, result, matrixSize * matrixSize * sizeof(AccumWide));
+            }
+            else
+            {
+                words = (Uint32*) (header + 1);
+                for (j = 0; j < matrixSize; j++)
+                    for (k = 0; k < matrixSize; k++)
+                        words[j * matrixSize + k] = (Uint32) result[j * matrixSize + k];
+            }
+
+            SYSTEM_UnmapFile(map, size);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_RunBatch
+     *
+     *  @desc   Runs batchSize jobs on the same operands with up to
+     *          sessionDepth jobs in flight, and verifies each product
+     *          against prod unless it is NULL, modulo 2^32 for ACCUM_WRAP.
+     *          Products are read in place in their messages; only the one
+     *          of the last job is copied to resFromDSP, unless it is NULL.
+     *          Products have a row stride of matrixSize. Unless gen is
+     *          NULL, the DSP generates the operands from it instead of
+     *          receiving a and b.
+     *
+     *  @modif  resFromDSP, stats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunBatch(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                                   IN Uint16 kernel, IN Uint16 kernelParam,
+                                                   IN Uint16 accum, IN Uint16 elemSize, IN Bool compress,
+                                                   IN const GenSpec* gen,
+                                                   IN const Uint16* a, IN const Uint16* b, IN Uint32 ld,
+                                                   IN const AccumWide* prod,
+                                                   OUT AccumWide* resFromDSP, OUT JobStats* stats)
+    {
+        DSP_STATUS  status = DSP_SOK;
+        JobDesc job;
+        ResultView view;
+        const AccumWide* expected;
+        Bool incorrect;
+        Uint32 row;
+        Uint16 j, k;
+        Uint32 submitted = 0;
+        Bool viewFailed = FALSE;
+        Uint32 start;
+        Uint32 verifyStart;
+
+        memset(stats, 0, sizeof(JobStats));
+        helloDSP_ResetPoolPeak();
+
+        job.matrixSize = matrixSize;
+        job.kernel = kernel;
+        job.kernelParam = kernelParam;
+        job.accum = accum;
+        job.elemSize = elemSize;
+        job.compress = compress;
+        job.gen = gen;
+        job.dimM = matrixSize;
+        job.dimN = matrixSize;
+        job.dimK = matrixSize;
+        job.trans = 0;
+        job.alpha = 1;
+        job.a = a;
+        job.lda = ld;
+        job.b = b;
+        job.ldb = ld;
+
+        start = SYSTEM_GetUsecTime();
+
+        while (DSP_SUCCEEDED(status) && (stats->jobs < batchSize))
+        {
+            /* Keep the pipeline full */
+            while (DSP_SUCCEEDED(status) && (submitted < batchSize)
+                   && (submitted - stats->jobs < sessionDepth))
+            {
+                status = helloDSP_Submit((Uint16) (submitted % MSGQ_INTERNALIDSSTART), &job, stats);
+                if (DSP_SUCCEEDED(status))
+                {
+                    submitted++;
+                    if (submitted - stats->jobs > stats->jobsPeak)
+                        stats->jobsPeak = submitted - stats->jobs;
+                }
+            }
+
+            /* Receive the oldest job a block at a time, verifying each in
+             * place in its message. Only the last product is gathered. */
+            row = 0;
+            incorrect = FALSE;
+            while (DSP_SUCCEEDED(status) && (row < matrixSize))
+            {
+                status = helloDSP_NextView((Uint16) (stats->jobs % MSGQ_INTERNALIDSSTART),
+                                           matrixSize, matrixSize, row, &view, stats);
+                viewFailed = DSP_FAILED(status);
+                if (DSP_SUCCEEDED(status))
+                {
+                    /* Verification is not accounted in the elapsed time */
+                    if ((prod != NULL) && !incorrect)
+                    {
+                        verifyStart = SYSTEM_GetUsecTime();
+                        PHASE_ENTER(PHASE_VERIFY);
+                        expected = prod + row * matrixSize;
+                        for (j = 0; j < view.numRows; j++)
+                            for (k = 0; k < matrixSize; k++)
+                                if (((accum == ACCUM_WRAP) ? (Uint32) expected[j * matrixSize + k]
+                                                           : expected[j * matrixSize + k])
+                                    != RESULT_VIEW_ELEM(&view, j, k)) {
+                                    incorrect = TRUE;
+                                    j = view.numRows;
+                                    break;
+                                }
+                        start += SYSTEM_GetUsecTime() - verifyStart;
+                        PHASE_ENTER(PHASE_UNPACK);
+                    }
+
+                    if ((resFromDSP != NULL) && (stats->jobs == batchSize - 1))
+                    {
+                        helloDSP_GatherView(&view, resFromDSP, matrixSize);
+                    }
+
+                    row += view.numRows;
+                    helloDSP_ReleaseView(&view);
+                }
+            }
+
+            if (DSP_SUCCEEDED(status))
+            {
+                stats->jobs++;
+                if (incorrect)
+                    stats->incorrect++;
+#if defined (PROFILE)
+                if ((stats->jobs == 1) && (createStartTime != 0))
+                {
+                    SYSTEM_1Print("Time to first job: %d uSec\n", SYSTEM_GetUsecTime() - createStartTime);
+                    createStartTime = 0;
+                }
+#endif
+            }
+        }
+
+        /* Collect the replies of the jobs still in flight after a failure */
+        if (DSP_FAILED(status))
+        {
+            helloDSP_DrainJobs(viewFailed && !view.last,
+                               submitted - stats->jobs - (viewFailed ? 1 : 0));
+        }
+
+        stats->elapsedTime = SYSTEM_GetUsecTime() - start;
+        stats->buffersPeak = poolBuffersPeak;
+        stats->bytesPeak = poolBytesPeak;
+        PHASE_ENTER(PHASE_OTHER);
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_RunGemm
+     *
+     *  @desc   Runs helloDSP_Gemm () as KERNEL_GEMM jobs of up to
+     *          helloDSP_GemmRows () rows of C each. The first operand of a
+     *          job is a view into a: rows of A, or columns of A when it is
+     *          transposed. C is only read when beta is not 0.
+     *
+     *  @modif  c, stats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunGemm(IN Bool transA, IN Bool transB,
+                                                  IN Uint32 m, IN Uint32 n, IN Uint32 k,
+                                                  IN Uint32 alpha, IN const Uint16* a, IN Uint32 lda,
+                                                  IN const Uint16* b, IN Uint32 ldb,
+                                                  IN Uint32 beta, IN OUT Uint32* c, IN Uint32 ldc,
+                                                  OUT JobStats* stats)
+    {
+        DSP_STATUS status = DSP_SOK;
+        JobDesc job;
+        ResultView view;
+        Uint32 chunkRows = 1;
+        Uint32 numChunks = 0;
+        Uint32 submitted = 0;
+        Bool viewFailed = FALSE;
+        Uint32 rowStart;
+        Uint32 numRows;
+        Uint32 row;
+        Uint32* out;
+        Uint32 start;
+        Uint32 i, j;
+
+        memset(stats, 0, sizeof(JobStats));
+
+        if ((m == 0) || (n == 0) || (k == 0)
+            || (m > sessionSize) || (n > sessionSize) || (k > sessionSize)
+            || (lda < (transA ? m : k)) || (ldb < (transB ? k : n)) || (ldc < n))
+        {
+            status = DSP_EINVALIDARG;
+            SYSTEM_1Print("ERROR! GEMM dimensions must be between 1 and %d and fit the strides\n",
+                          sessionSize);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            job.matrixSize = 0;
+            job.kernel = KERNEL_GEMM;
+            job.kernelParam = 0;
+            job.accum = ACCUM_WRAP;
+            job.elemSize = sizeof(Uint16);
+            job.compress = FALSE;
+            job.gen = NULL;
+            job.dimN = n;
+            job.dimK = k;
+            job.trans = (transA ? TRANS_A : 0) | (transB ? TRANS_B : 0);
+            job.alpha = alpha;
+            job.lda = lda;
+            job.b = b;
+            job.ldb = ldb;
+
+            chunkRows = helloDSP_GemmRows(n);
+            numChunks = (m + chunkRows - 1) / chunkRows;
+        }
+
+        start = SYSTEM_GetUsecTime();
+
+        while (DSP_SUCCEEDED(status) && (stats->jobs < numChunks))
+        {
+            /* Keep the pipeline full */
+            while (DSP_SUCCEEDED(status) && (submitted < numChunks)
+                   && (submitted - stats->jobs < sessionDepth))
+            {
+                rowStart = submitted * chunkRows;
+                job.dimM = (m - rowStart < chunkRows) ? (m - rowStart) : chunkRows;
+                job.a = transA ? (a + rowStart) : (a + rowStart * lda);
+                status = helloDSP_Submit((Uint16) (submitted % MSGQ_INTERNALIDSSTART), &job, stats);
+                if (DSP_SUCCEEDED(status))
+                {
+                    submitted++;
+                    if (submitted - stats->jobs > stats->jobsPeak)
+                        stats->jobsPeak = submitted - stats->jobs;
+                }
+            }
+
+            /* Receive the oldest job and add it into C straight from its
+             * messages. GEMM products are 32-bit. */
+            rowStart = stats->jobs * chunkRows;
+            numRows = (m - rowStart < chunkRows) ? (m - rowStart) : chunkRows;
+            row = 0;
+            while (DSP_SUCCEEDED(status) && (row < numRows))
+            {
+                status = helloDSP_NextView((Uint16) (stats->jobs % MSGQ_INTERNALIDSSTART),
+                                           numRows, n, row, &view, stats);
+                viewFailed = DSP_FAILED(status);
+                if (DSP_SUCCEEDED(status))
+                {
+                    for (i = 0; i < view.numRows; i++)
+                    {
+                        out = c + (rowStart + row + i) * ldc;
+                        if (beta == 0)
+                        {
+                            for (j = 0; j < n; j++)
+                                out[j] = (Uint32) RESULT_VIEW_ELEM(&view, i, j);
+                        }
+                        else
+                        {
+                            for (j = 0; j < n; j++)
+                                out[j] = (Uint32) RESULT_VIEW_ELEM(&view, i, j) + beta * out[j];
+                        }
+                    }
+                    row += view.numRows;
+                    helloDSP_ReleaseView(&view);
+                }
+            }
+
+            if (DSP_SUCCEEDED(status))
+            {
+                stats->jobs++;
+            }
+        }
+
+        /* Collect the replies of the jobs still in flight after a failure */
+        if (DSP_FAILED(status))
+        {
+            helloDSP_DrainJobs(viewFailed && !view.last,
+                               submitted - stats->jobs - (viewFailed ? 1 : 0));
+        }
+
+        stats->elapsedTime = SYSTEM_GetUsecTime() - start;
+        PHASE_ENTER(PHASE_OTHER);
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemmRows
+     *
+     *  @desc   The pool holds the blocks of sessionDepth square jobs of
+     *          sessionSize. A GEMM job with dimensions up to sessionSize
+     *          sends no larger operand blocks than those; its product is
+     *          limited to as many blocks as a square product, each no larger
+     *          than the shortest one.
+     *
+     *  @ret    Rows of C per job, at least 1.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_GemmRows(IN Uint32 n)
+    {
+        Uint32 maxBlocks = CTRLMSG_BLOCKS(sessionSize, RESULT_ELEM_MAX);
+        Uint32 maxSize = CTRLMSG_SIZE(CTRLMSG_TAIL_ROWS(sessionSize, RESULT_ELEM_MAX)
+                                      * sessionSize * RESULT_ELEM_MAX);
+        Uint32 rows;
+
+        for (rows = sessionSize; rows > 1; rows--)
+        {
+            if ((CTRLMSG_ROW_BLOCKS(rows, n, sizeof(Uint32)) <= maxBlocks)
+                && (CTRLMSG_SIZE(CTRLMSG_ROW_BLOCK_ROWS(rows, n, sizeof(Uint32)) * n * sizeof(Uint32))
+                    <= maxSize))
+            {
+                break;
+            }
+        }
+
+        return rows;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_RunGemv
+     *
+     *  @desc   Sends the vectors blockVectors per CMD_VECTORS message, with
+     *          up to sessionDepth messages in flight, and stores the
+     *          products in y as they come back. Each message counts as a
+     *          job in stats.
+     *
+     *  @modif  y, stats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunGemv(IN Uint32 numVectors, IN Uint32 blockVectors,
+                                                  IN const Uint16* x, IN Uint32 ldx,
+                                                  OUT Uint32* y, IN Uint32 ldy, OUT JobStats* stats)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* msgS;
+        ControlMsgL* msgL;
+        const Uint16* row;
+        Uint32* out;
+        Uint32 numBlocks = 0;
+        Uint32 submitted = 0;
+        Uint32 received = 0;
+        Uint32 first;
+        Uint32 count;
+        Uint32 payload;
+        Uint32 start;
+        Uint32 sendStart;
+        Uint32 i, v;
+
+        memset(stats, 0, sizeof(JobStats));
+
+        if (gemvRows == 0)
+        {
+            status = DSP_EFAIL;
+            SYSTEM_0Print("ERROR! No matrix loaded for GEMV\n");
+        }
+        else if ((blockVectors == 0) || (blockVectors > GEMV_MAX_VECTORS)
+                 || (ldx < gemvCols) || (ldy < gemvRows))
+        {
+            status = DSP_EINVALIDARG;
+            SYSTEM_1Print("ERROR! GEMV takes 1 to %d vectors per message and strides that fit\n",
+                          GEMV_MAX_VECTORS);
+        }
+        else
+        {
+            numBlocks = (numVectors + blockVectors - 1) / blockVectors;
+        }
+
+        start = SYSTEM_GetUsecTime();
+
+        while (DSP_SUCCEEDED(status) && (stats->jobs < numBlocks))
+        {
+            /* Keep the pipeline full */
+            while (DSP_SUCCEEDED(status) && (submitted < numBlocks)
+                   && (submitted - stats->jobs < sessionDepth))
+            {
+                first = submitted * blockVectors;
+                count = (numVectors - first < blockVectors) ? (numVectors - first) : blockVectors;
+                payload = count * gemvCols * sizeof(Uint16);
+                status = helloDSP_AllocMsg(CTRLMSG_SIZE(payload), &msgS);
+                if (DSP_SUCCEEDED(status))
+                {
+                    msgS->command = CMD_VECTORS;
+                    msgS->matrixSize = 0;
+                    msgS->jobId = (Uint16) (submitted % MSGQ_INTERNALIDSSTART);
+                    msgS->rowStart = (Uint16) first;
+                    msgS->numRows = count;
+                    msgS->kernel = KERNEL_BASE;
+                    msgS->kernelParam = 0;
+                    msgS->accum = ACCUM_WRAP;
+                    msgS->elemSize = sizeof(Uint16);
+                    msgS->format = FORMAT_DENSE;
+                    msgS->nnz = 0;
+                    msgS->dimM = gemvRows;
+                    msgS->dimN = count;
+                    msgS->dimK = gemvCols;
+                    msgS->trans = 0;
+                    msgS->alpha = 1;
+                    for (v = 0; v < count; v++)
+                    {
+                        row = x + (first + v) * ldx;
+                        for (i = 0; i < gemvCols; i++)
+                            msgS->arg2[v * gemvCols + i] = row[i];
+                    }
+                    MSGQ_setMsgId((MsgqMsg) msgS, msgS->jobId);
+                    MSGQ_setSrcQueue((MsgqMsg) msgS, SampleGppMsgq);
+
+                    sendStart = SYSTEM_GetUsecTime();
+                    PHASE_ENTER(PHASE_LINK);
+                    status = helloDSP_PutMsg((MsgqMsg) msgS);
+                    PHASE_ENTER(PHASE_OTHER);
+                    if (DSP_SUCCEEDED(status))
+                    {
+                        stats->gppSendTime += SYSTEM_GetUsecTime() - sendStart;
+                        stats->gppCacheBytes += CTRLMSG_SIZE(payload);
+                        METRIC_SENT(CTRLMSG_SIZE(payload));
+                        submitted++;
+                        if (submitted - stats->jobs > stats->jobsPeak)
+                            stats->jobsPeak = submitted - stats->jobs;
+                    }
+                    else
+                    {
+                        helloDSP_FreeMsg((MsgqMsg) msgS);
+                        SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+                    }
+                }
+            }
+
+            /* Receive the products of the oldest message */
+            if (DSP_SUCCEEDED(status))
+            {
+                first = stats->jobs * blockVectors;
+                count = (numVectors - first < blockVectors) ? (numVectors - first) : blockVectors;
+                PHASE_ENTER(PHASE_WAIT);
+                status = helloDSP_GetMsg((MsgqMsg *) &msgL);
+                PHASE_ENTER(PHASE_UNPACK);
+                if (DSP_FAILED(status))
+                {
+                    SYSTEM_1Print("MSGQ_get () failed. Status = [0x%x]\n", status);
+                }
+                else
+                {
+                    METRIC_RECEIVED(msgL);
+                    received++;
+                    if (msgL->command == CMD_ERROR)
+                    {
+                        status = DSP_EFAIL;
+                        SYSTEM_1Print("DSP rejected vector block %d\n", msgL->rowStart);
+                    }
+                    else if ((msgL->command != CMD_RESULT)
+                             || (msgL->jobId != (Uint16) (stats->jobs % MSGQ_INTERNALIDSSTART))
+                             || (msgL->rowStart != (Uint16) first) || (msgL->numRows != count)
+                             || (msgL->elemSize != sizeof(Uint32)) || (msgL->dimM != gemvRows))
+                    {
+                        status = DSP_EFAIL;
+                        SYSTEM_1Print("Unexpected block for vector %d\n", first);
+                    }
+                    else
+                    {
+                        for (v = 0; v < count; v++)
+                        {
+                            out = y + (first + v) * ldy;
+                            for (i = 0; i < gemvRows; i++)
+                                out[i] = msgL->arg2[v * gemvRows + i];
+                        }
+
+                        /* MSGQ_get () invalidated the block */
+                        stats->gppCacheBytes += CTRLMSG_SIZE(count * gemvRows * sizeof(Uint32));
+                        stats->cycles += msgL->arg1;
+                        stats->dspCacheCycles += msgL->cacheCycles;
+                        stats->dspCacheBytes += msgL->cacheBytes;
+                        stats->dspConfig = msgL->dspConfig;
+                        stats->jobs++;
+                    }
+                    helloDSP_FreeMsg((MsgqMsg) msgL);
+                }
+            }
+        }
+
+        /* Each message sent gets a single reply. Collect those of the
+         * messages still in flight after a failure, lest the next run take
+         * them for its own. */
+        while (received < submitted)
+        {
+            if (DSP_FAILED(helloDSP_GetMsg((MsgqMsg *) &msgL)))
+            {
+                break;
+            }
+            METRIC_RECEIVED(msgL);
+            helloDSP_FreeMsg((MsgqMsg) msgL);
+            received++;
+        }
+
+        stats->elapsedTime = SYSTEM_GetUsecTime() - start;
+        PHASE_ENTER(PHASE_OTHER);
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemvVectors
+     *
+     *  @desc   A CMD_VECTORS message and its products must fit the shortest
+     *          operand and product blocks of a square job of sessionSize,
+     *          like the blocks of a GEMM job.
+     *
+     *  @ret    Vectors per message, at least 1.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_GemvVectors(Void)
+    {
+        Uint32 operandSize = CTRLMSG_SIZE(CTRLMSG_TAIL_ROWS(sessionSize, sizeof(Uint16))
+                                          * sessionSize * sizeof(Uint16));
+        Uint32 resultSize = CTRLMSG_SIZE(CTRLMSG_TAIL_ROWS(sessionSize, RESULT_ELEM_MAX)
+                                         * sessionSize * RESULT_ELEM_MAX);
+        Uint32 vectors;
+
+        for (vectors = GEMV_MAX_VECTORS; vectors > 1; vectors--)
+        {
+            if ((CTRLMSG_SIZE(vectors * gemvCols * sizeof(Uint16)) <= operandSize)
+                && (CTRLMSG_SIZE(vectors * gemvRows * sizeof(Uint32)) <= resultSize))
+            {
+                break;
+            }
+        }
+
+        return vectors;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_LoadTuning
+     *
+     *  @desc   Reads the tuning table saved by helloDSP_Tune (), one line of
+     *          the top size and the variant per size class, and sends it to
+     *          the DSP. Without a table the DSP keeps the default kernel.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_LoadTuning(Void)
+    {
+        DSP_STATUS status = DSP_SOK;
+        FILE* file;
+        Uint16 table[TUNE_CLASSES];
+        unsigned int size;
+        unsigned int variant;
+        Uint32 c;
+
+        file = fopen(TUNE_FILE, "r");
+        if (file != NULL)
+        {
+            for (c = 0; c < TUNE_CLASSES; c++)
+            {
+                if ((fscanf(file, "%u %x", &size, &variant) != 2)
+                    || (size != (4u << c)) || !VARIANT_VALID(variant))
+                {
+                    status = DSP_EFAIL;
+                    break;
+                }
+                table[c] = (Uint16) variant;
+            }
+            fclose(file);
+
+            if (DSP_FAILED(status))
+            {
+                /* A stale or damaged table only costs speed */
+                SYSTEM_0Print("Ignoring malformed " TUNE_FILE "\n");
+                status = DSP_SOK;
+            }
+            else
+            {
+                status = helloDSP_SendTuning(table);
+            }
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_SendTuning
+     *
+     *  @desc   Sends a CMD_TUNE message and waits for CMD_TUNED.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_SendTuning(IN const Uint16* table)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* msg;
+        Uint32 c;
+
+        status = helloDSP_AllocMsg(CTRLMSG_SIZE(TUNE_CLASSES * sizeof(Uint16)), &msg);
+        if (DSP_SUCCEEDED(status))
+        {
+            msg->command = CMD_TUNE;
+            msg->matrixSize = 0;
+            msg->jobId = 0;
+            msg->rowStart = 0;
+            msg->numRows = TUNE_CLASSES;
+            msg->kernel = KERNEL_BASE;
+            msg->kernelParam = 0;
+            msg->accum = ACCUM_WRAP;
+            msg->elemSize = sizeof(Uint16);
+            msg->format = FORMAT_DENSE;
+            msg->nnz = 0;
+            msg->dimM = 0;
+            msg->dimN = 0;
+            msg->dimK = 0;
+            msg->trans = 0;
+            msg->alpha = 1;
+            for (c = 0; c < TUNE_CLASSES; c++)
+                msg->arg2[c] = table[c];
+            MSGQ_setMsgId((MsgqMsg) msg, 0);
+            MSGQ_setSrcQueue((MsgqMsg) msg, SampleGppMsgq);
+
+            status = helloDSP_PutMsg((MsgqMsg) msg);
+            if (DSP_FAILED(status))
+            {
+                helloDSP_FreeMsg((MsgqMsg) msg);
+                SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+            }
+            else
+            {
+                METRIC_SENT(CTRLMSG_SIZE(TUNE_CLASSES * sizeof(Uint16)));
+            }
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_GetMsg((MsgqMsg *) &msg);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("MSGQ_get () failed. Status = [0x%x]\n", status);
+            }
+            else
+            {
+                METRIC_RECEIVED(msg);
+                if (msg->command != CMD_TUNED)
+                {
+                    status = DSP_EFAIL;
+                    SYSTEM_0Print("DSP rejected the tuning table\n");
+                }
+                helloDSP_FreeMsg((MsgqMsg) msg);
+            }
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Query
+     *
+     *  @desc   Sends a command message without payload, with the given
+     *          matrixSize and kernelParam, and waits for the reply, which
+     *          must be replyCommand, and copies payloadBytes of its payload,
+     *          and the DSP build when dspConfig is not NULL. No job of this
+     *          process may be in flight, as the reply must be the next
+     *          message received.
+     *
+     *  @modif  payload, dspConfig
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_Query(IN Uint16 command, IN Uint16 matrixSize,
+                                                IN Uint16 kernelParam, IN Uint16 replyCommand,
+                                                OUT Pvoid payload, IN Uint32 payloadBytes,
+                                                OUT Uint16* dspConfig)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* msg;
+        ControlMsgL* report;
+
+        status = helloDSP_AllocMsg(CTRLMSG_SIZE(0), &msg);
+        if (DSP_SUCCEEDED(status))
+        {
+            msg->command = command;
+            msg->matrixSize = matrixSize;
+            msg->jobId = 0;
+            msg->rowStart = 0;
+            msg->numRows = 0;
+            msg->kernel = KERNEL_BASE;
+            msg->kernelParam = kernelParam;
+            msg->accum = ACCUM_WRAP;
+            msg->elemSize = sizeof(Uint16);
+            msg->format = FORMAT_DENSE;
+            msg->nnz = 0;
+            msg->dimM = 0;
+            msg->dimN = 0;
+            msg->dimK = 0;
+            msg->trans = 0;
+            msg->alpha = 1;
+            MSGQ_setMsgId((MsgqMsg) msg, 0);
+            MSGQ_setSrcQueue((MsgqMsg) msg, SampleGppMsgq);
+
+            status = helloDSP_PutMsg((MsgqMsg) msg);
+            if (DSP_FAILED(status))
+            {
+                helloDSP_FreeMsg((MsgqMsg) msg);
+                SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+            }
+            else
+            {
+                METRIC_SENT(CTRLMSG_SIZE(0));
+            }
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_GetMsg((MsgqMsg *) &report);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("MSGQ_get () failed. Status = [0x%x]\n", status);
+            }
+            else
+            {
+                METRIC_RECEIVED(report);
+                if (report->command != replyCommand)
+                {
+                    status = DSP_EFAIL;
+                    SYSTEM_2Print("DSP replied 0x%x to command 0x%x\n", report->command, command);
+                }
+                else
+                {
+                    memcpy(payload, report->arg2, payloadBytes);
+                    if (dspConfig != NULL)
+                        *dspConfig = report->dspConfig;
+                }
+                helloDSP_FreeMsg((MsgqMsg) report);
+            }
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_QueryStats
+     *
+     *  @desc   Sends a CMD_STATS message and waits for the report. No job of
+     *          this process may be in flight.
+     *
+     *  @modif  dspStats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_QueryStats(OUT DspStats* dspStats)
+    {
+        return helloDSP_Query(CMD_STATS, 0, 0, CMD_STATS_REPORT, dspStats, sizeof(DspStats), NULL);
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_PrintDspStats
+     *
+     *  @desc   Prints how the DSP spent the time between two reports: its
+     *          load, the shares of the time spent copying operands and
+     *          computing, and the requests it handled, followed by the heap
+     *          and stack figures of the last report. A DSP starved by the
+     *          link shows a low load, a saturated one a load near 100%.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintDspStats(IN const DspStats* first, IN const DspStats* last)
+    {
+        AccumWide elapsed = DSPSTATS_CYCLES(last->elapsedCycles) - DSPSTATS_CYCLES(first->elapsedCycles);
+        AccumWide wait = DSPSTATS_CYCLES(last->waitCycles) - DSPSTATS_CYCLES(first->waitCycles);
+        AccumWide copy = DSPSTATS_CYCLES(last->copyCycles) - DSPSTATS_CYCLES(first->copyCycles);
+        AccumWide compute = DSPSTATS_CYCLES(last->computeCycles) - DSPSTATS_CYCLES(first->computeCycles);
+
+        if (elapsed == 0)
+        {
+            elapsed = 1;
+        }
+        SYSTEM_2Print("DSP load: %d%% over %d Mcycles", (Uint32) (100 - wait * 100 / elapsed),
+                      (Uint32) (elapsed / 1000000));
+        SYSTEM_2Print(", %d%% copying operands, %d%% computing",
+                      (Uint32) (copy * 100 / elapsed), (Uint32) (compute * 100 / elapsed));
+        SYSTEM_1Print(", %d requests\n", last->messages - first->messages);
+        SYSTEM_2Print("DSP heap: %d of %d bytes used", last->heapUsed, last->heapSize);
+        SYSTEM_2Print(", at most %d, largest free block %d\n", last->heapPeak, last->heapLargestFree);
+        SYSTEM_2Print("DSP stack: at most %d of %d bytes used\n", last->stackUsed, last->stackSize);
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Monitor
+     *
+     *  @desc   Logs the DSP statistics of every DSPSTATS_PERIOD_USEC
+     *          interval until the process receives SIGINT or SIGTERM. Jobs
+     *          of attached processes are all the DSP does meanwhile. A
+     *          SIGUSR1 ends the interval early with a dump of the metrics,
+     *          also when the DSP could not report its statistics.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_Monitor(Void)
+    {
+        DspStats previous;
+        DspStats current;
+        Bool valid;
+
+        /* Without statistics the wait still has to wake up for SIGUSR1,
+         * which only interrupts a timed wait. */
+        valid = DSP_SUCCEEDED(helloDSP_QueryStats(&previous));
+        while (!SYSTEM_WaitForTermination(DSPSTATS_PERIOD_USEC))
+        {
+            if (SYSTEM_DumpRequested())
+            {
+                helloDSP_DumpMetrics();
+            }
+            else if (valid && DSP_SUCCEEDED(helloDSP_QueryStats(&current)))
+            {
+                helloDSP_PrintDspStats(&previous, &current);
+                previous = current;
+            }
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_DumpMetrics
+     *
+     *  @desc   Prints the metrics of this process in InfluxDB line protocol,
+     *          a line of counters and one per latency histogram, tagged with
+     *          the process id. Only the buckets that counted latencies are
+     *          printed, as lt_<bound>us, or ge_<bound>us for the last one.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Void helloDSP_DumpMetrics(Void)
+    {
+        Uint32 pid = SYSTEM_GetProcessId();
+        Uint32 l, b;
+
+        SYSTEM_2Print("helloDSP,pid=%u jobs_submitted=%ui", pid, metrics[METRIC_JOBS_SUBMITTED]);
+        SYSTEM_2Print(",jobs_completed=%ui,jobs_failed=%ui",
+                      metrics[METRIC_JOBS_COMPLETED], metrics[METRIC_JOBS_FAILED]);
+        SYSTEM_2Print(",jobs_in_flight=%ui,jobs_in_flight_peak=%ui",
+                      metrics[METRIC_JOBS_IN_FLIGHT], metrics[METRIC_JOBS_IN_FLIGHT_PEAK]);
+        SYSTEM_2Print(",msgs_sent=%ui,msgs_received=%ui",
+                      metrics[METRIC_MSGS_SENT], metrics[METRIC_MSGS_RECEIVED]);
+        SYSTEM_2Print(",bytes_sent=%ui,bytes_received=%ui",
+                      metrics[METRIC_BYTES_SENT], metrics[METRIC_BYTES_RECEIVED]);
+        SYSTEM_2Print(",alloc_retries=%ui,alloc_failures=%ui\n",
+                      metrics[METRIC_ALLOC_RETRIES], metrics[METRIC_ALLOC_FAILURES]);
+
+        for (l = 0; l < NUM_LATENCIES; l++)
+        {
+            SYSTEM_2Print(latencyFormats[l], pid, latencies[l].count);
+            SYSTEM_1Print(",sum_us=%ui", latencies[l].sum);
+            for (b = 0; b < LATENCY_BUCKETS - 1; b++)
+            {
+                if (latencies[l].buckets[b] != 0)
+                    SYSTEM_2Print(",lt_%uus=%ui", 1 << b, latencies[l].buckets[b]);
+            }
+            if (latencies[l].buckets[b] != 0)
+                SYSTEM_2Print(",ge_%uus=%ui", 1 << (b - 1), latencies[l].buckets[b]);
+            SYSTEM_0Print("\n");
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_PrintProfile
+     *
+     *  @desc   Prints the samples taken in each phase of the GPP by the
+     *          sampling profiler, as a flat profile. Samples are taken on
+     *          the monotonic clock, so time blocked in DSP/BIOS LINK counts.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintProfile(Void)
+    {
+        Uint32 total = 0;
+        Uint32 p;
+
+        for (p = 0; p < NUM_PHASES; p++)
+        {
+            total += phaseSamples[p];
+        }
+
+        SYSTEM_2Print("GPP profile: %d samples, one every %d uSec\n", total, PHASE_PERIOD_USEC);
+        for (p = 0; (total != 0) && (p < NUM_PHASES); p++)
+        {
+            SYSTEM_2Print(phaseFormats[p], phaseSamples[p], (phaseSamples[p] * 100 + total / 2) / total);
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_PrintVariant
+     *
+     *  @desc   Prints a variant of the base kernel, 0 as the default.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintVariant(IN Uint16 variant)
+    {
+        if ((variant == 0) || (variant == VARIANT_FIXED))
+        {
+            SYSTEM_0Print("default\t\t");
+        }
+        else
+        {
+            SYSTEM_1Print("tile %d", variant & VARIANT_TILE);
+            SYSTEM_0Print((variant & VARIANT_AXPY) ? " axpy" : " dot");
+            SYSTEM_0Print((variant & VARIANT_UNROLL4) ? " x4" : "");
+            SYSTEM_0Print((variant & VARIANT_DIRECT) ? " direct\t" : "\t\t");
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Delete
+     *
+     *  @desc   This function releases resources allocated earlier by call to
+     *          helloDSP_Create ().
+     *          During cleanup, the allocated resources are being freed
+     *          unconditionally. Actual applications may require stricter check
+     *          against return values for robustness.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Void helloDSP_Delete(Uint8 processorId)
+    {
+        DSP_STATUS status = DSP_SOK;
+        DSP_STATUS tmpStatus = DSP_SOK;
+        ControlMsgS* msgS;
+
+        SYSTEM_0Print("Entered helloDSP_Delete ()\n");
+
+        /* The process that loaded the DSP also ends its service loop.
+         * The message is not waited for: the DSP frees it. */
+        if ((sessionMode != HELLODSP_ATTACH) && (SampleDspMsgq != (Uint32) MSGQ_INVALIDMSGQ))
+        {
+            status = helloDSP_AllocMsg(CTRLMSG_SIZE(0), &msgS);
+            if (DSP_SUCCEEDED(status))
+            {
+                msgS->command = CMD_SHUTDOWN;
+                MSGQ_setSrcQueue((MsgqMsg) msgS, SampleGppMsgq);
+                status = helloDSP_PutMsg((MsgqMsg) msgS);
+                if (DSP_FAILED(status))
+                {
+                    helloDSP_FreeMsg((MsgqMsg) msgS);
+                    SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+                }
+                else
+                {
+                    METRIC_SENT(CTRLMSG_SIZE(0));
+                }
+            }
+        }
+
+        /* Release the remote message queue */
+        tmpStatus = MSGQ_release(SampleDspMsgq);
+        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        {
+            status = tmpStatus;
+            SYSTEM_1Print("MSGQ_release () failed. Status = [0x%x]\n", status);
+        }
+        SampleDspMsgq = (Uint32) MSGQ_INVALIDMSGQ;
+
+        /* Close the remote transport */
+        tmpStatus = MSGQ_transportClose(processorId);
+        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        {
+            status = tmpStatus;
+            SYSTEM_1Print("MSGQ_transportClose () failed. Status = [0x%x]\n", status);
+        }
+
+        /* Stop execution on DSP, unless it belongs to a daemon. */
+        if (sessionMode != HELLODSP_ATTACH)
+        {
+            tmpStatus = PROC_stop(processorId);
+            if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+            {
+                status = tmpStatus;
+                SYSTEM_1Print("PROC_stop () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Reset the error handler before deleting the MSGQ that receives */
+        /* the error messages.                                            */
+        tmpStatus = MSGQ_setErrorHandler(MSGQ_INVALIDMSGQ, MSGQ_INVALIDMSGQ);
+
+        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        {
+            status = tmpStatus;
+            SYSTEM_1Print("MSGQ_setErrorHandler () failed. Status = [0x%x]\n", status);
+        }
+
+        /* Close the GPP's message queue */
+        tmpStatus = MSGQ_close(SampleGppMsgq);
+        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        {
+            status = tmpStatus;
+            SYSTEM_1Print("MSGQ_close () failed. Status = [0x%x]\n", status);
+        }
+
+        /* Close the pool */
+        tmpStatus = POOL_close(POOL_makePoolId(processorId, SAMPLE_POOL_ID));
+        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        {
+            status = tmpStatus;
+            SYSTEM_1Print("POOL_close () failed. Status = [0x%x]\n", status);
+        }
+
+        /* Detach from the processor */
+        tmpStatus = PROC_detach(processorId);
+        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        {
+            status = tmpStatus;
+            SYSTEM_1Print("PROC_detach () failed. Status = [0x%x]\n", status);
+        }
+
+        /* Destroy the PROC object. */
+        tmpStatus = PROC_destroy();
+        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        {
+            status = tmpStatus;
+            SYSTEM_1Print("PROC_destroy () failed. Status = [0x%x]\n", status);
+        }
+
+        /* Delete the ready semaphore */
+        SYSTEM_DeleteSem(readySem);
+        readySem = NULL;
+
+        /* Free the working buffers */
+        SYSTEM_Free(arenaBase);
+        arenaBase = NULL;
+        arenaSize = 0;
+        arenaUsed = 0;
+
+        SYSTEM_0Print("Leaving helloDSP_Delete ()\n");
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ReadyNotify
+     *
+     *  @desc   NOTIFY callback invoked when the DSP has opened its message
+     *          queue.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_ReadyNotify(IN Uint32 eventNo, IN Pvoid arg, IN Pvoid info)
+    {
+        (Void) eventNo;
+        (Void) info;
+
+        SYSTEM_PostSem(arg);
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_EchoNotify
+     *
+     *  @desc   NOTIFY callback invoked when the DSP echoes an event of the
+     *          link benchmark. Keeps its payload and wakes the sender.
+     *
+     *  @modif  echoValue
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_EchoNotify(IN Uint32 eventNo, IN Pvoid arg, IN Pvoid info)
+    {
+        (Void) eventNo;
+
+        echoValue = (Uint32) info;
+        SYSTEM_PostSem(arg);
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_SendEcho
+     *
+     *  @desc   Sends msgS as the CMD_ECHO message number seq. With touch, the
+     *          payload is filled with a pattern of seq first, for the DSP to
+     *          complement. A message that cannot be sent is freed.
+     *
+     *  @modif  msgS
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_SendEcho(IN ControlMsgS* msgS, IN Uint32 seq,
+                                                   IN Bool touch)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Uint16 size = MSGQ_getMsgSize((MsgqMsg) msgS);
+        Uint32* words = (Uint32*) msgS->arg2;
+        Uint32 i;
+
+        msgS->command = CMD_ECHO;
+        msgS->matrixSize = 0;
+        msgS->jobId = (Uint16) (seq % MSGQ_INTERNALIDSSTART);
+        msgS->rowStart = 0;
+        msgS->numRows = 0;
+        msgS->kernel = KERNEL_BASE;
+        msgS->kernelParam = touch ? ECHO_TOUCH : 0;
+        msgS->accum = ACCUM_WRAP;
+        msgS->elemSize = sizeof(Uint32);
+        msgS->format = FORMAT_DENSE;
+        msgS->nnz = 0;
+        msgS->dimM = 0;
+        msgS->dimN = 0;
+        msgS->dimK = 0;
+        msgS->trans = 0;
+        msgS->alpha = 1;
+        if (touch)
+        {
+            for (i = 0; i < (size - CTRLMSG_HDR_SIZE) / sizeof(Uint32); i++)
+                words[i] = (seq << 16) ^ i;
+        }
+        MSGQ_setMsgId((MsgqMsg) msgS, msgS->jobId);
+        MSGQ_setSrcQueue((MsgqMsg) msgS, SampleGppMsgq);
+
+        PHASE_ENTER(PHASE_LINK);
+        status = helloDSP_PutMsg((MsgqMsg) msgS);
+        PHASE_ENTER(PHASE_OTHER);
+        if (DSP_FAILED(status))
+        {
+            helloDSP_FreeMsg((MsgqMsg) msgS);
+            SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+        }
+        else
+        {
+            METRIC_SENT(size);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_RunEcho
+     *
+     *  @desc   Sends LINKBENCH_PASSES CMD_ECHO messages of size bytes,
+     *          keeping up to window of them in flight, and times them until
+     *          the last echo. Each echo is sent again until all are, so no
+     *          buffer is allocated while timing. The window is limited to
+     *          the buffers of the size available in the pool. With touch,
+     *          the payload of each echo is checked.
+     *
+     *  @modif  stats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunEcho(IN Uint16 size, IN Uint32 window, IN Bool touch,
+                                                  OUT EchoStats* stats)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* msgs[LINKBENCH_WINDOW];
+        ControlMsgS* msgS;
+        Uint32* words;
+        Uint32 count = 0;
+        Uint32 sent = 0;
+        Uint32 start;
+        Uint32 seq;
+        Uint32 i;
+
+        stats->messages = 0;
+        stats->window = 0;
+        stats->incorrect = 0;
+        stats->elapsedTime = 0;
+        stats->touchCycles = 0;
+        stats->cacheCycles = 0;
+        stats->dspConfig = 0;
+
+        /* Other processes may hold some of the buffers: keep those found */
+        status = helloDSP_AllocMsg(size, &msgs[0]);
+        if (DSP_SUCCEEDED(status))
+        {
+            for (count = 1;
+                 (count < window)
+                 && DSP_SUCCEEDED(MSGQ_alloc(SAMPLE_POOL_ID, size, (MsgqMsg *) &msgs[count]));
+                 count++)
+            {
+                helloDSP_CountBuffer(size, TRUE);
+            }
+            stats->window = count;
+        }
+
+        start = SYSTEM_GetUsecTime();
+        for (i = 0; DSP_SUCCEEDED(status) && (i < count); i++)
+        {
+            status = helloDSP_SendEcho(msgs[i], sent++, touch);
+        }
+        for (; i < count; i++)
+        {
+            helloDSP_FreeMsg((MsgqMsg) msgs[i]);
+        }
+
+        while (DSP_SUCCEEDED(status) && (stats->messages < sent))
+        {
+            PHASE_ENTER(PHASE_WAIT);
+            status = helloDSP_GetMsg((MsgqMsg *) &msgS);
+            PHASE_ENTER(PHASE_OTHER);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("MSGQ_get () failed. Status = [0x%x]\n", status);
+                break;
+            }
+
+            METRIC_RECEIVED(msgS);
+            seq = stats->messages++;
+            if ((msgS->command != CMD_ECHOED) || (msgS->jobId != (Uint16) (seq % MSGQ_INTERNALIDSSTART)))
+            {
+                status = DSP_EFAIL;
+                SYSTEM_2Print("Unexpected reply 0x%x to echo %d\n", msgS->command, seq);
+                helloDSP_FreeMsg((MsgqMsg) msgS);
+                break;
+            }
+
+            if (touch)
+            {
+                words = (Uint32*) msgS->arg2;
+                for (i = 0; (i < (size - CTRLMSG_HDR_SIZE) / sizeof(Uint32))
+                            && (words[i] == ~((seq << 16) ^ i)); i++)
+                    ;
+                if (i < (size - CTRLMSG_HDR_SIZE) / sizeof(Uint32))
+                    stats->incorrect++;
+            }
+            stats->touchCycles += msgS->arg1;
+            stats->cacheCycles += msgS->cacheCycles;
+            stats->dspConfig = msgS->dspConfig;
+
+            if (sent < LINKBENCH_PASSES)
+                status = helloDSP_SendEcho(msgS, sent++, touch);
+            else
+                helloDSP_FreeMsg((MsgqMsg) msgS);
+        }
+        stats->elapsedTime = SYSTEM_GetUsecTime() - start;
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_RunNotifyEcho
+     *
+     *  @desc   Sends LINKBENCH_PASSES NOTIFY events to the DSP, each once
+     *          the echo of the previous one arrived, and times them. The
+     *          payload of each echo is checked.
+     *
+     *  @modif  stats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_RunNotifyEcho(IN Uint8 processorId, OUT EchoStats* stats)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Pvoid echoSem = NULL;
+        Uint32 start;
+        Uint32 i;
+
+        stats->messages = 0;
+        stats->window = 1;
+        stats->incorrect = 0;
+        stats->elapsedTime = 0;
+        stats->touchCycles = 0;
+        stats->cacheCycles = 0;
+        stats->dspConfig = 0;
+
+        status = SYSTEM_CreateSem(&echoSem);
+        if (DSP_SUCCEEDED(status))
+        {
+            status = NOTIFY_register(processorId, ECHO_IPS_ID, ECHO_EVENT_NO,
+                                     (FnNotifyCbck) helloDSP_EchoNotify, echoSem);
+            if (DSP_FAILED(status))
+            {
+                SYSTEM_1Print("NOTIFY_register () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            start = SYSTEM_GetUsecTime();
+            for (i = 0; DSP_SUCCEEDED(status) && (i < LINKBENCH_PASSES); i++)
+            {
+                PHASE_ENTER(PHASE_LINK);
+                status = NOTIFY_notify(processorId, ECHO_IPS_ID, ECHO_EVENT_NO, i);
+                PHASE_ENTER(PHASE_WAIT);
+                if (DSP_FAILED(status))
+                {
+                    SYSTEM_1Print("NOTIFY_notify () failed. Status = [0x%x]\n", status);
+                }
+                else if (DSP_FAILED(SYSTEM_WaitSem(echoSem, ECHO_TIMEOUT_USEC)))
+                {
+                    status = DSP_ETIMEOUT;
+                    SYSTEM_1Print("Echo of event %d lost\n", i);
+                }
+                else
+                {
+                    stats->messages++;
+                    if (echoValue != i)
+                        stats->incorrect++;
+                }
+                PHASE_ENTER(PHASE_OTHER);
+            }
+            stats->elapsedTime = SYSTEM_GetUsecTime() - start;
+
+            NOTIFY_unregister(processorId, ECHO_IPS_ID, ECHO_EVENT_NO,
+                              (FnNotifyCbck) helloDSP_EchoNotify, echoSem);
+        }
+
+        if (echoSem != NULL)
+        {
+            SYSTEM_DeleteSem(echoSem);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_PrintEcho
+     *
+     *  @desc   Prints the round trip of the latency run, one message in
+     *          flight, the bandwidth of the stream run in MB/s each way and
+     *          its window, and the DSP cycles per message of touching and
+     *          writing back the payload.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_PrintEcho(IN const Char8* link, IN Uint32 size,
+                                              IN const EchoStats* latency, IN const EchoStats* stream)
+    {
+        AccumWide roundTrip = (latency->messages == 0) ? 0
+                              : (AccumWide) latency->elapsedTime * 100 / latency->messages;
+        AccumWide bandwidth = (stream->elapsedTime == 0) ? 0
+                              : (AccumWide) size * stream->messages * 100 / stream->elapsedTime;
+        Uint32 messages = (latency->messages == 0) ? 1 : latency->messages;
+
+        SYSTEM_1Print("%-8s\t", (Uint32) link);
+        SYSTEM_1Print("%d\t", size);
+        SYSTEM_2Print("%d.%02d\t\t", (Uint32) (roundTrip / 100), (Uint32) (roundTrip % 100));
+        SYSTEM_2Print("%d.%02d\t", (Uint32) (bandwidth / 100), (Uint32) (bandwidth % 100));
+        SYSTEM_1Print("%d\t", stream->window);
+        SYSTEM_2Print("%d/%d", latency->touchCycles / messages, latency->cacheCycles / messages);
+        if (latency->incorrect + stream->incorrect != 0)
+            SYSTEM_1Print("\t%d incorrect", latency->incorrect + stream->incorrect);
+        SYSTEM_0Print("\n");
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_SizePool
+     *
+     *  @desc   Computes the buffer classes and counts of the pool. Besides
+     *          the buffers used by the transport and those of the
+     *          statistics, each job in flight needs its operand blocks and
+     *          its product blocks. The pipeline depth is limited to the
+     *          batch size and lowered until the pool fits in POOLMEM. The
+     *          classes are printed when verbose.
+     *
+     *  @modif  SampleBufSizes, SampleNumBuffers, SamplePoolAttrs, sessionDepth,
+     *          sessionSize
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_SizePool(IN Uint32 matrixSize, IN Uint32 pipelineDepth,
+                                                   IN Uint32 batchSize, IN Bool verbose)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Uint32 ctrlSize = DSPLINK_ALIGN (SAMPLEMQT_CTRLMSG_SIZE, DSPLINK_BUF_ALIGN);
+        Uint32 locateSize = DSPLINK_ALIGN (sizeof(MSGQ_AsyncLocateMsg), DSPLINK_BUF_ALIGN);
+        Uint32 errorSize = DSPLINK_ALIGN (sizeof(MSGQ_AsyncErrorMsg), DSPLINK_BUF_ALIGN);
+        Uint32 statsSize = CTRLMSG_SIZE(sizeof(DspStats));
+        Uint32 benchSize = CTRLMSG_SIZE(BENCH_ENTRIES * sizeof(BenchEntry));
+        Uint32 systemBytes = ctrlSize * NUM_CTRLMSG + locateSize * NUM_LOCATEMSG + errorSize * NUM_ERRORMSG
+                             + statsSize * NUM_STATSMSG + benchSize * NUM_BENCHMSG;
+        Uint32 jobBytes = helloDSP_AddJobClasses(matrixSize, 1, FALSE);
+        Uint32 depth = (pipelineDepth < batchSize) ? pipelineDepth : batchSize;
+        Uint32 i;
+
+        /* Application messages must not compete with the transport for its
+         * buffer classes. */
+        if ((ctrlSize >= CTRLMSG_MIN_SIZE) || (locateSize >= CTRLMSG_MIN_SIZE)
+            || (errorSize >= CTRLMSG_MIN_SIZE))
+        {
+            status = DSP_EFAIL;
+            SYSTEM_1Print("ERROR! Transport messages need buffers larger than %d bytes\n", CTRLMSG_MIN_SIZE);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            while ((depth > 0)
+                   && (systemBytes + depth * jobBytes > POOL_MEM_SIZE - POOL_RESERVE_SIZE))
+            {
+                depth--;
+            }
+
+            if (depth == 0)
+            {
+                status = DSP_EMEMORY;
+                SYSTEM_1Print("ERROR! A single job of size %d does not fit in the pool\n", matrixSize);
+            }
+            else if (depth < pipelineDepth && depth < batchSize)
+            {
+                SYSTEM_2Print("Pipeline depth lowered from %d to %d to fit in the pool\n", pipelineDepth, depth);
+            }
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            SamplePoolAttrs.numBufPools = 0;
+            helloDSP_AddBufClass(ctrlSize, NUM_CTRLMSG);
+            helloDSP_AddBufClass(locateSize, NUM_LOCATEMSG);
+            helloDSP_AddBufClass(errorSize, NUM_ERRORMSG);
+            helloDSP_AddBufClass(statsSize, NUM_STATSMSG);
+            helloDSP_AddBufClass(benchSize, NUM_BENCHMSG);
+            helloDSP_AddJobClasses(matrixSize, depth, TRUE);
+            sessionDepth = depth;
+            sessionSize = matrixSize;
+        }
+
+        if (DSP_SUCCEEDED(status) && verbose)
+        {
+            for (i = 0; i < SamplePoolAttrs.numBufPools; i++)
+            {
+                SYSTEM_2Print("Pool: %d buffers of %d bytes\n", SampleNumBuffers[i], SampleBufSizes[i]);
+            }
+            SYSTEM_2Print("Pool: %d of %d bytes used\n", systemBytes + depth * jobBytes, POOL_MEM_SIZE);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_JoinPool
+     *
+     *  @desc   The pool of an attached process is the one the daemon opened,
+     *          sized for jobs of the size and number it described to the
+     *          DSP with CMD_POOL. The buffer classes are computed again from
+     *          that description, and the pipeline depth is limited to the
+     *          jobs the pool holds. Jobs larger than the daemon's are
+     *          refused here rather than stalling on the pool later.
+     *
+     *  @modif  SampleBufSizes, SampleNumBuffers, SamplePoolAttrs, sessionDepth,
+     *          sessionSize
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_JoinPool(IN Uint32 matrixSize, IN Uint32 pipelineDepth,
+                                                   IN Uint32 batchSize)
+    {
+        DSP_STATUS status = DSP_SOK;
+        DspStats dspStats;
+        Uint32 depth = (pipelineDepth < batchSize) ? pipelineDepth : batchSize;
+
+        status = helloDSP_QueryStats(&dspStats);
+        if (DSP_SUCCEEDED(status) && (dspStats.poolDepth == 0))
+        {
+            status = DSP_ENOTREADY;
+            SYSTEM_0Print("The helloDSP daemon did not describe its pool\n");
+        }
+        else if (DSP_SUCCEEDED(status) && (matrixSize > dspStats.poolSize))
+        {
+            status = DSP_EINVALIDARG;
+            SYSTEM_1Print("ERROR! The pool of the daemon holds jobs up to size %d\n", dspStats.poolSize);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_SizePool(dspStats.poolSize, dspStats.poolDepth, dspStats.poolDepth, FALSE);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            if (depth > dspStats.poolDepth)
+            {
+                SYSTEM_2Print("Pipeline depth lowered from %d to %d to fit in the pool\n", depth,
+                              dspStats.poolDepth);
+                depth = dspStats.poolDepth;
+            }
+            sessionDepth = depth;
+            sessionSize = matrixSize;
+            SYSTEM_2Print("Pool: shared with the daemon, %d jobs of size %d\n", dspStats.poolDepth,
+                          dspStats.poolSize);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_AddBufClass
+     *
+     *  @desc   Adds buffers of the given size to the pool configuration.
+     *          Classes are kept in ascending order of size, as the pool
+     *          hands out the first class large enough for a request, and
+     *          buffers of an existing size are added to its class.
+     *
+     *  @modif  SampleBufSizes, SampleNumBuffers, SamplePoolAttrs
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_AddBufClass(IN Uint32 size, IN Uint32 count)
+    {
+        Uint32 i;
+        Uint32 j;
+
+        for (i = 0; (i < SamplePoolAttrs.numBufPools) && (SampleBufSizes[i] < size); i++)
+            ;
+
+        if ((i < SamplePoolAttrs.numBufPools) && (SampleBufSizes[i] == size))
+        {
+            SampleNumBuffers[i] += count;
+        }
+        else
+        {
+            for (j = SamplePoolAttrs.numBufPools; j > i; j--)
+            {
+                SampleBufSizes[j] = SampleBufSizes[j - 1];
+                SampleNumBuffers[j] = SampleNumBuffers[j - 1];
+            }
+            SampleBufSizes[i] = size;
+            SampleNumBuffers[i] = count;
+            SamplePoolAttrs.numBufPools++;
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_AddJobClasses
+     *
+     *  @desc   Adds the row blocks of the given number of jobs to the pool
+     *          configuration when add is TRUE. Blocks are allocated with the
+     *          size they need, so a short last block gets a class of its own
+     *          rather than a buffer meant for a full block.
+     *
+     *  @ret    Bytes of the row blocks.
+     *
+     *  @modif  SampleBufSizes, SampleNumBuffers, SamplePoolAttrs
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_AddJobClasses(IN Uint32 matrixSize, IN Uint32 numJobs, IN Bool add)
+    {
+        Uint32 sizes[4];
+        Uint32 counts[4];
+        Uint32 bytes = 0;
+        Uint32 i;
+
+        /* Operand blocks: both operands, sized for 16-bit elements. Blocks
+         * of 8-bit elements are fewer and no larger. */
+        sizes[0] = CTRLMSG_SIZE(CTRLMSG_BLOCK_ROWS(matrixSize, sizeof(Uint16)) * matrixSize * sizeof(Uint16));
+        counts[0] = 2 * (CTRLMSG_BLOCKS(matrixSize, sizeof(Uint16)) - 1);
+        sizes[1] = CTRLMSG_SIZE(CTRLMSG_TAIL_ROWS(matrixSize, sizeof(Uint16)) * matrixSize * sizeof(Uint16));
+        counts[1] = 2;
+
+        /* Product blocks, sized for 64-bit elements. Blocks of 32-bit
+         * elements are fewer and no larger, so they fit the same buffers. */
+        sizes[2] = CTRLMSG_SIZE(CTRLMSG_BLOCK_ROWS(matrixSize, RESULT_ELEM_MAX) * matrixSize * RESULT_ELEM_MAX);
+        counts[2] = CTRLMSG_BLOCKS(matrixSize, RESULT_ELEM_MAX) - 1;
+        sizes[3] = CTRLMSG_SIZE(CTRLMSG_TAIL_ROWS(matrixSize, RESULT_ELEM_MAX) * matrixSize * RESULT_ELEM_MAX);
+        counts[3] = 1;
+
+        for (i = 0; i < 4; i++)
+        {
+            bytes += sizes[i] * counts[i] * numJobs;
+            if (add && (counts[i] > 0))
+            {
+                helloDSP_AddBufClass(sizes[i], counts[i] * numJobs);
+            }
+        }
+
+        return bytes;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaAlloc
+     *
+     *  @desc   Allocates size bytes from the arena, aligned to ARENA_ALIGN
+     *          for the cache lines and the NEON loads of the GPP. The
+     *          buffer lives until the arena is released to a mark taken
+     *          before it.
+     *
+     *  @modif  arenaUsed
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_ArenaAlloc(IN Uint32 size, OUT Pvoid* addrPtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Uint32 start = (arenaUsed + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+        if ((arenaBase == NULL) || (start > arenaSize) || (size > arenaSize - start))
+        {
+            status = DSP_EMEMORY;
+            *addrPtr = NULL;
+            SYSTEM_2Print("ERROR! Arena exhausted: %d bytes requested, %d free\n",
+                          size, (start < arenaSize) ? arenaSize - start : 0);
+        }
+        else
+        {
+            *addrPtr = (Pvoid) (arenaBase + start);
+            arenaUsed = start + size;
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaOperands
+     *
+     *  @desc   Allocates both operands and the reference product of a
+     *          matrixSize square job, each with a row stride of matrixSize.
+     *
+     *  @modif  arenaUsed
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_ArenaOperands(IN Uint32 matrixSize,
+                                                        OUT Uint16** mat1, OUT Uint16** mat2,
+                                                        OUT AccumWide** prod)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Uint32 elems = matrixSize * matrixSize;
+
+        status = helloDSP_ArenaAlloc(elems * sizeof(Uint16), (Pvoid*) mat1);
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(elems * sizeof(Uint16), (Pvoid*) mat2);
+        }
+        if (DSP_SUCCEEDED(status))
+        {
+            status = helloDSP_ArenaAlloc(elems * sizeof(AccumWide), (Pvoid*) prod);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaMark
+     *
+     *  @desc   Returns the current top of the arena, to be given to
+     *          helloDSP_ArenaRelease () once the buffers allocated after it
+     *          are no longer needed.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Uint32 helloDSP_ArenaMark(Void)
+    {
+        return arenaUsed;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ArenaRelease
+     *
+     *  @desc   Releases every buffer allocated since mark was taken.
+     *
+     *  @modif  arenaUsed
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_ArenaRelease(IN Uint32 mark)
+    {
+        arenaUsed = mark;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_AllocMsg
+     *
+     *  @desc   Allocates an application message of the given size. The pool
+     *          only holds the buffers of sessionDepth jobs, which are shared
+     *          with other processes attached to the same DSP, so an
+     *          exhausted pool is retried for a while.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_AllocMsg(IN Uint16 size, OUT ControlMsgS** msgPtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Uint32 retries = 0;
+        Uint32 phase = gppPhase;
+
+        PHASE_ENTER(PHASE_LINK);
+        do
+        {
+            status = MSGQ_alloc(SAMPLE_POOL_ID, size, (MsgqMsg *) msgPtr);
+            if (DSP_FAILED(status))
+            {
+                METRIC_ADD(METRIC_ALLOC_RETRIES, 1);
+                SYSTEM_Sleep(ALLOC_RETRY_USEC);
+            }
+        } while (DSP_FAILED(status) && (++retries < ALLOC_RETRIES));
+
+        if (DSP_FAILED(status))
+        {
+            METRIC_ADD(METRIC_ALLOC_FAILURES, 1);
+            *msgPtr = NULL;
+            SYSTEM_1Print("MSGQ_alloc () failed. Status = [0x%x]\n", status);
+        }
+        else
+        {
+            helloDSP_CountBuffer(size, TRUE);
+        }
+
+        PHASE_ENTER(phase);
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_FreeMsg
+     *
+     *  @desc   Frees an application message held by this process, whether
+     *          allocated here or received from the DSP.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_FreeMsg(IN MsgqMsg msg)
+    {
+        helloDSP_CountBuffer(MSGQ_getMsgSize(msg), FALSE);
+        MSGQ_free(msg);
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_PutMsg
+     *
+     *  @desc   Sends an application message held by this process to the
+     *          DSP, which owns it once sent. The message stays held when
+     *          it could not be sent.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_PutMsg(IN MsgqMsg msg)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Uint32 size = MSGQ_getMsgSize(msg);
+
+        status = MSGQ_put(SampleDspMsgq, msg);
+        if (DSP_SUCCEEDED(status))
+        {
+            helloDSP_CountBuffer(size, FALSE);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GetMsg
+     *
+     *  @desc   Waits for a message of the DSP on the queue of this process.
+     *          The message is held until freed or sent back.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_GetMsg(OUT MsgqMsg* msgPtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+
+        status = MSGQ_get(SampleGppMsgq, WAIT_FOREVER, msgPtr);
+        if (DSP_SUCCEEDED(status))
+        {
+            helloDSP_CountBuffer(MSGQ_getMsgSize(*msgPtr), TRUE);
+        }
+
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_CountBuffer
+     *
+     *  @desc   Counts the buffer of a message of the given size as taken
+     *          by this process when held is TRUE, or given back otherwise.
+     *          The pool serves a message from the smallest class that fits
+     *          it. Messages of no class, such as those exchanged before the
+     *          pool is sized, are not counted either way.
+     *
+     *  @modif  poolHeld, poolHeldPeak, poolBuffers, poolBytes,
+     *          poolBuffersPeak, poolBytesPeak
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_CountBuffer(IN Uint32 size, IN Bool held)
+    {
+        Uint32 i;
+
+        for (i = 0; (i < SamplePoolAttrs.numBufPools) && (SampleBufSizes[i] < size); i++)
+            ;
+
+        if (i < SamplePoolAttrs.numBufPools)
+        {
+            if (held)
+            {
+                poolHeld[i]++;
+                poolBuffers++;
+                poolBytes += SampleBufSizes[i];
+                if (poolHeld[i] > poolHeldPeak[i])
+                    poolHeldPeak[i] = poolHeld[i];
+                if (poolBuffers > poolBuffersPeak)
+                    poolBuffersPeak = poolBuffers;
+                if (poolBytes > poolBytesPeak)
+                    poolBytesPeak = poolBytes;
+            }
+            else if (poolHeld[i] > 0)
+            {
+                poolHeld[i]--;
+                poolBuffers--;
+                poolBytes -= SampleBufSizes[i];
+            }
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ResetPoolPeak
+     *
+     *  @desc   Starts the high-water marks of the pool over from the
+     *          buffers held now.
+     *
+     *  @modif  poolHeldPeak, poolBuffersPeak, poolBytesPeak
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_ResetPoolPeak(Void)
+    {
+        Uint32 i;
+
+        for (i = 0; i < MAX_BUF_POOLS; i++)
+            poolHeldPeak[i] = poolHeld[i];
+        poolBuffersPeak = poolBuffers;
+        poolBytesPeak = poolBytes;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_RecordLatency
+     *
+     *  @desc   Adds uSec to the histogram of latency, see LATENCY_*.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_RecordLatency(IN Uint32 latency, IN Uint32 uSec)
+    {
+        Uint32 b;
+
+        for (b = 0; (b < LATENCY_BUCKETS - 1) && ((uSec >> b) != 0); b++)
+            ;
+        latencies[latency].count++;
+        latencies[latency].sum += uSec;
+        latencies[latency].buckets[b]++;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_JobSubmitted
+     *
+     *  @desc   Counts a job whose operands were all sent, submitted at
+     *          start, as in flight until helloDSP_JobDone ().
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_JobSubmitted(IN Uint32 start)
+    {
+        Uint32 slot;
+
+        if (jobTimed < METRIC_JOB_SLOTS)
+        {
+            slot = (jobHead + jobTimed) % METRIC_JOB_SLOTS;
+            jobSeq[slot] = jobNext + metrics[METRIC_JOBS_IN_FLIGHT];
+            jobStart[slot] = start;
+            jobTimed++;
+        }
+        METRIC_ADD(METRIC_JOBS_SUBMITTED, 1);
+        METRIC_ADD(METRIC_JOBS_IN_FLIGHT, 1);
+        if (metrics[METRIC_JOBS_IN_FLIGHT] > metrics[METRIC_JOBS_IN_FLIGHT_PEAK])
+        {
+            metrics[METRIC_JOBS_IN_FLIGHT_PEAK] = metrics[METRIC_JOBS_IN_FLIGHT];
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_JobDone
+     *
+     *  @desc   Counts the oldest job in flight as completed, recording its
+     *          latency, or as failed. A dump of the metrics requested
+     *          meanwhile is done here, between jobs.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_JobDone(IN Bool failed)
+    {
+        if (metrics[METRIC_JOBS_IN_FLIGHT] != 0)
+        {
+            if ((jobTimed != 0) && (jobSeq[jobHead] == jobNext))
+            {
+                if (!failed)
+                {
+                    helloDSP_RecordLatency(LATENCY_JOB, SYSTEM_GetUsecTime() - jobStart[jobHead]);
+                }
+                jobHead = (jobHead + 1) % METRIC_JOB_SLOTS;
+                jobTimed--;
+            }
+            jobNext++;
+            metrics[METRIC_JOBS_IN_FLIGHT]--;
+        }
+        METRIC_ADD(failed ? METRIC_JOBS_FAILED : METRIC_JOBS_COMPLETED, 1);
+
+        if (SYSTEM_DumpRequested())
+        {
+            helloDSP_DumpMetrics();
+        }
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Submit
+     *
+     *  @desc   Sends both operands of a job to the DSP in row blocks, read
+     *          in place from the storage described by the job. All
+     *          blocks are allocated before the first one is sent, so the DSP
+     *          never waits for the rest of a job on an exhausted pool.
+     *          The DSP frees operand blocks once they are stored.
+     *          Blocks are allocated with the size they need, which bounds the
+     *          writeback done by MSGQ_put () to the bytes written here; 8-bit
+     *          elements halve it. The non-zeros of each block are counted
+     *          first, and an operand is sent in CSR form when that makes
+     *          every one of its blocks smaller, so the pool sized for dense
+     *          blocks still fits them. Otherwise, when the job allows it, an
+     *          operand is delta-coded under the same condition, provided it
+     *          shrinks to 1 / DELTA_MIN_RATIO of its dense size or less.
+     *          GEMM operands are always dense. The operands of a job with
+     *          generators are sent as a single generated block each.
+     *
+     *  @modif  stats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_Submit(IN Uint16 jobId, IN const JobDesc* job,
+                                                 IN OUT JobStats* stats)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* blocks[MAX_OPERAND_BLOCKS];
+        const Uint16* src[2];
+        const Uint16* row;
+        Uint32 ld[2];
+        Uint32 height[2];
+        Uint32 width[2];
+        Uint32 blockRows[2];
+        Uint32 numBlocks[2];
+        Uint32 blockNnz[MAX_OPERAND_BLOCKS];
+        Uint32 blockBits[MAX_OPERAND_BLOCKS];
+        Uint32 payload[MAX_OPERAND_BLOCKS];
+        Uint32 denseBytes[2];
+        Uint32 deltaBytes[2];
+        Bool sparse[2];
+        Bool delta[2];
+        Uint16 elemMask = (job->elemSize == sizeof(Uint8)) ? 0xFF : 0xFFFF;
+        Uint16 code;
+        Uint16 maxCode;
+        Uint32* words;
+        Uint32 bitPos;
+        Uint32 shift;
+        Uint16* rowPtr;
+        Uint16* cols;
+        Uint16* values;
+        Uint8* bytes;
+        Uint32 allocated = 0;
+        Uint32 sent = 0;
+        Uint32 rowStart;
+        Uint32 numRows;
+        Uint32 start;
+        Uint32 submitStart;
+        Uint32 phase = gppPhase;
+        Uint32 i, j, k, p, op;
 
-                /* Matrix generation is not accounted in the elapsed time */
-#if defined (PROFILE)
-                SYSTEM_GetEndTime();
-                elapsedTime += SYSTEM_GetProfileInfo();
-#endif
-                for (j = 0; j < matrixSize; j++)
-                    for (k = 0; k < matrixSize; k++)
-                        matrixPtS[j][k] = j+k*3;
+        submitStart = SYSTEM_GetUsecTime();
+        PHASE_ENTER(PHASE_PACK);
 
-                /* Start the timer again */
-#if defined (PROFILE)
-                SYSTEM_GetStartTime();
-#endif
+        /* Operands as stored */
+        src[0] = job->a;
+        ld[0] = job->lda;
+        height[0] = (job->trans & TRANS_A) ? job->dimK : job->dimM;
+        width[0] = (job->trans & TRANS_A) ? job->dimM : job->dimK;
+        src[1] = job->b;
+        ld[1] = job->ldb;
+        height[1] = (job->trans & TRANS_B) ? job->dimN : job->dimK;
+        width[1] = (job->trans & TRANS_B) ? job->dimK : job->dimN;
+        for (op = 0; op < 2; op++)
+        {
+            blockRows[op] = CTRLMSG_ROW_BLOCK_ROWS(height[op], width[op], job->elemSize);
+            numBlocks[op] = CTRLMSG_ROW_BLOCKS(height[op], width[op], job->elemSize);
+            sparse[op] = (job->kernel != KERNEL_GEMM) && (job->gen == NULL);
+            delta[op] = job->compress && (job->kernel != KERNEL_GEMM) && (job->gen == NULL);
+            denseBytes[op] = 0;
+            deltaBytes[op] = 0;
+            if (job->gen != NULL)
+            {
+                blockRows[op] = height[op];
+                numBlocks[op] = 1;
             }
+        }
 
-            /* Store first half of the result */
-            if (i == 2) {
-                for (j = 0; (j < matrixSize) && (j < ARG2_SIZE/2); j++) {
-                    for (k = 0; k < matrixSize; k++)
-                        resFromDSP[j][k] = matrixPtL[j][k];
-                }
+        /* Density of the blocks, and the width of their deltas */
+        for (i = 0; (job->gen == NULL) && (i < numBlocks[0] + numBlocks[1]); i++)
+        {
+            op = (i < numBlocks[0]) ? 0 : 1;
+            rowStart = (i - op * numBlocks[0]) * blockRows[op];
+            numRows = (height[op] - rowStart < blockRows[op]) ? (height[op] - rowStart) : blockRows[op];
 
-                msgId = MSGQ_getMsgId(msgS);
-                MSGQ_setMsgId(msgS, msgId);
-                status = MSGQ_put(SampleDspMsgq, (MsgqMsg) msgS);
+            blockNnz[i] = 0;
+            maxCode = 0;
+            for (j = 0; j < numRows; j++)
+            {
+                row = src[op] + (rowStart + j) * ld[op];
+                for (k = 0; k < width[op]; k++)
+                {
+                    if (row[k] != 0)
+                        blockNnz[i]++;
+                    if (job->compress && (k != 0))
+                    {
+                        code = DELTA_ZIGZAG((Uint16) ((row[k] & elemMask) - (row[k - 1] & elemMask)));
+                        if (code > maxCode)
+                            maxCode = code;
+                    }
+                }
             }
+            for (blockBits[i] = 0; (maxCode >> blockBits[i]) != 0; blockBits[i]++)
+                ;
 
-            /* Store second half of the result,
-             * print the result and free the message. */
-            else if (i == 3) {
-                for (j = ARG2_SIZE/2; j < matrixSize; j++) {
-                    for (k = 0; k < matrixSize; k++)
-                        resFromDSP[j][k] = matrixPtL[j-ARG2_SIZE/2][k];
-                }
+            if (CTRLMSG_CSR_BYTES(numRows, blockNnz[i], job->elemSize)
+                >= numRows * width[op] * job->elemSize)
+            {
+                sparse[op] = FALSE;
+            }
+            if (CTRLMSG_DELTA_BYTES(numRows, width[op], blockBits[i])
+                >= numRows * width[op] * job->elemSize)
+            {
+                delta[op] = FALSE;
+            }
+            denseBytes[op] += numRows * width[op] * job->elemSize;
+            deltaBytes[op] += CTRLMSG_DELTA_BYTES(numRows, width[op], blockBits[i]);
+        }
 
-                /* Printing of the result is not accounted in the elapsed time */
-#if defined (PROFILE)
-                SYSTEM_GetEndTime();
-                elapsedTime += SYSTEM_GetProfileInfo();
-#endif
-                for (j = 0; j < matrixSize; j++) {
-                    SYSTEM_0Print("\n");
-                    for (k = 0; k < matrixSize; k++)
-                        SYSTEM_1Print("\t%d ", resFromDSP[j][k]);
-                }
+        /* CSR first, as it also saves the DSP work; delta coding only when
+         * it pays for its decoding */
+        for (op = 0; op < 2; op++)
+        {
+            delta[op] = delta[op] && !sparse[op] && (deltaBytes[op] * DELTA_MIN_RATIO <= denseBytes[op]);
+        }
+        for (i = 0; i < numBlocks[0] + numBlocks[1]; i++)
+        {
+            op = (i < numBlocks[0]) ? 0 : 1;
+            rowStart = (i - op * numBlocks[0]) * blockRows[op];
+            numRows = (height[op] - rowStart < blockRows[op]) ? (height[op] - rowStart) : blockRows[op];
+            payload[i] = (job->gen != NULL) ? sizeof(GenSpec)
+                       : sparse[op] ? CTRLMSG_CSR_BYTES(numRows, blockNnz[i], job->elemSize)
+                       : delta[op] ? CTRLMSG_DELTA_BYTES(numRows, width[op], blockBits[i])
+                       : numRows * width[op] * job->elemSize;
+        }
+        stats->sparseOperands += (sparse[0] ? 1 : 0) + (sparse[1] ? 1 : 0);
+        stats->deltaOperands += (delta[0] ? 1 : 0) + (delta[1] ? 1 : 0);
+        stats->generatedOperands += (job->gen != NULL) ? 2 : 0;
 
-#if defined (VERIF_MULT)
-                for (j = 0; j < matrixSize; j++)
-                    for (k = 0; k < matrixSize; k++)
-                        mat1[j][k] = j+k*2;
+        while (DSP_SUCCEEDED(status) && (allocated < numBlocks[0] + numBlocks[1]))
+        {
+            status = helloDSP_AllocMsg(CTRLMSG_SIZE(payload[allocated]), &blocks[allocated]);
+            if (DSP_SUCCEEDED(status))
+            {
+                allocated++;
+            }
+        }
 
-                for (j = 0; j < matrixSize; j++)
-                    for (k = 0; k < matrixSize; k++)
-                        mat2[j][k] = j+k*3;
+        /* Fill the blocks: first operand, then second operand */
+        for (i = 0; DSP_SUCCEEDED(status) && (i < allocated); i++)
+        {
+            op = (i < numBlocks[0]) ? 0 : 1;
+            rowStart = (i - op * numBlocks[0]) * blockRows[op];
+            numRows = (height[op] - rowStart < blockRows[op]) ? (height[op] - rowStart) : blockRows[op];
 
-                for (j = 0; j < matrixSize; j++)
-                    for (k = 0; k < matrixSize; k++)
+            blocks[i]->command = (op == 0) ? CMD_MATRIX_A : CMD_MATRIX_B;
+            blocks[i]->matrixSize = job->matrixSize;
+            blocks[i]->jobId = jobId;
+            blocks[i]->rowStart = rowStart;
+            blocks[i]->numRows = numRows;
+            blocks[i]->kernel = job->kernel;
+            blocks[i]->kernelParam = job->kernelParam;
+            blocks[i]->accum = job->accum;
+            blocks[i]->elemSize = job->elemSize;
+            blocks[i]->format = (job->gen != NULL) ? FORMAT_GENERATED
+                                : sparse[op] ? FORMAT_CSR : delta[op] ? FORMAT_DELTA : FORMAT_DENSE;
+            blocks[i]->nnz = sparse[op] ? blockNnz[i] : delta[op] ? blockBits[i] : 0;
+            blocks[i]->dimM = job->dimM;
+            blocks[i]->dimN = job->dimN;
+            blocks[i]->dimK = job->dimK;
+            blocks[i]->trans = job->trans;
+            blocks[i]->alpha = job->alpha;
+            if (job->gen != NULL)
+            {
+                memcpy(blocks[i]->arg2, &job->gen[op], sizeof(GenSpec));
+            }
+            else if (sparse[op])
+            {
+                rowPtr = blocks[i]->arg2;
+                cols = rowPtr + numRows + 1;
+                values = cols + blockNnz[i];
+                bytes = (Uint8*) values;
+                p = 0;
+                rowPtr[0] = 0;
+                for (j = 0; j < numRows; j++)
+                {
+                    row = src[op] + (rowStart + j) * ld[op];
+                    for (k = 0; k < width[op]; k++)
                     {
-                        prod[j][k] = 0;
-                        for(l = 0; l < matrixSize; l++)
-                            prod[j][k] = prod[j][k] + ((Uint32)mat1[j][l]) * ((Uint32)mat2[l][k]);
-                    }
-
-                isMultCorrect = 1;
-                for (j = 0; j < matrixSize; j++) {
-                    if (!isMultCorrect)
-                        break;
-                    for (k = 0; k < matrixSize; k++)
-                        if (prod[j][k] != resFromDSP[j][k]) {
-                            isMultCorrect = 0;
-                            break;
+                        if (row[k] != 0)
+                        {
+                            cols[p] = k;
+                            if (job->elemSize == sizeof(Uint16))
+                                values[p] = row[k];
+                            else
+                                bytes[p] = (Uint8) row[k];
+                            p++;
                         }
+                    }
+                    rowPtr[j + 1] = p;
                 }
-
-                SYSTEM_0Print("\n\nMultiplication result has been verified and it is ");
-                if (isMultCorrect)
-                    SYSTEM_0Print("CORRECT");
-                else
-                    SYSTEM_0Print("NOT CORRECT");
-#endif
-
-                SYSTEM_0Print("\n\n");
-                SYSTEM_1Print("Cycles spent on multiplication: %d\n", msgS->arg1);
-
-                /* Start the timer again */
-#if defined (PROFILE)
-                SYSTEM_GetStartTime();
-#endif
-                MSGQ_free((MsgqMsg) msgS);
             }
-
-            /* Send two input matrices */
-            else
+            else if (delta[op])
             {
-                /* Send the same message received in earlier MSGQ_get () call. */
-                if (DSP_SUCCEEDED(status))
+                /* Row heads, then the deltas packed from bit 0 up */
+                words = (Uint32*) (blocks[i]->arg2 + CTRLMSG_DELTA_HEADS(numRows));
+                memset(blocks[i]->arg2, 0, payload[i]);
+                bitPos = 0;
+                for (j = 0; j < numRows; j++)
                 {
-                    msgId = MSGQ_getMsgId(msgS);
-                    MSGQ_setMsgId(msgS, msgId);
-                    status = MSGQ_put(SampleDspMsgq, (MsgqMsg) msgS);
-                    if (DSP_FAILED(status))
+                    row = src[op] + (rowStart + j) * ld[op];
+                    blocks[i]->arg2[j] = row[0] & elemMask;
+                    for (k = 1; (k < width[op]) && (blockBits[i] != 0); k++)
                     {
-                        MSGQ_free((MsgqMsg) msgS);
-                        SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+                        code = DELTA_ZIGZAG((Uint16) ((row[k] & elemMask) - (row[k - 1] & elemMask)));
+                        shift = bitPos & 31;
+                        words[bitPos >> 5] |= (Uint32) code << shift;
+                        if (shift + blockBits[i] > 32)
+                            words[(bitPos >> 5) + 1] |= (Uint32) code >> (32 - shift);
+                        bitPos += blockBits[i];
                     }
                 }
-
-                sequenceNumber++;
-                /* Make sure that the sequenceNumber stays within the permitted
-                 * range for applications. */
-                if (sequenceNumber == MSGQ_INTERNALIDSSTART)
+            }
+            else if (job->elemSize == sizeof(Uint16))
+            {
+                for (j = 0; j < numRows; j++)
+                {
+                    row = src[op] + (rowStart + j) * ld[op];
+                    for (k = 0; k < width[op]; k++)
+                        blocks[i]->arg2[j * width[op] + k] = row[k];
+                }
+            }
+            else
+            {
+                bytes = (Uint8*) blocks[i]->arg2;
+                for (j = 0; j < numRows; j++)
                 {
-                    sequenceNumber = 0;
+                    row = src[op] + (rowStart + j) * ld[op];
+                    for (k = 0; k < width[op]; k++)
+                        bytes[j * width[op] + k] = (Uint8) row[k];
                 }
             }
+
+            MSGQ_setMsgId((MsgqMsg) blocks[i], jobId);
+            MSGQ_setSrcQueue((MsgqMsg) blocks[i], SampleGppMsgq);
         }
 
-#if defined (PROFILE)
-        if (DSP_SUCCEEDED(status))
+        PHASE_ENTER(PHASE_LINK);
+        while (DSP_SUCCEEDED(status) && (sent < allocated))
+        {
+            start = SYSTEM_GetUsecTime();
+            status = helloDSP_PutMsg((MsgqMsg) blocks[sent]);
+            if (DSP_SUCCEEDED(status))
+            {
+                stats->gppSendTime += SYSTEM_GetUsecTime() - start;
+                stats->gppCacheBytes += CTRLMSG_SIZE(payload[sent]);
+                METRIC_SENT(CTRLMSG_SIZE(payload[sent]));
+                sent++;
+            }
+            else
+            {
+                SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+            }
+        }
+
+        /* Free what was not handed over to the DSP */
+        for (i = sent; i < allocated; i++)
         {
-            SYSTEM_GetEndTime();
-            elapsedTime += SYSTEM_GetProfileInfo();
-            SYSTEM_1Print("Time taken to exchange messages and compute the result: %d uSec\n", elapsedTime);
+            helloDSP_FreeMsg((MsgqMsg) blocks[i]);
         }
-#endif
 
-        SYSTEM_0Print("Leaving helloDSP_Execute ()\n");
+        if (DSP_SUCCEEDED(status))
+        {
+            helloDSP_RecordLatency(LATENCY_SUBMIT, SYSTEM_GetUsecTime() - submitStart);
+            helloDSP_JobSubmitted(submitStart);
+        }
+        else
+        {
+            METRIC_ADD(METRIC_JOBS_FAILED, 1);
+        }
 
+        PHASE_ENTER(phase);
         return status;
     }
 
 
     /** ============================================================================
-     *  @func   helloDSP_Delete
+     *  @func   helloDSP_NextView
      *
-     *  @desc   This function releases resources allocated earlier by call to
-     *          helloDSP_Create ().
-     *          During cleanup, the allocated resources are being freed
-     *          unconditionally. Actual applications may require stricter check
-     *          against return values for robustness.
+     *  @desc   Receives the next row block of the numRows x numCols product
+     *          of a job from the DSP, and returns it as a view into its
+     *          message: nothing is copied. Jobs complete in the order they
+     *          were submitted, so the next message must be the block of
+     *          this job starting at row. Its elements are 32-bit, or 64-bit
+     *          when a checked job may have overflowed. The DSP statistics
+     *          of the job are added to stats with its last block. The
+     *          caller returns the message with helloDSP_ReleaseView ().
+     *          view->last tells whether the message ended its job, also on
+     *          failure, when the job is counted as failed.
      *
-     *  @modif  None
+     *  @modif  stats
      *  ============================================================================
      */
-    NORMAL_API Void helloDSP_Delete(Uint8 processorId)
+    STATIC NORMAL_API DSP_STATUS helloDSP_NextView(IN Uint16 jobId, IN Uint32 numRows, IN Uint32 numCols,
+                                                   IN Uint32 row, OUT ResultView* view,
+                                                   IN OUT JobStats* stats)
     {
         DSP_STATUS status = DSP_SOK;
-        DSP_STATUS tmpStatus = DSP_SOK;
+        ControlMsgL* msgL;
+        Uint32 start;
 
-        SYSTEM_0Print("Entered helloDSP_Delete ()\n");
+        view->msg = NULL;
+        view->last = FALSE;
 
-        /* Release the remote message queue */
-        status = MSGQ_release(SampleDspMsgq);
+        start = SYSTEM_GetUsecTime();
+        PHASE_ENTER(PHASE_WAIT);
+        status = helloDSP_GetMsg((MsgqMsg *) &msgL);
+        PHASE_ENTER(PHASE_UNPACK);
         if (DSP_FAILED(status))
         {
-            SYSTEM_1Print("MSGQ_release () failed. Status = [0x%x]\n", status);
+            SYSTEM_1Print("MSGQ_get () failed. Status = [0x%x]\n", status);
+            helloDSP_JobDone(TRUE);
+            return status;
         }
+        helloDSP_RecordLatency(LATENCY_WAIT, SYSTEM_GetUsecTime() - start);
+        METRIC_RECEIVED(msgL);
 
-        /* Close the remote transport */
-        tmpStatus = MSGQ_transportClose(processorId);
-        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+#if defined (VERIFY_DATA)
+        /* Verify correctness of data received. */
+        status = helloDSP_VerifyData((MsgqMsg) msgL, jobId);
+#endif
+
+        if (DSP_SUCCEEDED(status) && (msgL->command == CMD_ERROR))
         {
-            status = tmpStatus;
-            SYSTEM_1Print("MSGQ_transportClose () failed. Status = [0x%x]\n", status);
+            status = DSP_EFAIL;
+            SYSTEM_1Print("DSP rejected job %d\n", msgL->jobId);
+        }
+        else if (DSP_SUCCEEDED(status)
+                 && ((msgL->command != CMD_RESULT) || (msgL->jobId != jobId)
+                     || ((msgL->elemSize != sizeof(Uint32)) && (msgL->elemSize != 2 * sizeof(Uint32)))
+                     || (msgL->dimN != numCols)
+                     || (msgL->rowStart != row) || (msgL->numRows > numRows - row)))
+        {
+            status = DSP_EFAIL;
+            SYSTEM_2Print("Unexpected block for job %d at row %d\n", msgL->jobId, msgL->rowStart);
         }
 
-        /* Stop execution on DSP. */
-        tmpStatus = PROC_stop(processorId);
-        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        if (DSP_FAILED(status))
         {
-            status = tmpStatus;
-            SYSTEM_1Print("PROC_stop () failed. Status = [0x%x]\n", status);
+            view->last = REPLY_ENDS_JOB(msgL);
+            helloDSP_FreeMsg((MsgqMsg) msgL);
+            helloDSP_JobDone(TRUE);
         }
+        else
+        {
+            view->last = (row + msgL->numRows == numRows);
+            view->data = (const Uint32*) msgL->arg2;
+            view->rowStart = row;
+            view->numRows = msgL->numRows;
+            view->stride = numCols;
+            view->elemSize = msgL->elemSize;
+            view->msg = msgL;
 
-        /* Reset the error handler before deleting the MSGQ that receives */
-        /* the error messages.                                            */
-        tmpStatus = MSGQ_setErrorHandler(MSGQ_INVALIDMSGQ, MSGQ_INVALIDMSGQ);
+            /* MSGQ_get () invalidated the block */
+            stats->gppCacheBytes += CTRLMSG_SIZE(msgL->numRows * numCols * msgL->elemSize);
 
-        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
-        {
-            status = tmpStatus;
-            SYSTEM_1Print("MSGQ_setErrorHandler () failed. Status = [0x%x]\n", status);
+            /* The DSP statistics are cumulative over the job */
+            if (row + msgL->numRows == numRows)
+            {
+                stats->cycles += msgL->arg1;
+                stats->dspCacheCycles += msgL->cacheCycles;
+                stats->dspCacheBytes += msgL->cacheBytes;
+                stats->dspConfig = msgL->dspConfig;
+                if (msgL->elemSize != sizeof(Uint32))
+                    stats->wideJobs++;
+                if (msgL->format == FORMAT_CSR)
+                    stats->sparseJobs++;
+                helloDSP_JobDone(FALSE);
+            }
         }
 
-        /* Close the GPP's message queue */
-        tmpStatus = MSGQ_close(SampleGppMsgq);
-        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ReleaseView
+     *
+     *  @desc   Returns the message of a view obtained from
+     *          helloDSP_NextView () to the pool. The view must not be read
+     *          afterwards.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_ReleaseView(IN ResultView* view)
+    {
+        if (view->msg != NULL)
         {
-            status = tmpStatus;
-            SYSTEM_1Print("MSGQ_close () failed. Status = [0x%x]\n", status);
+            helloDSP_FreeMsg((MsgqMsg) view->msg);
+            view->msg = NULL;
+            view->data = NULL;
         }
+    }
 
-        /* Close the pool */
-        tmpStatus = POOL_close(POOL_makePoolId(processorId, SAMPLE_POOL_ID));
-        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+
+    /** ============================================================================
+     *  @func   helloDSP_DrainJobs
+     *
+     *  @desc   Receives and frees the replies of jobs left in flight by a
+     *          failed run, so that the next run, which numbers its jobs
+     *          from 0 again, does not take them for its own. open tells
+     *          that the end of the oldest job, already counted as failed,
+     *          is still due; jobs more are counted as failed as they end.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_DrainJobs(IN Bool open, IN Uint32 jobs)
+    {
+        ControlMsgL* msgL;
+
+        while (open || (jobs > 0))
         {
-            status = tmpStatus;
-            SYSTEM_1Print("POOL_close () failed. Status = [0x%x]\n", status);
+            if (DSP_FAILED(helloDSP_GetMsg((MsgqMsg *) &msgL)))
+            {
+                break;
+            }
+            METRIC_RECEIVED(msgL);
+            if (REPLY_ENDS_JOB(msgL))
+            {
+                if (open)
+                {
+                    open = FALSE;
+                }
+                else
+                {
+                    jobs--;
+                    helloDSP_JobDone(TRUE);
+                }
+            }
+            helloDSP_FreeMsg((MsgqMsg) msgL);
         }
+    }
 
-        /* Detach from the processor */
-        tmpStatus = PROC_detach(processorId);
-        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+
+    /** ============================================================================
+     *  @func   helloDSP_CommitOperand
+     *
+     *  @desc   Fills in the headers of the blocks of a reserved operand,
+     *          as those of a square job computed modulo 2^32, and sends
+     *          them. The payloads are left as the producer wrote them.
+     *          Blocks sent are removed from the operand; the others are
+     *          left for helloDSP_ReleaseOperand ().
+     *
+     *  @modif  operand, stats
+     *  ============================================================================
+     */
+    STATIC NORMAL_API DSP_STATUS helloDSP_CommitOperand(IN Uint16 jobId, IN Uint16 command,
+                                                        IN Uint16 kernel, IN Uint16 kernelParam,
+                                                        IN HELLODSP_Operand* operand,
+                                                        IN OUT JobStats* stats)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ControlMsgS* msgS;
+        Uint32 n = operand->rows;
+        Uint32 rowStart;
+        Uint32 numRows;
+        Uint32 sent = 0;
+        Uint32 start;
+        Uint32 phase = gppPhase;
+        Uint32 i;
+
+        PHASE_ENTER(PHASE_LINK);
+        while (DSP_SUCCEEDED(status) && (sent < operand->numBlocks))
         {
-            status = tmpStatus;
-            SYSTEM_1Print("PROC_detach () failed. Status = [0x%x]\n", status);
+            msgS = (ControlMsgS*) operand->msgs[sent];
+            rowStart = sent * operand->blockRows;
+            numRows = (n - rowStart < operand->blockRows) ? (n - rowStart) : operand->blockRows;
+
+            msgS->command = command;
+            msgS->matrixSize = n;
+            msgS->jobId = jobId;
+            msgS->rowStart = rowStart;
+            msgS->numRows = numRows;
+            msgS->kernel = kernel;
+            msgS->kernelParam = kernelParam;
+            msgS->accum = ACCUM_WRAP;
+            msgS->elemSize = sizeof(Uint16);
+            msgS->format = FORMAT_DENSE;
+            msgS->nnz = 0;
+            msgS->dimM = n;
+            msgS->dimN = n;
+            msgS->dimK = n;
+            msgS->trans = 0;
+            msgS->alpha = 1;
+            MSGQ_setMsgId((MsgqMsg) msgS, jobId);
+            MSGQ_setSrcQueue((MsgqMsg) msgS, SampleGppMsgq);
+
+            start = SYSTEM_GetUsecTime();
+            status = helloDSP_PutMsg((MsgqMsg) msgS);
+            if (DSP_SUCCEEDED(status))
+            {
+                stats->gppSendTime += SYSTEM_GetUsecTime() - start;
+                stats->gppCacheBytes += CTRLMSG_SIZE(numRows * n * sizeof(Uint16));
+                METRIC_SENT(CTRLMSG_SIZE(numRows * n * sizeof(Uint16)));
+                sent++;
+            }
+            else
+            {
+                SYSTEM_1Print("MSGQ_put () failed. Status = [0x%x]\n", status);
+            }
         }
 
-        /* Destroy the PROC object. */
-        tmpStatus = PROC_destroy();
-        if (DSP_SUCCEEDED(status) && DSP_FAILED(tmpStatus))
+        /* The DSP owns the blocks sent */
+        for (i = sent; i < operand->numBlocks; i++)
         {
-            status = tmpStatus;
-            SYSTEM_1Print("PROC_destroy () failed. Status = [0x%x]\n", status);
+            operand->msgs[i - sent] = operand->msgs[i];
+            operand->data[i - sent] = operand->data[i];
         }
+        operand->numBlocks -= sent;
 
-        SYSTEM_0Print("Leaving helloDSP_Delete ()\n");
+        PHASE_ENTER(phase);
+        return status;
+    }
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GatherView
+     *
+     *  @desc   Copies the rows of a view to their place in a contiguous
+     *          product with a row stride of ld, for callers that need the
+     *          product after the view is released.
+     *
+     *  @modif  result
+     *  ============================================================================
+     */
+    STATIC NORMAL_API Void helloDSP_GatherView(IN const ResultView* view, OUT AccumWide* result,
+                                               IN Uint32 ld)
+    {
+        AccumWide* out;
+        Uint32 j, k;
+
+        for (j = 0; j < view->numRows; j++)
+        {
+            out = result + (view->rowStart + j) * ld;
+            if (view->elemSize == sizeof(Uint32))
+            {
+                for (k = 0; k < view->stride; k++)
+                    out[k] = view->data[j * view->stride + k];
+            }
+            else
+            {
+                for (k = 0; k < view->stride; k++)
+                    out[k] = RESULT_VIEW_ELEM(view, j, k);
+            }
+        }
     }
 
 
@@ -587,22 +5369,64 @@ typedef struct ControlMsgL
      *  @modif  None
      *  ============================================================================
      */
-    NORMAL_API Void helloDSP_Main(IN Char8* dspExecutable, IN Char8* strMatrixSize, IN Char8* strProcessorId)
+    NORMAL_API Void helloDSP_Main(IN Char8* dspExecutable, IN Char8* strMatrixSize, IN Char8* strProcessorId,
+                                  IN Char8* strPipelineDepth, IN Char8* strBatchSize,
+                                  IN Char8* strCutoff, IN Uint32 flags,
+                                  IN Char8* inputA, IN Char8* inputB, IN Char8* output,
+                                  IN HELLODSP_Mode mode)
     {
         DSP_STATUS status = DSP_SOK;
-        Uint32 matrixSize = 0;
+        Uint32 matrixSize = ARG2_SIZE;
+        Uint32 pipelineDepth = DEFAULT_PIPELINE_DEPTH;
+        Uint32 batchSize = DEFAULT_BATCH_SIZE;
+        Uint16 kernel = KERNEL_BASE;
+        Uint32 cutoff = 0;
         Uint8 processorId = 0;
+        Bool profiling = FALSE;
 
         SYSTEM_0Print ("========== Sample Application : helloDSP ==========\n");
 
-        if ((dspExecutable != NULL) && (strMatrixSize != NULL))
+        if (((dspExecutable != NULL) || (mode == HELLODSP_ATTACH))
+            && ((strMatrixSize != NULL) || (mode == HELLODSP_DAEMON)))
         {
-            matrixSize = SYSTEM_Atoi(strMatrixSize);
+            /* The daemon sizes the pool for the largest jobs its clients
+             * may run, pipelineDepth of them at a time. */
+            if (mode != HELLODSP_DAEMON)
+            {
+                matrixSize = SYSTEM_Atoi(strMatrixSize);
+            }
+            if (strPipelineDepth != NULL)
+            {
+                pipelineDepth = SYSTEM_Atoi(strPipelineDepth);
+            }
+            if ((strBatchSize != NULL) && (mode != HELLODSP_DAEMON))
+            {
+                batchSize = SYSTEM_Atoi(strBatchSize);
+            }
+            if (mode == HELLODSP_DAEMON)
+            {
+                batchSize = pipelineDepth;
+            }
+            if (strCutoff != NULL)
+            {
+                kernel = KERNEL_STRASSEN;
+                cutoff = SYSTEM_Atoi(strCutoff);
+            }
 
-            if (matrixSize > 0xFFFF)
+            if ((matrixSize == 0) || (matrixSize > ARG2_SIZE))
+            {
+                status = DSP_EINVALIDARG;
+                SYSTEM_1Print("ERROR! Invalid arguments specified for helloDSP application.\n Max matrix size = %d\n", ARG2_SIZE);
+            }
+            else if ((pipelineDepth == 0) || (batchSize == 0))
             {
                 status = DSP_EINVALIDARG;
-                SYSTEM_1Print("ERROR! Invalid arguments specified for helloDSP application.\n Max iterations = %d\n", 0xFFFF);
+                SYSTEM_0Print("ERROR! Pipeline depth and batch size must be greater than 0\n");
+            }
+            else if ((kernel == KERNEL_STRASSEN) && ((cutoff < STRASSEN_MIN_CUTOFF) || (cutoff > ARG2_SIZE)))
+            {
+                status = DSP_EINVALIDARG;
+                SYSTEM_2Print("ERROR! Strassen cutoff must be between %d and %d\n", STRASSEN_MIN_CUTOFF, ARG2_SIZE);
             }
             else
             {
@@ -613,19 +5437,69 @@ typedef struct ControlMsgL
                     SYSTEM_1Print("== Error: Invalid processor id %d specified ==\n", processorId);
                     status = DSP_EFAIL;
                 }
+                /* The profiler runs from before the DSP is loaded until
+                 * it is released. */
+                if (DSP_SUCCEEDED(status) && (flags & HELLODSP_PROFILE))
+                {
+                    profiling = DSP_SUCCEEDED(SYSTEM_StartSampler(PHASE_PERIOD_USEC, &gppPhase,
+                                                                  phaseSamples, NUM_PHASES));
+                }
+
                 /* Specify the dsp executable file name for message creation phase. */
                 if (DSP_SUCCEEDED(status))
                 {
-                    status = helloDSP_Create(dspExecutable, strMatrixSize, processorId);
+                    PHASE_ENTER(PHASE_SETUP);
+                    status = helloDSP_Create(dspExecutable, mode, matrixSize,
+                                             pipelineDepth, batchSize, processorId);
+                    PHASE_ENTER(PHASE_OTHER);
 
-                    /* Execute the message execute phase. */
-                    if (DSP_SUCCEEDED(status))
+                    /* A daemon only keeps the DSP loaded for attached
+                     * processes; other modes run the job themselves. */
+                    if (DSP_SUCCEEDED(status) && (mode == HELLODSP_DAEMON))
+                    {
+                        SYSTEM_0Print("helloDSP daemon running, send SIGINT or SIGTERM to stop\n");
+                        helloDSP_Monitor();
+                    }
+                    else if (DSP_SUCCEEDED(status) && (flags & HELLODSP_LINKBENCH))
+                    {
+                        status = helloDSP_LinkBench(processorId);
+                    }
+                    else if (DSP_SUCCEEDED(status) && (flags & HELLODSP_BENCH))
+                    {
+                        status = helloDSP_Bench(processorId);
+                    }
+                    else if (DSP_SUCCEEDED(status) && (flags & HELLODSP_TUNE))
+                    {
+                        status = helloDSP_Tune(matrixSize, batchSize, flags, processorId);
+                    }
+                    else if (DSP_SUCCEEDED(status) && (flags & HELLODSP_GEMV))
+                    {
+                        status = helloDSP_GemvCheck(matrixSize, batchSize, flags, processorId);
+                    }
+                    else if (DSP_SUCCEEDED(status) && (flags & HELLODSP_GEMM))
+                    {
+                        status = helloDSP_GemmCheck(matrixSize, flags, processorId);
+                    }
+                    else if (DSP_SUCCEEDED(status) && (flags & HELLODSP_SWEEP))
+                    {
+                        status = helloDSP_Crossover(matrixSize, batchSize, flags, processorId);
+                    }
+                    else if (DSP_SUCCEEDED(status))
                     {
-                        status = helloDSP_Execute(matrixSize, processorId);
+                        status = helloDSP_Execute(matrixSize, batchSize, kernel, (Uint16) cutoff,
+                                                  flags, inputA, inputB, output, processorId);
                     }
 
                     /* Perform cleanup operation. */
+                    PHASE_ENTER(PHASE_SETUP);
                     helloDSP_Delete(processorId);
+                    PHASE_ENTER(PHASE_OTHER);
+                }
+
+                if (profiling)
+                {
+                    SYSTEM_StopSampler();
+                    helloDSP_PrintProfile();
                 }
             }
         }
@@ -652,7 +5526,7 @@ typedef struct ControlMsgL
         Uint16 msgId;
 
         /* Verify the message */
-        msgId = MSGQ_getMsgId(msgS.header);
+        msgId = MSGQ_getMsgId(msgS);
         if (msgId != sequenceNumber)
         {
             status = DSP_EFAIL;
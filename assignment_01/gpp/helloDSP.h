@@ -28,6 +28,159 @@ extern "C"
 #endif /* defined (__cplusplus) */
 
 
+    /** ============================================================================
+     *  @name   HELLODSP_Mode
+     *
+     *  @desc   How a process uses the DSP.
+     *
+     *  @field  HELLODSP_STANDALONE
+     *              Load and start the DSP, run one job, stop the DSP.
+     *  @field  HELLODSP_DAEMON
+     *              Load and start the DSP once and keep it running until the
+     *              process is terminated, without running jobs itself.
+     *  @field  HELLODSP_ATTACH
+     *              Join the DSP session of a running daemon and run one job.
+     *              The DSP executable is neither loaded nor stopped.
+     *  ============================================================================
+     */
+    typedef enum {
+        HELLODSP_STANDALONE = 0,
+        HELLODSP_DAEMON     = 1,
+        HELLODSP_ATTACH     = 2
+    } HELLODSP_Mode;
+
+
+    /*  ============================================================================
+     *  @const  HELLODSP_SWEEP, HELLODSP_WRAP, HELLODSP_FULLRANGE, HELLODSP_PACKED,
+     *          HELLODSP_SPARSE, HELLODSP_GEMM, HELLODSP_GEMV, HELLODSP_TUNE,
+     *          HELLODSP_CSV, HELLODSP_QUIET, HELLODSP_COMPRESS, HELLODSP_DSPGEN,
+     *          HELLODSP_PROFILE, HELLODSP_BENCH, HELLODSP_LINKBENCH
+     *
+     *  @desc   Options of a run, combined in the flags of helloDSP_Main ().
+     *          HELLODSP_SWEEP runs helloDSP_Crossover () instead of a single
+     *          kernel. HELLODSP_WRAP keeps 32-bit products modulo 2^32
+     *          instead of having the DSP check them for overflow.
+     *          HELLODSP_FULLRANGE spreads the operands over all 16 bits.
+     *          HELLODSP_PACKED sends the operands as 8-bit elements.
+     *          HELLODSP_SPARSE zeroes about nine operand elements in ten.
+     *          HELLODSP_GEMM runs helloDSP_GemmCheck () instead,
+     *          HELLODSP_GEMV helloDSP_GemvCheck () and HELLODSP_TUNE
+     *          helloDSP_Tune (). HELLODSP_CSV prints the product as CSV
+     *          and HELLODSP_QUIET does not print it at all.
+     *          HELLODSP_COMPRESS lets operands that compress well be sent
+     *          delta-coded. HELLODSP_DSPGEN has the DSP generate dense
+     *          operands of the kind in the HELLODSP_GEN_MASK bits from a
+     *          descriptor instead of receiving them; the kind replaces the
+     *          operands of HELLODSP_FULLRANGE. HELLODSP_PROFILE samples the
+     *          phase of the GPP (setup, pack, link, wait, unpack, verify)
+     *          every millisecond and prints a flat profile at exit.
+     *          HELLODSP_BENCH runs helloDSP_Bench () instead of a job and
+     *          HELLODSP_LINKBENCH helloDSP_LinkBench ().
+     *  ============================================================================
+     */
+#define HELLODSP_SWEEP      0x1
+#define HELLODSP_WRAP       0x2
+#define HELLODSP_FULLRANGE  0x4
+#define HELLODSP_PACKED     0x8
+#define HELLODSP_SPARSE     0x10
+#define HELLODSP_GEMM       0x20
+#define HELLODSP_GEMV       0x40
+#define HELLODSP_TUNE       0x80
+#define HELLODSP_CSV        0x100
+#define HELLODSP_QUIET      0x200
+#define HELLODSP_COMPRESS   0x400
+#define HELLODSP_DSPGEN     0x800
+#define HELLODSP_GEN_SHIFT  12
+#define HELLODSP_GEN_MASK   0x7000
+#define HELLODSP_PROFILE    0x8000
+#define HELLODSP_BENCH      0x10000
+#define HELLODSP_LINKBENCH  0x20000
+
+
+    /*  ============================================================================
+     *  @const  HELLODSP_GEN_AFFINE, HELLODSP_GEN_CONSTANT, HELLODSP_GEN_IDENTITY,
+     *          HELLODSP_GEN_BANDED, HELLODSP_GEN_RANDOM
+     *
+     *  @desc   Kinds of operands generated with HELLODSP_DSPGEN, shifted by
+     *          HELLODSP_GEN_SHIFT in the flags. Affine operands are the
+     *          default ones, random ones those of HELLODSP_FULLRANGE. An
+     *          identity first operand makes the product the second one.
+     *          Banded operands are tridiagonal.
+     *  ============================================================================
+     */
+#define HELLODSP_GEN_AFFINE     0
+#define HELLODSP_GEN_CONSTANT   1
+#define HELLODSP_GEN_IDENTITY   2
+#define HELLODSP_GEN_BANDED     3
+#define HELLODSP_GEN_RANDOM     4
+#define HELLODSP_GEN_KINDS      5
+
+
+    /** ============================================================================
+     *  @name   HELLODSP_MatrixHeader
+     *
+     *  @desc   Header of a matrix file, followed by rows * cols elements of
+     *          elemSize bytes, row-major, in the byte order of the GPP.
+     *          Operands have 16-bit elements; products have 32-bit elements
+     *          modulo 2^32 or 64-bit ones.
+     *
+     *  @field  magic
+     *              HELLODSP_MATRIX_MAGIC. Also rejects files of the other
+     *              byte order.
+     *  @field  rows, cols
+     *              Dimensions of the matrix.
+     *  @field  elemSize
+     *              Bytes per element.
+     *  ============================================================================
+     */
+    typedef struct HELLODSP_MatrixHeader_tag {
+        Uint32 magic;
+        Uint32 rows;
+        Uint32 cols;
+        Uint32 elemSize;
+    } HELLODSP_MatrixHeader;
+
+#define HELLODSP_MATRIX_MAGIC   0x54414D48      /* "HMAT" little-endian */
+
+
+    /** ============================================================================
+     *  @name   HELLODSP_Operand
+     *
+     *  @desc   An operand reserved in the message pool by
+     *          helloDSP_ReserveOperand (): a matrix of 16-bit elements held
+     *          as row blocks in the very messages that carry it to the DSP.
+     *          Producers write each row in place through HELLODSP_OPERAND_ROW
+     *          instead of building the matrix elsewhere and having it copied.
+     *
+     *  @field  rows, cols
+     *              Dimensions of the matrix.
+     *  @field  blockRows
+     *              Rows per block; the last block may hold fewer.
+     *  @field  numBlocks
+     *              Number of blocks, 0 once committed or released.
+     *  @field  msgs
+     *              Messages holding the blocks.
+     *  @field  data
+     *              First row of each block.
+     *  ============================================================================
+     */
+#define HELLODSP_OPERAND_MAX_BLOCKS     4
+
+    typedef struct HELLODSP_Operand_tag {
+        Uint32  rows;
+        Uint32  cols;
+        Uint32  blockRows;
+        Uint32  numBlocks;
+        Pvoid   msgs[HELLODSP_OPERAND_MAX_BLOCKS];
+        Uint16* data[HELLODSP_OPERAND_MAX_BLOCKS];
+    } HELLODSP_Operand;
+
+    /* Row j of a reserved operand, cols elements to be written in place. */
+#define HELLODSP_OPERAND_ROW(operand, j)                                      \
+    ((operand)->data[(j) / (operand)->blockRows]                              \
+     + ((j) % (operand)->blockRows) * (operand)->cols)
+
+
     /** ============================================================================
      *  @func   helloDSP_Create
      *
@@ -35,14 +188,26 @@ extern "C"
      *          this application.
      *
      *  @arg    dspExecutable
-     *              DSP executable name.
-     *  @arg    strMatrixSize
-     *              Matrix size.
+     *              DSP executable name. Not used in HELLODSP_ATTACH mode.
+     *  @arg    mode
+     *              How this process uses the DSP.
+     *  @arg    matrixSize
+     *              Largest matrix size of the jobs to run.
+     *  @arg    pipelineDepth
+     *              Number of jobs to keep in flight. Lowered to the batch
+     *              size, and further until the pool fits in POOLMEM.
+     *  @arg    batchSize
+     *              Number of jobs to run.
      *  @arg    processorId
      *             Id of the DSP Processor.
      *
      *  @ret    DSP_SOK
      *              Operation successfully completed.
+     *          DSP_ENOTREADY
+     *              HELLODSP_ATTACH mode and no daemon has started the DSP.
+     *          DSP_EMEMORY
+     *              Not even a single job fits in POOLMEM, or the working
+     *              buffers of the GPP could not be allocated.
      *          DSP_EFAIL
      *              Resource allocation failed.
      *
@@ -53,7 +218,9 @@ extern "C"
      *  @see    helloDSP_Delete
      *  ============================================================================
      */
-    NORMAL_API DSP_STATUS helloDSP_Create (IN Char8* dspExecutable, IN Char8* strMatrixSize, IN Uint8 processorId);
+    NORMAL_API DSP_STATUS helloDSP_Create (IN Char8* dspExecutable, IN HELLODSP_Mode mode,
+                                           IN Uint32 matrixSize, IN Uint32 pipelineDepth,
+                                           IN Uint32 batchSize, IN Uint8 processorId);
 
 
     /** ============================================================================
@@ -63,12 +230,36 @@ extern "C"
      *
      *  @arg    matrixSize
      *              Matrix size.
+     *  @arg    batchSize
+     *              Number of jobs to run.
+     *  @arg    kernel
+     *              Multiplication kernel run on the DSP, KERNEL_BASE or
+     *              KERNEL_STRASSEN.
+     *  @arg    kernelParam
+     *              Recursion cutoff of KERNEL_STRASSEN, unused otherwise.
+     *  @arg    flags
+     *              HELLODSP_WRAP, HELLODSP_FULLRANGE, HELLODSP_PACKED,
+     *              HELLODSP_SPARSE, HELLODSP_COMPRESS, HELLODSP_DSPGEN,
+     *              HELLODSP_CSV and HELLODSP_QUIET options.
+     *              HELLODSP_FULLRANGE, HELLODSP_SPARSE and HELLODSP_DSPGEN
+     *              only apply to generated operands, HELLODSP_SPARSE ones
+     *              not being generated by the DSP, and HELLODSP_PACKED keeps
+     *              the low byte of operands read from files.
+     *  @arg    inputA, inputB
+     *              Matrix files holding the operands, see
+     *              HELLODSP_MatrixHeader, or NULL to generate them. Both
+     *              must be matrixSize x matrixSize.
+     *  @arg    output
+     *              Matrix file receiving the product of the last job, or
+     *              NULL to print it.
      *
      *  @arg    processorId
      *             Id of the DSP Processor.
      *
      *  @ret    DSP_SOK
      *              Operation successfully completed.
+     *          DSP_EINVALIDARG
+     *              An input file is not a matrix file of the right size.
      *          DSP_EFAIL
      *              helloDSP execution failed.
      *
@@ -79,7 +270,424 @@ extern "C"
      *  @see    helloDSP_Delete , helloDSP_Create
      *  ============================================================================
      */
-    NORMAL_API DSP_STATUS helloDSP_Execute(IN Uint32 matrixSize, IN Uint8 processorId);
+    NORMAL_API DSP_STATUS helloDSP_Execute(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                           IN Uint16 kernel, IN Uint16 kernelParam,
+                                           IN Uint32 flags, IN Char8* inputA, IN Char8* inputB,
+                                           IN Char8* output, IN Uint8 processorId);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Crossover
+     *
+     *  @desc   Runs a batch with the base kernel and with Strassen-Winograd
+     *          at successively halved cutoffs, and prints the time per job
+     *          of each along with the fastest.
+     *
+     *  @arg    matrixSize
+     *              Matrix size.
+     *  @arg    batchSize
+     *              Number of jobs to run per kernel.
+     *  @arg    flags
+     *              HELLODSP_WRAP, HELLODSP_FULLRANGE, HELLODSP_PACKED,
+     *              HELLODSP_SPARSE, HELLODSP_COMPRESS and HELLODSP_DSPGEN
+     *              options.
+     *
+     *  @arg    processorId
+     *             Id of the DSP Processor.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Execute
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Crossover(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                             IN Uint32 flags, IN Uint8 processorId);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Tune
+     *
+     *  @desc   Times the variants of the base kernel for each size class up
+     *          to matrixSize, prints the fastest, saves them as the tuning
+     *          table and sends it to the DSP. Later sessions send the saved
+     *          table from helloDSP_Create (), and base kernel jobs then run
+     *          the variant tuned for their size.
+     *
+     *  @arg    matrixSize
+     *              Largest size to tune for.
+     *  @arg    batchSize
+     *              Number of jobs to run per variant and size.
+     *  @arg    flags
+     *              HELLODSP_FULLRANGE option.
+     *  @arg    processorId
+     *             Id of the DSP Processor.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Crossover
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Tune(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                        IN Uint32 flags, IN Uint8 processorId);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Bench
+     *
+     *  @desc   Has the DSP time each of its kernels on square operands of
+     *          16 to 128 elements, cold from DDR2 and warm in its caches,
+     *          and prints the cycles per multiply-accumulate of each run.
+     *          The DSP runs no job meanwhile.
+     *
+     *  @arg    processorId
+     *             Id of the DSP Processor.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Tune
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Bench(IN Uint8 processorId);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_LinkBench
+     *
+     *  @desc   Measures the round-trip latency and the streaming bandwidth
+     *          of the links to the DSP: MSGQ messages from the smallest to
+     *          the largest buffer of the pool, with and without the DSP
+     *          touching their payload, and NOTIFY events. Prints a line per
+     *          link and size.
+     *
+     *  @arg    processorId
+     *             Id of the DSP Processor.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Bench
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_LinkBench(IN Uint8 processorId);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Gemm
+     *
+     *  @desc   Computes C = alpha * op(A) * op(B) + beta * C on the DSP with
+     *          integer arithmetic modulo 2^32, where op(A) is M x K and
+     *          op(B) is K x N. Matrices are row-major with a row stride of
+     *          lda, ldb and ldc elements, so submatrices are passed by
+     *          pointing at their first element. Neither operand is copied
+     *          or transposed on the GPP beforehand.
+     *
+     *  @arg    transA
+     *              TRUE when a holds A^T, a K x M matrix.
+     *  @arg    transB
+     *              TRUE when b holds B^T, an N x K matrix.
+     *  @arg    m, n, k
+     *              Dimensions, each at most the matrix size given to
+     *              helloDSP_Create ().
+     *  @arg    alpha
+     *              Scale of the product.
+     *  @arg    a, lda
+     *              First operand and its row stride.
+     *  @arg    b, ldb
+     *              Second operand and its row stride.
+     *  @arg    beta
+     *              Scale of C. C is not read when beta is 0.
+     *  @arg    c, ldc
+     *              M x N result and its row stride.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EINVALIDARG
+     *              A dimension is out of range or larger than its stride.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  helloDSP_Create () succeeded.
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_GemmCheck
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Gemm(IN Bool transA, IN Bool transB,
+                                        IN Uint32 m, IN Uint32 n, IN Uint32 k,
+                                        IN Uint32 alpha, IN const Uint16* a, IN Uint32 lda,
+                                        IN const Uint16* b, IN Uint32 ldb,
+                                        IN Uint32 beta, IN OUT Uint32* c, IN Uint32 ldc);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemmCheck
+     *
+     *  @desc   Runs helloDSP_Gemm () on submatrices of the generated
+     *          operands with every combination of transposes, and prints the
+     *          DSP cycles and time of each along with whether C verified.
+     *
+     *  @arg    matrixSize
+     *              Matrix size the operands are generated with.
+     *  @arg    flags
+     *              HELLODSP_FULLRANGE and HELLODSP_SPARSE options.
+     *  @arg    processorId
+     *             Id of the DSP Processor.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Gemm
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_GemmCheck(IN Uint32 matrixSize, IN Uint32 flags,
+                                             IN Uint8 processorId);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemvLoad
+     *
+     *  @desc   Loads the matrix A that helloDSP_Gemv () multiplies vectors
+     *          by. A is sent once and stays on the DSP, for this process,
+     *          until another matrix is loaded.
+     *
+     *  @arg    m, k
+     *              Dimensions of A, each at most the matrix size given to
+     *              helloDSP_Create ().
+     *  @arg    a, lda
+     *              A, row-major, and its row stride.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EINVALIDARG
+     *              A dimension is out of range or larger than the stride.
+     *          DSP_EFAIL
+     *              The DSP did not store A.
+     *
+     *  @enter  helloDSP_Create () succeeded and no other request of this
+     *          process is in flight.
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Gemv
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_GemvLoad(IN Uint32 m, IN Uint32 k,
+                                            IN const Uint16* a, IN Uint32 lda);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_Gemv
+     *
+     *  @desc   Computes y = A * x modulo 2^32 for a stream of vectors x with
+     *          the matrix loaded by helloDSP_GemvLoad (). Up to
+     *          GEMV_MAX_VECTORS vectors travel per message, so a single
+     *          vector costs a message of its own size rather than that of
+     *          a matrix.
+     *
+     *  @arg    numVectors
+     *              Number of vectors.
+     *  @arg    x, ldx
+     *              Vectors of k elements, one per row, and the row stride.
+     *  @arg    y, ldy
+     *              Products of m elements, one per row, and the row stride.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EINVALIDARG
+     *              A stride is smaller than a vector.
+     *          DSP_EFAIL
+     *              No matrix is loaded or helloDSP execution failed.
+     *
+     *  @enter  helloDSP_GemvLoad () succeeded.
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_GemvLoad
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_Gemv(IN Uint32 numVectors, IN const Uint16* x, IN Uint32 ldx,
+                                        OUT Uint32* y, IN Uint32 ldy);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_GemvCheck
+     *
+     *  @desc   Multiplies a generated matrix by a stream of generated vectors
+     *          with 1, 4, 16 and 64 vectors per message, and prints the DSP
+     *          cycles, shared bytes and throughput per vector of each along
+     *          with whether the products verified.
+     *
+     *  @arg    matrixSize
+     *              Size of the matrix and of the vectors.
+     *  @arg    batchSize
+     *              Passes over the matrixSize vectors per configuration.
+     *  @arg    flags
+     *              HELLODSP_FULLRANGE and HELLODSP_SPARSE options.
+     *  @arg    processorId
+     *             Id of the DSP Processor.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Gemv
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_GemvCheck(IN Uint32 matrixSize, IN Uint32 batchSize,
+                                             IN Uint32 flags, IN Uint8 processorId);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ReserveOperand
+     *
+     *  @desc   Reserves the messages carrying a square operand of 16-bit
+     *          elements to the DSP, waiting while the pool is exhausted.
+     *          The producer fills every row through HELLODSP_OPERAND_ROW,
+     *          then hands the operand to helloDSP_MultiplyOperands (), or
+     *          gives it back with helloDSP_ReleaseOperand ().
+     *
+     *  @arg    matrixSize
+     *              Size of the operand, at most the matrix size given to
+     *              helloDSP_Create ().
+     *  @arg    operand
+     *              Operand to reserve.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EINVALIDARG
+     *              The size is out of range.
+     *          DSP_EFAIL
+     *              A message could not be allocated.
+     *
+     *  @enter  helloDSP_Create () succeeded.
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_MultiplyOperands, helloDSP_ReleaseOperand
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_ReserveOperand(IN Uint32 matrixSize, OUT HELLODSP_Operand* operand);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_ReleaseOperand
+     *
+     *  @desc   Gives the messages of an operand that was not committed back
+     *          to the pool. Does nothing for a committed operand.
+     *
+     *  @arg    operand
+     *              Reserved operand.
+     *
+     *  @ret    None
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_ReserveOperand
+     *  ============================================================================
+     */
+    NORMAL_API Void helloDSP_ReleaseOperand(IN HELLODSP_Operand* operand);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_MultiplyOperands
+     *
+     *  @desc   Commits two filled operands as a job and computes C = A * B
+     *          modulo 2^32. The messages are sent as they are: nothing is
+     *          copied on the way to the DSP, and the products are read in
+     *          place from the messages that bring them back. The operands
+     *          are consumed, whether the job succeeds or not.
+     *
+     *  @arg    a, b
+     *              Reserved operands of the same size.
+     *  @arg    kernel, kernelParam
+     *              Kernel and its parameter, as for helloDSP_Execute ().
+     *  @arg    c, ldc
+     *              Product, row-major, and its row stride.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EINVALIDARG
+     *              The operands differ in size or the stride is too small.
+     *          DSP_EFAIL
+     *              helloDSP execution failed.
+     *
+     *  @enter  helloDSP_ReserveOperand () succeeded for both operands, and
+     *          no other request of this process is in flight.
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_ReserveOperand
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS helloDSP_MultiplyOperands(IN HELLODSP_Operand* a, IN HELLODSP_Operand* b,
+                                                    IN Uint16 kernel, IN Uint16 kernelParam,
+                                                    OUT Uint32* c, IN Uint32 ldc);
+
+
+    /** ============================================================================
+     *  @func   helloDSP_DumpMetrics
+     *
+     *  @desc   Prints the metrics of this process in InfluxDB line protocol:
+     *          jobs submitted, completed, failed and in flight, messages and
+     *          bytes each way, pool allocation retries and failures, and
+     *          log2 histograms of the submit, wait and job latencies.
+     *          Counters are cumulative since helloDSP_Create () and wrap at
+     *          2^32. A process also dumps them on SIGUSR1, once its current
+     *          job completes.
+     *
+     *  @arg    None
+     *
+     *  @ret    None
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    helloDSP_Create
+     *  ============================================================================
+     */
+    NORMAL_API Void helloDSP_DumpMetrics(Void);
 
 
     /** ============================================================================
@@ -87,6 +695,8 @@ extern "C"
      *
      *  @desc   This function releases resources allocated earlier by call to
      *          helloDSP_Create ().
+     *          The DSP is shut down and stopped unless the session was
+     *          created in HELLODSP_ATTACH mode.
      *          During cleanup, the allocated resources are being freed
      *          unconditionally. Actual applications may require stricter check
      *          against return values for robustness.
@@ -116,11 +726,31 @@ extern "C"
      *          application.
      *
      *  @arg    dspExecutable
-     *              Name of the DSP executable file.
+     *              Name of the DSP executable file. Not used in
+     *              HELLODSP_ATTACH mode.
      *  @arg    strMatrixSize
-     *              Matrix size in string format.
+     *              Matrix size in string format. Not used in HELLODSP_DAEMON
+     *              mode.
      *  @arg    strProcessorId
      *             Id of the DSP Processor in string format.
+     *  @arg    strPipelineDepth
+     *              Number of jobs to keep in flight in string format, or
+     *              NULL for the default.
+     *  @arg    strBatchSize
+     *              Number of jobs to run in string format, or NULL for the
+     *              default. Not used in HELLODSP_DAEMON mode.
+     *  @arg    strCutoff
+     *              Recursion cutoff in string format to multiply with
+     *              Strassen-Winograd, or NULL for the base kernel.
+     *  @arg    flags
+     *              Options of the run, see HELLODSP_SWEEP.
+     *  @arg    inputA, inputB
+     *              Matrix files holding the operands, or NULL to generate
+     *              them.
+     *  @arg    output
+     *              Matrix file receiving the product, or NULL to print it.
+     *  @arg    mode
+     *              How this process uses the DSP.
      *
      *
      *  @ret    None
@@ -132,7 +762,11 @@ extern "C"
      *  @see    helloDSP_Create, helloDSP_Execute, helloDSP_Delete
      *  ============================================================================
      */
-    NORMAL_API Void helloDSP_Main(IN Char8* dspExecutable, IN Char8* strMatrixSize, IN Char8* strProcessorId);
+    NORMAL_API Void helloDSP_Main(IN Char8* dspExecutable, IN Char8* strMatrixSize, IN Char8* strProcessorId,
+                                  IN Char8* strPipelineDepth, IN Char8* strBatchSize,
+                                  IN Char8* strCutoff, IN Uint32 flags,
+                                  IN Char8* inputA, IN Char8* inputB, IN Char8* output,
+                                  IN HELLODSP_Mode mode);
 
 
 #if defined (DA8XXGEM)
@@ -1,6 +1,7 @@
 /*  ----------------------------------- OS Specific Headers           */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /*  ----------------------------------- DSP/BIOS Link                 */
 #include <gpptypes.h>
@@ -31,12 +32,152 @@ extern "C"
         Char8* dspExecutable = NULL;
         Char8* strMatrixSize = NULL;    // take size of matrices as argument in the command line
         Char8* strProcessorId = NULL;
+        Char8* strPipelineDepth = NULL;
+        Char8* strBatchSize = NULL;
+        Char8* strCutoff = NULL;
+        Char8* inputA = NULL;
+        Char8* inputB = NULL;
+        Char8* output = NULL;
+        Uint32 flags = 0;
+        const Char8* genKinds[HELLODSP_GEN_KINDS] = { "affine", "constant", "identity",
+                                                      "banded", "random" };
+        Uint32 kind;
         Uint8 processorId = 0;
+        HELLODSP_Mode mode = HELLODSP_STANDALONE;
+        int argi = 1;
 
-        if ((argc != 4) && (argc!=3))
+        /* Leading options: -d runs the daemon, -a attaches to it,
+         * -p <depth> sets the jobs in flight and -b <count> the jobs run,
+         * -s <cutoff> multiplies with Strassen-Winograd and -x sweeps the
+         * cutoffs, -w keeps products modulo 2^32, -f uses full-range
+         * operands, -8 sends them as 8-bit elements and -z makes them
+         * sparse, -c lets them be delta-coded and -e <kind> has the DSP
+         * generate them. -g checks GEMM with every combination of transposes,
+         * -v streams vectors through GEMV, -t tunes the base kernel and -m
+         * times the DSP kernels on their own, -l the links to the DSP.
+         * -P profiles the phases of the GPP.
+         * -i <a> <b> reads the operands from matrix files and -o <c> writes
+         * the product to one. -r csv prints the product as CSV and -r none
+         * does not print it. */
+        while ((argi < argc) && (argv[argi][0] == '-'))
         {
-            SYSTEM_1Print("Usage : %s <absolute path of DSP executable> <matrix size> <DSP Processor Id>\n"
-                          "For DSP Processor Id,"
+            if (strcmp(argv[argi], "-d") == 0)
+                mode = HELLODSP_DAEMON;
+            else if (strcmp(argv[argi], "-a") == 0)
+                mode = HELLODSP_ATTACH;
+            else if ((strcmp(argv[argi], "-p") == 0) && (argi + 1 < argc))
+                strPipelineDepth = argv[++argi];
+            else if ((strcmp(argv[argi], "-b") == 0) && (argi + 1 < argc))
+                strBatchSize = argv[++argi];
+            else if ((strcmp(argv[argi], "-s") == 0) && (argi + 1 < argc))
+                strCutoff = argv[++argi];
+            else if (strcmp(argv[argi], "-x") == 0)
+                flags |= HELLODSP_SWEEP;
+            else if (strcmp(argv[argi], "-w") == 0)
+                flags |= HELLODSP_WRAP;
+            else if (strcmp(argv[argi], "-f") == 0)
+                flags |= HELLODSP_FULLRANGE;
+            else if (strcmp(argv[argi], "-8") == 0)
+                flags |= HELLODSP_PACKED;
+            else if (strcmp(argv[argi], "-z") == 0)
+                flags |= HELLODSP_SPARSE;
+            else if (strcmp(argv[argi], "-c") == 0)
+                flags |= HELLODSP_COMPRESS;
+            else if ((strcmp(argv[argi], "-e") == 0) && (argi + 1 < argc))
+            {
+                for (kind = 0; (kind < HELLODSP_GEN_KINDS)
+                               && (strcmp(argv[argi + 1], genKinds[kind]) != 0); kind++)
+                    ;
+                if (kind == HELLODSP_GEN_KINDS)
+                    break;
+                flags |= HELLODSP_DSPGEN | (kind << HELLODSP_GEN_SHIFT);
+                argi++;
+            }
+            else if (strcmp(argv[argi], "-g") == 0)
+                flags |= HELLODSP_GEMM;
+            else if (strcmp(argv[argi], "-v") == 0)
+                flags |= HELLODSP_GEMV;
+            else if (strcmp(argv[argi], "-t") == 0)
+                flags |= HELLODSP_TUNE;
+            else if (strcmp(argv[argi], "-m") == 0)
+                flags |= HELLODSP_BENCH;
+            else if (strcmp(argv[argi], "-l") == 0)
+                flags |= HELLODSP_LINKBENCH;
+            else if (strcmp(argv[argi], "-P") == 0)
+                flags |= HELLODSP_PROFILE;
+            else if ((strcmp(argv[argi], "-i") == 0) && (argi + 2 < argc))
+            {
+                inputA = argv[++argi];
+                inputB = argv[++argi];
+            }
+            else if ((strcmp(argv[argi], "-o") == 0) && (argi + 1 < argc))
+                output = argv[++argi];
+            else if ((strcmp(argv[argi], "-r") == 0) && (argi + 1 < argc)
+                     && (strcmp(argv[argi + 1], "csv") == 0))
+            {
+                flags |= HELLODSP_CSV;
+                argi++;
+            }
+            else if ((strcmp(argv[argi], "-r") == 0) && (argi + 1 < argc)
+                     && (strcmp(argv[argi + 1], "none") == 0))
+            {
+                flags |= HELLODSP_QUIET;
+                argi++;
+            }
+            else
+                break;
+            argi++;
+        }
+
+        /* Standalone takes <executable> <size>, the daemon only the
+         * executable and an attached process only the size. */
+        if ((argc - argi != 2 + (mode == HELLODSP_STANDALONE))
+            && (argc - argi != 1 + (mode == HELLODSP_STANDALONE)))
+        {
+            SYSTEM_1Print("Usage : %s [-p depth] [-b count] [-s cutoff | -x | -g | -v | -t | -m | -l] [-w] [-f] [-8] [-z] [-c] [-e kind] [-P] [-i a b] [-o c | -r csv|none] <absolute path of DSP executable> <matrix size> <DSP Processor Id>\n", (int) argv[0]);
+            SYSTEM_1Print("        %s -d [-p depth] [-P] <absolute path of DSP executable> <DSP Processor Id>\n", (int) argv[0]);
+            SYSTEM_1Print("        %s -a [-p depth] [-b count] [-s cutoff | -x | -g | -v | -t | -m | -l] [-w] [-f] [-8] [-z] [-c] [-e kind] [-P] [-i a b] [-o c | -r csv|none] <matrix size> <DSP Processor Id>\n"
+                          "With -d the DSP is loaded once and kept running until SIGINT or SIGTERM,"
+                          "\nand its load, heap and stack use are logged every 10 seconds;"
+                          "\nwith -a the job runs on the DSP of a running -d instance without reloading it."
+                          "\nSIGUSR1 makes a process print its job, message, pool and latency metrics"
+                          "\nin InfluxDB line protocol once its current job completes."
+                          "\n-b runs count jobs, keeping up to depth of them in flight (-p, default 2);"
+                          "\nthe pool is sized for depth jobs and depth is lowered if they do not fit."
+                          "\n-s multiplies with Strassen-Winograd down to blocks of cutoff (at least 16);"
+                          "\n-x times the base kernel against every halved cutoff and reports the fastest."
+                          "\nProducts come back 64-bit when they may exceed 32 bits, unless -w keeps"
+                          "\nthem modulo 2^32; -f draws the operands from the full 16-bit range."
+                          "\n-8 sends 8-bit operands (values modulo 256), half the bytes of 16-bit ones."
+                          "\n-z zeroes about 90%% of the operands; sparse operands go in CSR form."
+                          "\n-c sends operands whose neighbouring elements differ little as packed"
+                          "\ndeltas when that at least halves them; the DSP decodes them on arrival."
+                          "\n-e has the DSP generate the operands from a descriptor instead of receiving"
+                          "\nthem, of kind affine (the default operands), constant, identity (the product"
+                          "\nis the second operand), banded (tridiagonal) or random (those of -f)."
+                          "\nOperands made sparse with -z or read with -i are sent as usual."
+                          "\n-g runs C = alpha * op(A) * op(B) + beta * C on submatrices for every"
+                          "\ncombination of transposes and verifies C."
+                          "\n-v multiplies a resident matrix by count passes of size vectors with"
+                          "\n1, 4, 16 and 64 vectors per message and reports vectors per second."
+                          "\n-t times the base kernel variants for each size class up to size and"
+                          "\nsaves the fastest to helloDSP.tune, which later runs send to the DSP."
+                          "\n-m has the DSP time its naive, transposed, tiled, simd and fixed kernels"
+                          "\non sizes 16 to 128, first with the operands in DDR2 and then cached, and"
+                          "\nprints the cycles per multiply-accumulate; the matrix size is not used."
+                          "\n-l times round trips and streams of messages echoed by the DSP, from the"
+                          "\nsmallest to the largest buffer of the pool (sized for the matrix size),"
+                          "\nwith the payload left alone and then touched on both sides, and of"
+                          "\nNOTIFY events, and prints the latency and bandwidth of each."
+                          "\n-P samples what the GPP is doing every millisecond, including time blocked"
+                          "\nin DSP/BIOS LINK, and prints the share of each phase at exit."
+                          "\n-i multiplies the matrices of files a and b instead of generated ones and"
+                          "\n-o writes the product to file c instead of printing it. Matrix files hold"
+                          "\na 16-byte header (magic \"HMAT\", rows, cols, bytes per element, 32-bit"
+                          "\neach) and the elements row-major: 16-bit operands of the given size, and"
+                          "\n32-bit products with -w, 64-bit ones otherwise."
+                          "\n-r csv prints the product as comma-separated values, -r none not at all."
+                          "\nFor DSP Processor Id,"
                           "\n\t use value of 0  if sample needs to be run on DSP 0 "
                           "\n\t use value of 1  if sample needs to be run on DSP 1"
                           "\n\t For single DSP configuration this is optional argument\n",
@@ -45,26 +186,34 @@ extern "C"
 
         else
         {
-            dspExecutable = argv[1];
-            strMatrixSize = argv[2];
+            if (mode != HELLODSP_ATTACH)
+            {
+                dspExecutable = argv[argi++];
+            }
+            if (mode != HELLODSP_DAEMON)
+            {
+                strMatrixSize = argv[argi++];
+            }
 
-            if (argc == 3)
+            if (argi == argc)
             {
                 strProcessorId = "0";
                 processorId = 0;
             }
             else
             {
-                strProcessorId = argv[3];
-                processorId = atoi(argv[3]);
+                strProcessorId = argv[argi];
+                processorId = atoi(argv[argi]);
             }
 
             if (processorId < MAX_PROCESSORS)
             {
-                if (atoi(strMatrixSize) == 0)
+                if ((mode != HELLODSP_DAEMON) && (atoi(strMatrixSize) == 0))
                     SYSTEM_0Print("Matrix size must be greater than 0\n");
                 else
-                    helloDSP_Main(dspExecutable, strMatrixSize, strProcessorId);
+                    helloDSP_Main(dspExecutable, strMatrixSize, strProcessorId,
+                                  strPipelineDepth, strBatchSize, strCutoff, flags,
+                                  inputA, inputB, output, mode);
             }
         }
 
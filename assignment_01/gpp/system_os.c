@@ -1,12 +1,19 @@
 /*  ----------------------------------- OS Specific Headers           */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdarg.h>
 #include <unistd.h>
 #include <time.h>
 #include <sys/types.h>
 #include <sys/time.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <pthread.h>
+#include <errno.h>
 
 /*  ----------------------------------- DSP/BIOS Link                 */
 #include <dsplink.h>
@@ -46,6 +53,29 @@ extern "C"
 
 #endif /* if defined (PROFILE) */
 
+    /** ============================================================================
+     *  @name   dumpRequested
+     *
+     *  @desc   Set by the SIGUSR1 handler, cleared by SYSTEM_DumpRequested ().
+     *  ============================================================================
+     */
+    STATIC volatile sig_atomic_t dumpRequested = 0;
+
+    /** ============================================================================
+     *  @name   sampler*
+     *
+     *  @desc   State of the sampling profiler started by SYSTEM_StartSampler ():
+     *          the timer raising SIGPROF, the thread waiting for it, and
+     *          the tag it samples into its counts.
+     *  ============================================================================
+     */
+    STATIC timer_t samplerTimer;
+    STATIC pthread_t samplerThread;
+    STATIC volatile Bool samplerRunning = FALSE;
+    STATIC volatile Uint32* samplerTag = NULL;
+    STATIC Uint32* samplerCounts = NULL;
+    STATIC Uint32 samplerNumTags = 0;
+
 
     /** ============================================================================
      *  @func   SYSTEM_0Print()
@@ -87,6 +117,39 @@ extern "C"
         printf(str, arg1, arg2);
     }
 
+    /** ============================================================================
+     *  @func   SYSTEM_Write()
+     *
+     *  @desc   Writes a buffer to the standard output in as few system calls
+     *          as it takes. Text printed before is flushed first so that the
+     *          output stays in order.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_Write(IN Char8* buffer, IN Uint32 size)
+    {
+        DSP_STATUS status = DSP_SOK;
+        ssize_t written;
+
+        fflush(stdout);
+        while (DSP_SUCCEEDED(status) && (size != 0))
+        {
+            written = write(STDOUT_FILENO, buffer, size);
+            if (written > 0)
+            {
+                buffer += written;
+                size -= (Uint32) written;
+            }
+            else if ((written < 0) && (errno != EINTR))
+            {
+                status = DSP_EFAIL;
+            }
+        }
+
+        return status;
+    }
+
     /** ============================================================================
      *  @func   SYSTEM_1Sprint()
      *
@@ -126,6 +189,509 @@ extern "C"
         usleep(uSec);
     }
 
+    /** ============================================================================
+     *  @func   SYSTEM_GetUsecTime()
+     *
+     *  @desc   Returns the current time in microseconds.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Uint32 SYSTEM_GetUsecTime(Void)
+    {
+        struct timeval currentTime;
+
+        gettimeofday(&currentTime, NULL);
+        return (Uint32) ((currentTime.tv_sec * 1000000) + currentTime.tv_usec);
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_GetProcessId()
+     *
+     *  @desc   Returns the id of the calling process.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Uint32 SYSTEM_GetProcessId(Void)
+    {
+        return (Uint32) getpid();
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_WaitForTermination()
+     *
+     *  @desc   Blocks SIGINT and SIGTERM and waits for one of them, so that
+     *          the caller can clean up instead of being killed. A signal
+     *          arriving between two waits stays pending for the next one.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Bool SYSTEM_WaitForTermination(Uint32 uSec)
+    {
+        sigset_t signals;
+        struct timespec timeout;
+        int signalNo;
+
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        sigprocmask(SIG_BLOCK, &signals, NULL);
+        if (uSec == 0)
+        {
+            sigwait(&signals, &signalNo);
+            return TRUE;
+        }
+
+        timeout.tv_sec = uSec / 1000000;
+        timeout.tv_nsec = (uSec % 1000000) * 1000;
+        return (sigtimedwait(&signals, NULL, &timeout) >= 0) ? TRUE : FALSE;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_DumpSignal()
+     *
+     *  @desc   SIGUSR1 handler: only raises dumpRequested, the dump itself
+     *          is done by the program at a point where it is safe.
+     *
+     *  @modif  dumpRequested
+     *  ============================================================================
+     */
+    STATIC Void SYSTEM_DumpSignal(int signalNo)
+    {
+        (Void) signalNo;
+        dumpRequested = 1;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_InstallDumpSignal()
+     *
+     *  @desc   Installs the SIGUSR1 handler. Interrupted system calls are
+     *          restarted, except for the timed waits that report signals.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_InstallDumpSignal(Void)
+    {
+        struct sigaction action;
+
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = SYSTEM_DumpSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGUSR1, &action, NULL);
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_DumpRequested()
+     *
+     *  @desc   Returns whether SIGUSR1 was received since the last call.
+     *
+     *  @modif  dumpRequested
+     *  ============================================================================
+     */
+    NORMAL_API Bool SYSTEM_DumpRequested(Void)
+    {
+        if (dumpRequested == 0)
+        {
+            return FALSE;
+        }
+        dumpRequested = 0;
+        return TRUE;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_SamplerIgnore()
+     *
+     *  @desc   SIGPROF handler for threads that do not block it. The samples
+     *          are taken by SYSTEM_SamplerMain (), which waits for the signal.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    STATIC Void SYSTEM_SamplerIgnore(int signalNo)
+    {
+        (Void) signalNo;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_SamplerMain()
+     *
+     *  @desc   Thread of the sampling profiler: counts the tag at each
+     *          SIGPROF of the timer, and once more for each expiry missed
+     *          meanwhile.
+     *
+     *  @modif  samplerCounts
+     *  ============================================================================
+     */
+    STATIC Void* SYSTEM_SamplerMain(Void* arg)
+    {
+        sigset_t signals;
+        Uint32 tag;
+        int overrun;
+
+        (Void) arg;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGPROF);
+        while (samplerRunning)
+        {
+            if ((sigwaitinfo(&signals, NULL) < 0) || !samplerRunning)
+            {
+                continue;
+            }
+            tag = *samplerTag;
+            overrun = timer_getoverrun(samplerTimer);
+            if (tag < samplerNumTags)
+            {
+                samplerCounts[tag] += 1 + ((overrun > 0) ? overrun : 0);
+            }
+        }
+
+        return NULL;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_StartSampler()
+     *
+     *  @desc   Samples *tag every uSec of the monotonic clock into counts.
+     *          A timer raises SIGPROF, which the calling thread blocks and
+     *          the sampler thread waits for, so the calls of the program
+     *          are never interrupted. Threads created earlier that do not
+     *          block it get a handler doing nothing. The sampler thread
+     *          blocks every other signal.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_StartSampler(IN Uint32 uSec, IN volatile Uint32* tag,
+                                              OUT Uint32* counts, IN Uint32 numTags)
+    {
+        DSP_STATUS status = DSP_SOK;
+        struct sigaction action;
+        struct sigevent event;
+        struct itimerspec period;
+        sigset_t signals;
+        sigset_t allSignals;
+        sigset_t callerSignals;
+
+        samplerTag = tag;
+        samplerCounts = counts;
+        samplerNumTags = numTags;
+        memset(counts, 0, numTags * sizeof(Uint32));
+
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = SYSTEM_SamplerIgnore;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, NULL);
+
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGPROF);
+        pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+        memset(&event, 0, sizeof(event));
+        event.sigev_notify = SIGEV_SIGNAL;
+        event.sigev_signo = SIGPROF;
+        if (timer_create(CLOCK_MONOTONIC, &event, &samplerTimer) != 0)
+        {
+            status = DSP_EFAIL;
+            SYSTEM_1Print("timer_create () failed. errno = [%d]\n", errno);
+        }
+
+        /* The sampler thread inherits a mask blocking every signal, so
+         * that SIGINT, SIGTERM and SIGUSR1 reach the program's own
+         * threads and SIGPROF is only taken by sigwaitinfo (). */
+        if (DSP_SUCCEEDED(status))
+        {
+            samplerRunning = TRUE;
+            sigfillset(&allSignals);
+            pthread_sigmask(SIG_SETMASK, &allSignals, &callerSignals);
+            if (pthread_create(&samplerThread, NULL, SYSTEM_SamplerMain, NULL) != 0)
+            {
+                samplerRunning = FALSE;
+                timer_delete(samplerTimer);
+                status = DSP_EFAIL;
+                SYSTEM_0Print("pthread_create () failed\n");
+            }
+            pthread_sigmask(SIG_SETMASK, &callerSignals, NULL);
+        }
+
+        if (DSP_SUCCEEDED(status))
+        {
+            period.it_interval.tv_sec = uSec / 1000000;
+            period.it_interval.tv_nsec = (uSec % 1000000) * 1000;
+            period.it_value = period.it_interval;
+            timer_settime(samplerTimer, 0, &period, NULL);
+        }
+
+        return status;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_StopSampler()
+     *
+     *  @desc   Stops the sampling profiler and waits for its thread, after
+     *          which the counts are final.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_StopSampler(Void)
+    {
+        if (samplerRunning)
+        {
+            timer_delete(samplerTimer);
+            samplerRunning = FALSE;
+            pthread_kill(samplerThread, SIGPROF);
+            pthread_join(samplerThread, NULL);
+        }
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_MapFile()
+     *
+     *  @desc   Maps a whole file read-only. The descriptor is not needed once
+     *          the mapping exists.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_MapFile(IN Char8* path, OUT Pvoid* addrPtr, OUT Uint32* sizePtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+        struct stat info;
+        void* addr = MAP_FAILED;
+        int fd;
+
+        fd = open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            status = DSP_ENOTFOUND;
+        }
+        else
+        {
+            if ((fstat(fd, &info) != 0) || (info.st_size == 0))
+            {
+                status = DSP_EFAIL;
+            }
+            else
+            {
+                addr = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    status = DSP_EMEMORY;
+                }
+            }
+            close(fd);
+        }
+
+        *addrPtr = DSP_SUCCEEDED(status) ? (Pvoid) addr : NULL;
+        *sizePtr = DSP_SUCCEEDED(status) ? (Uint32) info.st_size : 0;
+        return status;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_CreateMappedFile()
+     *
+     *  @desc   Creates or truncates a file of the given size and maps it for
+     *          writing.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_CreateMappedFile(IN Char8* path, IN Uint32 size, OUT Pvoid* addrPtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+        void* addr = MAP_FAILED;
+        int fd;
+
+        fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            status = DSP_EFAIL;
+        }
+        else
+        {
+            if (ftruncate(fd, (off_t) size) != 0)
+            {
+                status = DSP_EFAIL;
+            }
+            else
+            {
+                addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    status = DSP_EMEMORY;
+                }
+            }
+            close(fd);
+        }
+
+        *addrPtr = DSP_SUCCEEDED(status) ? (Pvoid) addr : NULL;
+        return status;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_UnmapFile()
+     *
+     *  @desc   Unmaps a file mapped by SYSTEM_MapFile () or
+     *          SYSTEM_CreateMappedFile (). Writes reach the file by then.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_UnmapFile(IN Pvoid addr, IN Uint32 size)
+    {
+        if (addr != NULL)
+        {
+            munmap(addr, size);
+        }
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_AllocAligned()
+     *
+     *  @desc   Allocates a block aligned to the given power of two.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_AllocAligned(IN Uint32 size, IN Uint32 align, OUT Pvoid* addrPtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+        Pvoid addr = NULL;
+
+        if (posix_memalign(&addr, align, size) != 0)
+        {
+            addr = NULL;
+            status = DSP_EMEMORY;
+        }
+
+        *addrPtr = addr;
+        return status;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_Free()
+     *
+     *  @desc   Frees a block allocated by SYSTEM_AllocAligned ().
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_Free(IN Pvoid addr)
+    {
+        free(addr);
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_CreateSem()
+     *
+     *  @desc   Creates a counting semaphore with an initial count of zero.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_CreateSem(OUT Pvoid* semPtr)
+    {
+        DSP_STATUS status = DSP_SOK;
+        sem_t* sem;
+
+        sem = (sem_t*) malloc(sizeof(sem_t));
+        if (sem == NULL)
+        {
+            status = DSP_EMEMORY;
+        }
+        else if (sem_init(sem, 0, 0) != 0)
+        {
+            free(sem);
+            sem = NULL;
+            status = DSP_EFAIL;
+        }
+
+        *semPtr = (Pvoid) sem;
+        return status;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_DeleteSem()
+     *
+     *  @desc   Deletes a semaphore created by SYSTEM_CreateSem ().
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_DeleteSem(IN Pvoid semHandle)
+    {
+        if (semHandle != NULL)
+        {
+            sem_destroy((sem_t*) semHandle);
+            free(semHandle);
+        }
+        return DSP_SOK;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_PostSem()
+     *
+     *  @desc   Posts a semaphore.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_PostSem(IN Pvoid semHandle)
+    {
+        return (sem_post((sem_t*) semHandle) == 0) ? DSP_SOK : DSP_EFAIL;
+    }
+
+    /** ============================================================================
+     *  @func   SYSTEM_WaitSem()
+     *
+     *  @desc   Waits on a semaphore for at most uSec microseconds.
+     *
+     *  @modif  None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_WaitSem(IN Pvoid semHandle, IN Uint32 uSec)
+    {
+        DSP_STATUS status = DSP_SOK;
+        struct timespec deadline;
+        int osStatus;
+
+        if (uSec == WAIT_FOREVER)
+        {
+            do
+            {
+                osStatus = sem_wait((sem_t*) semHandle);
+            } while ((osStatus != 0) && (errno == EINTR));
+        }
+        else
+        {
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += uSec / 1000000;
+            deadline.tv_nsec += (uSec % 1000000) * 1000;
+            if (deadline.tv_nsec >= 1000000000)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000;
+            }
+
+            do
+            {
+                osStatus = sem_timedwait((sem_t*) semHandle, &deadline);
+            } while ((osStatus != 0) && (errno == EINTR));
+        }
+
+        if (osStatus != 0)
+        {
+            status = (errno == ETIMEDOUT) ? DSP_ETIMEOUT : DSP_EFAIL;
+        }
+
+        return status;
+    }
+
     /** ============================================================================
      *  @func   SYSTEM_Atoi
      *
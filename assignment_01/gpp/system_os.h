@@ -154,6 +154,32 @@ extern "C"
     NORMAL_API Void SYSTEM_2Print(Char8* str, Uint32 arg1, Uint32 arg2);
 
 
+    /** ============================================================================
+     *  @func   SYSTEM_Write
+     *
+     *  @desc   Writes a buffer to the standard output, after any text printed
+     *          so far.
+     *
+     *  @arg    buffer
+     *              Bytes to write.
+     *  @arg    size
+     *              Number of bytes.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              The write failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    None
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_Write(IN Char8* buffer, IN Uint32 size);
+
+
     /** ============================================================================
      *  @func   SYSTEM_1Sprint
      *
@@ -220,6 +246,387 @@ extern "C"
     NORMAL_API Void SYSTEM_Sleep(Uint32 uSec);
 
 
+    /** ============================================================================
+     *  @func   SYSTEM_GetUsecTime
+     *
+     *  @desc   Returns the current time in microseconds. Only differences
+     *          between two values are meaningful.
+     *
+     *  @arg    None.
+     *
+     *  @ret    Current time in microseconds.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    None
+     *  ============================================================================
+     */
+    NORMAL_API Uint32 SYSTEM_GetUsecTime(Void);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_GetProcessId
+     *
+     *  @desc   Returns the id of the calling process.
+     *
+     *  @arg    None.
+     *
+     *  @ret    Process id.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    None
+     *  ============================================================================
+     */
+    NORMAL_API Uint32 SYSTEM_GetProcessId(Void);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_WaitForTermination
+     *
+     *  @desc   Blocks until the process receives SIGINT or SIGTERM, or
+     *          until the timeout expires.
+     *
+     *  @arg    uSec
+     *              Microseconds to wait at most, 0 to wait for the signal.
+     *
+     *  @ret    TRUE when the process was asked to terminate, FALSE when
+     *          the timeout expired first.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    None
+     *  ============================================================================
+     */
+    NORMAL_API Bool SYSTEM_WaitForTermination(Uint32 uSec);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_InstallDumpSignal
+     *
+     *  @desc   Installs a SIGUSR1 handler that records a request for a dump
+     *          of the metrics, see SYSTEM_DumpRequested ().
+     *
+     *  @arg    None.
+     *
+     *  @ret    None.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_DumpRequested
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_InstallDumpSignal(Void);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_DumpRequested
+     *
+     *  @desc   Returns whether a dump was requested with SIGUSR1 since the
+     *          last call, and clears the request.
+     *
+     *  @arg    None.
+     *
+     *  @ret    TRUE when a dump was requested.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_InstallDumpSignal
+     *  ============================================================================
+     */
+    NORMAL_API Bool SYSTEM_DumpRequested(Void);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_StartSampler
+     *
+     *  @desc   Starts a sampling profiler that reads *tag every uSec of the
+     *          monotonic clock, blocked time included, and counts each
+     *          value below numTags in counts. The samples are taken by a
+     *          thread of their own on SIGPROF of a POSIX timer; SIGPROF is
+     *          blocked in the calling thread.
+     *
+     *  @arg    uSec
+     *              Sampling period in microseconds.
+     *  @arg    tag
+     *              Tag set by the program, sampled.
+     *  @arg    counts
+     *              Samples of each tag, zeroed here.
+     *  @arg    numTags
+     *              Number of counts.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              The timer or the thread could not be created.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_StopSampler
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_StartSampler(IN Uint32 uSec, IN volatile Uint32* tag,
+                                              OUT Uint32* counts, IN Uint32 numTags);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_StopSampler
+     *
+     *  @desc   Stops the profiler started by SYSTEM_StartSampler (). The
+     *          counts are final on return.
+     *
+     *  @arg    None.
+     *
+     *  @ret    None.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_StartSampler
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_StopSampler(Void);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_MapFile
+     *
+     *  @desc   Maps a whole file for reading.
+     *
+     *  @arg    path
+     *              Path of the file.
+     *  @arg    addrPtr
+     *              Location to receive the address of the mapping.
+     *  @arg    sizePtr
+     *              Location to receive the size of the file.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_ENOTFOUND
+     *              The file could not be opened.
+     *          DSP_EMEMORY
+     *              The file could not be mapped.
+     *          DSP_EFAIL
+     *              The file is empty or its size is unknown.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_UnmapFile
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_MapFile(IN Char8* path, OUT Pvoid* addrPtr, OUT Uint32* sizePtr);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_CreateMappedFile
+     *
+     *  @desc   Creates a file of the given size, replacing any existing one,
+     *          and maps it for writing.
+     *
+     *  @arg    path
+     *              Path of the file.
+     *  @arg    size
+     *              Size of the file in bytes.
+     *  @arg    addrPtr
+     *              Location to receive the address of the mapping.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EMEMORY
+     *              The file could not be mapped.
+     *          DSP_EFAIL
+     *              The file could not be created or sized.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_UnmapFile
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_CreateMappedFile(IN Char8* path, IN Uint32 size, OUT Pvoid* addrPtr);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_UnmapFile
+     *
+     *  @desc   Unmaps a mapped file.
+     *
+     *  @arg    addr
+     *              Address of the mapping, NULL for none.
+     *  @arg    size
+     *              Size of the mapping.
+     *
+     *  @ret    None
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_MapFile, SYSTEM_CreateMappedFile
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_UnmapFile(IN Pvoid addr, IN Uint32 size);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_AllocAligned
+     *
+     *  @desc   Allocates a block aligned to the given power of two.
+     *
+     *  @arg    size
+     *              Size of the block in bytes.
+     *  @arg    align
+     *              Alignment of the block, a power of two multiple of the
+     *              pointer size.
+     *  @arg    addrPtr
+     *              Location to receive the address of the block.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EMEMORY
+     *              The block could not be allocated.
+     *
+     *  @enter  addrPtr must be a valid pointer.
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_Free
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_AllocAligned(IN Uint32 size, IN Uint32 align, OUT Pvoid* addrPtr);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_Free
+     *
+     *  @desc   Frees a block allocated by SYSTEM_AllocAligned ().
+     *
+     *  @arg    addr
+     *              Address of the block, NULL for none.
+     *
+     *  @ret    None
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_AllocAligned
+     *  ============================================================================
+     */
+    NORMAL_API Void SYSTEM_Free(IN Pvoid addr);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_CreateSem
+     *
+     *  @desc   Creates a counting semaphore with an initial count of zero.
+     *
+     *  @arg    semPtr
+     *              Location to receive the semaphore handle.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EMEMORY
+     *              The semaphore could not be allocated.
+     *
+     *  @enter  semPtr must be a valid pointer.
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_DeleteSem
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_CreateSem(OUT Pvoid* semPtr);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_DeleteSem
+     *
+     *  @desc   Deletes a semaphore created by SYSTEM_CreateSem ().
+     *
+     *  @arg    semHandle
+     *              Handle of the semaphore.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_CreateSem
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_DeleteSem(IN Pvoid semHandle);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_PostSem
+     *
+     *  @desc   Posts a semaphore. Safe to call from a DSP/BIOS LINK callback.
+     *
+     *  @arg    semHandle
+     *              Handle of the semaphore.
+     *
+     *  @ret    DSP_SOK
+     *              Operation successfully completed.
+     *          DSP_EFAIL
+     *              The semaphore could not be posted.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_WaitSem
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_PostSem(IN Pvoid semHandle);
+
+
+    /** ============================================================================
+     *  @func   SYSTEM_WaitSem
+     *
+     *  @desc   Waits on a semaphore for at most the given number of
+     *          microseconds.
+     *
+     *  @arg    semHandle
+     *              Handle of the semaphore.
+     *  @arg    uSec
+     *              Timeout in microseconds, WAIT_FOREVER to block.
+     *
+     *  @ret    DSP_SOK
+     *              The semaphore was posted.
+     *          DSP_ETIMEOUT
+     *              The timeout expired first.
+     *          DSP_EFAIL
+     *              The wait failed.
+     *
+     *  @enter  None
+     *
+     *  @leave  None
+     *
+     *  @see    SYSTEM_PostSem
+     *  ============================================================================
+     */
+    NORMAL_API DSP_STATUS SYSTEM_WaitSem(IN Pvoid semHandle, IN Uint32 uSec);
+
+
 #if defined (PROFILE)
     /** ============================================================================
      *  @func   SYSTEM_GetStartTime ()